@@ -0,0 +1,176 @@
+#include <benchmark/benchmark.h>
+#include "counters.hpp"
+#include "excerpt/ast.hpp"
+
+#include <memory>
+#include <vector>
+
+using namespace excerpt;
+using namespace excerpt::bench;
+
+namespace {
+  // The node-per-heap-object design the index-based Ast replaces, in the
+  // style of `Tokenizer::next()`
+  struct HeapNode {
+    NodeKind kind;
+    TokenType op;
+    uint32_t token;
+    std::vector<std::shared_ptr<HeapNode>> children;
+  };
+
+  std::shared_ptr<HeapNode> heap_node(
+      NodeKind kind, TokenType op, uint32_t token,
+      std::vector<std::shared_ptr<HeapNode>> children = {}) {
+    return std::make_shared<HeapNode>(
+        HeapNode{kind, op, token, std::move(children)});
+  }
+
+  // Builds a block of `x = a + b * c;` statements, 8 nodes each
+  NodeId build_ast(Ast& ast, size_t statements) {
+    std::vector<NodeId> body;
+    body.reserve(statements);
+
+    for (uint32_t i = 0; i < statements; i++) {
+      uint32_t token = i * 8;
+
+      NodeId b = ast.add(NodeKind::NAME, TokenType::INVALID, token + 4);
+      NodeId c = ast.add(NodeKind::NAME, TokenType::INVALID, token + 6);
+      NodeId product = ast.add(NodeKind::BINARY, TokenType::STAR, token + 5,
+                               b, c);
+      NodeId a = ast.add(NodeKind::NAME, TokenType::INVALID, token + 2);
+      NodeId sum =
+          ast.add(NodeKind::BINARY, TokenType::PLUS, token + 3, a, product);
+      NodeId x = ast.add(NodeKind::NAME, TokenType::INVALID, token);
+      NodeId assign =
+          ast.add(NodeKind::ASSIGN, TokenType::INVALID, token + 1, x, sum);
+
+      body.push_back(
+          ast.add(NodeKind::EXPRESSION, TokenType::INVALID, token, assign));
+    }
+
+    return ast.add(NodeKind::BLOCK, TokenType::INVALID, 0,
+                   ast.add_list(body));
+  }
+
+  std::shared_ptr<HeapNode> build_heap(size_t statements) {
+    std::vector<std::shared_ptr<HeapNode>> body;
+
+    for (uint32_t i = 0; i < statements; i++) {
+      uint32_t token = i * 8;
+
+      auto b = heap_node(NodeKind::NAME, TokenType::INVALID, token + 4);
+      auto c = heap_node(NodeKind::NAME, TokenType::INVALID, token + 6);
+      auto product =
+          heap_node(NodeKind::BINARY, TokenType::STAR, token + 5, {b, c});
+      auto a = heap_node(NodeKind::NAME, TokenType::INVALID, token + 2);
+      auto sum =
+          heap_node(NodeKind::BINARY, TokenType::PLUS, token + 3, {a, product});
+      auto x = heap_node(NodeKind::NAME, TokenType::INVALID, token);
+      auto assign =
+          heap_node(NodeKind::ASSIGN, TokenType::INVALID, token + 1, {x, sum});
+
+      body.push_back(
+          heap_node(NodeKind::EXPRESSION, TokenType::INVALID, token, {assign}));
+    }
+
+    return heap_node(NodeKind::BLOCK, TokenType::INVALID, 0, std::move(body));
+  }
+
+  // Sums the tokens of every node, visiting children in order
+  uint64_t visit(const Ast& ast, NodeId id) {
+    if (id == NO_NODE) {
+      return 0;
+    }
+
+    const Node& node = ast.node(id);
+
+    switch (node.kind) {
+      case NodeKind::BLOCK: {
+        uint64_t sum = node.token;
+        for (NodeId child : ast.list(node.lhs)) {
+          sum += visit(ast, child);
+        }
+        return sum;
+      }
+
+      default:
+        return node.token + visit(ast, node.lhs) + visit(ast, node.rhs);
+    }
+  }
+
+  uint64_t visit(const HeapNode& node) {
+    uint64_t sum = node.token;
+    for (const auto& child : node.children) {
+      sum += visit(*child);
+    }
+    return sum;
+  }
+
+  // Reports nodes/s, bytes/node and allocs/node for building trees
+  void report_build(benchmark::State& state, size_t nodes, size_t allocations,
+                    size_t bytes) {
+    double built = static_cast<double>(nodes) * state.iterations();
+
+    state.counters["nodes/s"] =
+        benchmark::Counter(built, benchmark::Counter::kIsRate);
+    state.counters["allocs/node"] = allocations / built;
+    state.counters["bytes/node"] = bytes / built;
+  }
+
+  constexpr size_t STATEMENTS = 1 << 17;
+  constexpr size_t NODES = STATEMENTS * 8 + 1;
+}  // namespace
+
+static void BM_BuildAst(benchmark::State& state) {
+  size_t allocations = allocation_count();
+  size_t bytes = 0;
+
+  for (auto _ : state) {
+    Ast ast;
+    benchmark::DoNotOptimize(build_ast(ast, STATEMENTS));
+    bytes += ast.capacity_bytes();
+  }
+
+  report_build(state, NODES, allocation_count() - allocations, bytes);
+}
+BENCHMARK(BM_BuildAst);
+
+static void BM_BuildHeapAst(benchmark::State& state) {
+  size_t allocations = allocation_count();
+  size_t bytes = allocation_bytes();
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(build_heap(STATEMENTS));
+  }
+
+  report_build(state, NODES, allocation_count() - allocations,
+               allocation_bytes() - bytes);
+}
+BENCHMARK(BM_BuildHeapAst);
+
+static void BM_TraverseAst(benchmark::State& state) {
+  Ast ast;
+  NodeId root = build_ast(ast, STATEMENTS);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(visit(ast, root));
+  }
+
+  state.counters["nodes/s"] = benchmark::Counter(
+      static_cast<double>(NODES) * state.iterations(),
+      benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_TraverseAst);
+
+static void BM_TraverseHeapAst(benchmark::State& state) {
+  auto root = build_heap(STATEMENTS);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(visit(*root));
+  }
+
+  state.counters["nodes/s"] = benchmark::Counter(
+      static_cast<double>(NODES) * state.iterations(),
+      benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_TraverseHeapAst);
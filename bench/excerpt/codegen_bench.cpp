@@ -0,0 +1,151 @@
+#include <benchmark/benchmark.h>
+#include "corpus.hpp"
+#include "excerpt/backend.hpp"
+#include "excerpt/codegen.hpp"
+#include "excerpt/parser.hpp"
+
+#include "llvm/Target/TargetMachine.h"
+
+#include <cstdio>
+
+using namespace excerpt;
+using namespace excerpt::bench;
+
+namespace {
+  // Generates the module of a program, parsed once per call
+  std::unique_ptr<llvm::Module> generate(llvm::LLVMContext& context,
+                                         const std::string& source) {
+    Parser parser(source);
+    NodeId program = parser.parse();
+    CodeGenerator generator(context, source, parser.tokens(), parser.ast(),
+                            "bench.ex");
+    return generator.generate(program);
+  }
+
+  // The number of instructions in a module, a rough measure of its size
+  size_t instruction_count(const llvm::Module& module) {
+    size_t count = 0;
+    for (const llvm::Function& function : module) {
+      count += function.getInstructionCount();
+    }
+    return count;
+  }
+
+  const OptLevel levels[] = {OptLevel::O0, OptLevel::O1, OptLevel::O2,
+                             OptLevel::O3, OptLevel::Os};
+  const char* level_names[] = {"-O0", "-O1", "-O2", "-O3", "-Os"};
+}  // namespace
+
+static void BM_Generate(benchmark::State& state) {
+  auto source = typed_program_source(state.range(0));
+  Parser parser(*source);
+  NodeId program = parser.parse();
+
+  {
+    llvm::LLVMContext context;
+    if (!generate(context, *source)) {
+      state.SkipWithError("the corpus does not compile");
+      return;
+    }
+  }
+
+  for (auto _ : state) {
+    llvm::LLVMContext context;
+    CodeGenerator generator(context, *source, parser.tokens(), parser.ast(),
+                            "bench.ex");
+    benchmark::DoNotOptimize(generator.generate(program));
+  }
+
+  state.SetBytesProcessed(state.iterations() * source->size());
+}
+BENCHMARK(BM_Generate)->Arg(1000)->Arg(10000);
+
+static void BM_CompileConstants(benchmark::State& state) {
+  auto source = constant_source(state.range(0));
+
+  {
+    llvm::LLVMContext context;
+    if (!generate(context, *source)) {
+      state.SkipWithError("the corpus does not compile");
+      return;
+    }
+  }
+
+  // Literals are decoded once, while lexing, and read by the generator
+  for (auto _ : state) {
+    llvm::LLVMContext context;
+    benchmark::DoNotOptimize(generate(context, *source));
+  }
+
+  state.SetBytesProcessed(state.iterations() * source->size());
+}
+BENCHMARK(BM_CompileConstants)->Arg(64 * 1024);
+
+// Names are resolved by symbol, so declaring and finding each global
+// should not grow with the number of them
+static void BM_GenerateGlobals(benchmark::State& state) {
+  auto source = global_table_source(state.range(0));
+  Parser parser(*source);
+  NodeId program = parser.parse();
+
+  for (auto _ : state) {
+    llvm::LLVMContext context;
+    CodeGenerator generator(context, *source, parser.tokens(), parser.ast(),
+                            "bench.ex");
+    benchmark::DoNotOptimize(generator.generate(program));
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GenerateGlobals)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(30000)
+    ->Unit(benchmark::kMillisecond);
+
+// Optimizes a fresh module per iteration; the instruction count left shows
+// what each level buys for its compile time
+static void BM_Optimize(benchmark::State& state) {
+  auto source = typed_program_source(2000);
+  OptLevel level = levels[state.range(0)];
+  auto machine = create_target_machine(level);
+  size_t instructions = 0;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    llvm::LLVMContext context;
+    auto module = generate(context, *source);
+    state.ResumeTiming();
+
+    optimize(*module, *machine, level);
+    instructions = instruction_count(*module);
+  }
+
+  state.SetLabel(level_names[state.range(0)]);
+  state.SetBytesProcessed(state.iterations() * source->size());
+  state.counters["instructions"] = instructions;
+}
+BENCHMARK(BM_Optimize)->DenseRange(0, 4)->Unit(benchmark::kMillisecond);
+
+// Optimizes and emits an object, as the driver does for each file
+static void BM_OptimizeAndEmit(benchmark::State& state) {
+  auto source = typed_program_source(2000);
+  OptLevel level = levels[state.range(0)];
+  auto machine = create_target_machine(level);
+  std::string path = "/tmp/excerpt_codegen_bench.o";
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    llvm::LLVMContext context;
+    auto module = generate(context, *source);
+    state.ResumeTiming();
+
+    optimize(*module, *machine, level);
+    benchmark::DoNotOptimize(emit_object(*module, *machine, path));
+  }
+
+  std::remove(path.c_str());
+  state.SetLabel(level_names[state.range(0)]);
+  state.SetBytesProcessed(state.iterations() * source->size());
+}
+BENCHMARK(BM_OptimizeAndEmit)->DenseRange(0, 4)->Unit(benchmark::kMillisecond);
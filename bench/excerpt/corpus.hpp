@@ -0,0 +1,374 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Deterministic synthetic source generators for the benchmarks.
+ *
+ * Every generator is seeded identically, so a corpus of a given size is the
+ * same from one run (and one build) to the next.
+ */
+namespace excerpt::bench {
+  // Generates roughly `size` bytes of mixed source code.
+  inline std::shared_ptr<std::string> mixed_source(size_t size) {
+    static const char* snippets[] = {
+        "int count = 0;\n",
+        "float ratio = 3.14159;\n",
+        "while (count < limit) {\n  count = count + 1;\n}\n",
+        "if (value >= 42) { return true; } else { return false; }\n",
+        "// a line comment describing the next statement\n",
+        "/* a block\n   comment */\n",
+        "message = \"hello, world\";\n",
+        "for (i = 0; i != 10; i = i + 1) { total = total * i % 7; }\n"};
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> pick(0, std::size(snippets) - 1);
+
+    auto source = std::make_shared<std::string>();
+    source->reserve(size + 128);
+
+    while (source->size() < size) {
+      source->append(snippets[pick(rng)]);
+    }
+
+    return source;
+  }
+
+  // Generates roughly `size` bytes of identifiers, one in five a keyword.
+  inline std::shared_ptr<std::string> identifier_source(size_t size) {
+    static const char* keywords[] = {"if",    "else",  "while", "for",
+                                     "break", "continue", "return", "true",
+                                     "false", "int",   "float", "char",
+                                     "bool"};
+    static const char alphabet[] =
+        "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789";
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> keyword(0, std::size(keywords) - 1);
+    std::uniform_int_distribution<size_t> letter(0, 52);
+    std::uniform_int_distribution<size_t> character(0, 62);
+    std::uniform_int_distribution<size_t> length(1, 12);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    auto source = std::make_shared<std::string>();
+    source->reserve(size + 16);
+
+    while (source->size() < size) {
+      if (percent(rng) < 20) {
+        source->append(keywords[keyword(rng)]);
+      } else {
+        source->push_back(alphabet[letter(rng)]);
+        for (size_t n = length(rng); n > 1; n--) {
+          source->push_back(alphabet[character(rng)]);
+        }
+      }
+
+      source->push_back(percent(rng) < 10 ? '\n' : ' ');
+    }
+
+    return source;
+  }
+
+  // Generates roughly `size` bytes of literals, a percentage of them strings
+  // and the rest integer and floating point numbers.
+  inline std::shared_ptr<std::string> literal_source(size_t size,
+                                                     int string_percent) {
+    static const char* words[] = {"hello", "world", "excerpt", "value",
+                                  "a longer sentence", "x", "", "42"};
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> word(0, std::size(words) - 1);
+    std::uniform_int_distribution<uint64_t> number(0, 1000000);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    auto source = std::make_shared<std::string>();
+    source->reserve(size + 32);
+
+    while (source->size() < size) {
+      if (percent(rng) < string_percent) {
+        source->push_back('"');
+        source->append(words[word(rng)]);
+        source->push_back('"');
+      } else {
+        source->append(std::to_string(number(rng)));
+        if (percent(rng) < 40) {
+          source->push_back('.');
+          source->append(std::to_string(number(rng)));
+        }
+      }
+
+      source->push_back(percent(rng) < 10 ? '\n' : ' ');
+    }
+
+    return source;
+  }
+
+  // Generates roughly `size` bytes of literals, nearly a third strings.
+  inline std::shared_ptr<std::string> literal_source(size_t size) {
+    return literal_source(size, 30);
+  }
+
+  // Generates roughly `size` bytes of integer and floating point numbers.
+  inline std::shared_ptr<std::string> number_source(size_t size) {
+    return literal_source(size, 0);
+  }
+
+  // Generates roughly `size` bytes of string literals.
+  inline std::shared_ptr<std::string> string_source(size_t size) {
+    return literal_source(size, 100);
+  }
+
+  // Generates roughly `size` bytes of string literals, as in an embedded
+  // data table, a fifth of them with escapes.
+  inline std::shared_ptr<std::string> escaped_string_source(size_t size) {
+    static const char* plain[] = {"hello", "world", "a longer sentence",
+                                  "excerpt", "x", ""};
+    static const char* escaped[] = {"line\\n", "\\\"quoted\\\"",
+                                    "tab\\tseparated", "\\x41\\x42",
+                                    "caf\\u{e9}", "back\\\\slash"};
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> word(0, std::size(plain) - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    auto source = std::make_shared<std::string>();
+    source->reserve(size + 32);
+
+    while (source->size() < size) {
+      source->push_back('"');
+      source->append(percent(rng) < 20 ? escaped[word(rng)] : plain[word(rng)]);
+      source->push_back('"');
+      source->push_back(percent(rng) < 10 ? '\n' : ' ');
+    }
+
+    return source;
+  }
+
+  // Generates roughly `size` bytes of a table of global constants, as in
+  // generated lookup tables, spelled in every notation a literal has.
+  inline std::shared_ptr<std::string> constant_source(size_t size) {
+    static const char* prefixes[] = {"", "0x", "0b", "0"};
+    static const int bases[] = {10, 16, 2, 8};
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> notation(0, std::size(bases) - 1);
+    std::uniform_int_distribution<uint32_t> number(0, 1u << 30);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    auto source = std::make_shared<std::string>();
+    source->reserve(size + 64);
+
+    for (size_t n = 0; source->size() < size; n++) {
+      std::string name = std::to_string(n);
+
+      if (percent(rng) < 30) {
+        // Doubles, a fraction and an exponent
+        source->append("float r" + name + " = " +
+                       std::to_string(number(rng) % 1000) + "." +
+                       std::to_string(number(rng)) + "e-" +
+                       std::to_string(number(rng) % 20) + ";\n");
+        continue;
+      }
+
+      size_t pick = notation(rng);
+      uint32_t value = number(rng);
+      std::string digits;
+
+      do {
+        digits.insert(digits.begin(), "0123456789abcdef"[value % bases[pick]]);
+        value /= bases[pick];
+      } while (value != 0);
+
+      // Long decimals are grouped by separators
+      if (pick == 0 && digits.size() > 6) {
+        digits.insert(digits.size() - 3, "_");
+      }
+
+      source->append("int k" + name + " = " + prefixes[pick] + digits +
+                     ";\n");
+    }
+
+    return source;
+  }
+
+  // Generates a table of `count` global variables, then a function that
+  // reads every one of them, so that each name is declared and looked up
+  // among all the others.
+  inline std::shared_ptr<std::string> global_table_source(size_t count) {
+    auto source = std::make_shared<std::string>();
+
+    for (size_t n = 0; n < count; n++) {
+      source->append("int g" + std::to_string(n) + " = " + std::to_string(n) +
+                     ";\n");
+    }
+
+    source->append("int main() {\n  int total = 0;\n");
+    for (size_t n = 0; n < count; n++) {
+      source->append("  total = total + g" + std::to_string(n) + ";\n");
+    }
+    source->append("  return total;\n}\n");
+
+    return source;
+  }
+
+  // Generates roughly `size` bytes of whitespace and comments, each gap
+  // followed by a single semicolon.
+  inline std::shared_ptr<std::string> gap_source(size_t size) {
+    static const char* gaps[] = {" ", "\n    ", "\t\t",
+                                 "  // a short line comment\n",
+                                 " /* an inline comment */ ",
+                                 "\n/*\n * A block comment\n */\n"};
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> pick(0, std::size(gaps) - 1);
+
+    auto source = std::make_shared<std::string>();
+    source->reserve(size + 64);
+
+    while (source->size() < size) {
+      source->append(gaps[pick(rng)]);
+      source->push_back(';');
+    }
+
+    return source;
+  }
+
+  // Generates roughly `size` bytes of densely packed operators and punctuation.
+  inline std::shared_ptr<std::string> operator_source(size_t size) {
+    static const char* operators[] = {"+",  "-",  "*",  "/", "%", "(",
+                                      ")",  "{",  "}",  "[", "]", ";",
+                                      ":",  ",",  ".",  "=", "==", "!=",
+                                      "<",  "<=", ">",  ">="};
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> pick(0, std::size(operators) - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    auto source = std::make_shared<std::string>();
+    source->reserve(size + 16);
+
+    while (source->size() < size) {
+      const char* op = operators[pick(rng)];
+      source->append(op);
+
+      // Separate operators that could otherwise merge, i.e "<" "=", and
+      // always follow a slash so it cannot begin a comment
+      if (percent(rng) < 50 || op[0] == '/') source->push_back(' ');
+    }
+
+    return source;
+  }
+
+  // Generates roughly `size` bytes of indented code buried in comments.
+  inline std::shared_ptr<std::string> comment_source(size_t size) {
+    static const char* snippets[] = {
+        "        // a line comment explaining what the next few lines do\n",
+        "    /*\n     * A block comment spanning a few lines, as found in\n"
+        "     * documentation headers of generated code.\n     */\n",
+        "            total = total + 1;\n"};
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> pick(0, std::size(snippets) - 1);
+
+    auto source = std::make_shared<std::string>();
+    source->reserve(size + 256);
+
+    while (source->size() < size) {
+      source->append(snippets[pick(rng)]);
+    }
+
+    return source;
+  }
+
+  // Generates a program of roughly `lines` lines that parses, made of
+  // functions of random statements.
+  inline std::shared_ptr<std::string> program_source(size_t lines) {
+    static const char* statements[] = {
+        "  int x = a + b * 2;\n",
+        "  float ratio = 3.14159 / (a - b);\n",
+        "  if (a < 10) { a = a + 1; } else { b = b - 1; }\n",
+        "  while (a > 0) {\n    a = a - step(a, 1);\n  }\n",
+        "  for (int i = 0; i < 10; i = i + 1) { print(i); }\n",
+        "  // a line comment describing the next statement\n",
+        "  total = total + a * (b - 1) % 7;\n",
+        "  message(\"hello, world\");\n"};
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> pick(0, std::size(statements) - 1);
+    std::uniform_int_distribution<int> length(10, 60);
+
+    auto source = std::make_shared<std::string>();
+    size_t line = 0;
+
+    for (int function = 0; line < lines; function++) {
+      source->append("int f" + std::to_string(function) +
+                     "(int a, int b) {\n");
+
+      for (int n = length(rng); n > 0; n--) {
+        const char* statement = statements[pick(rng)];
+        source->append(statement);
+
+        std::string_view text(statement);
+        line += std::count(text.begin(), text.end(), '\n');
+      }
+
+      source->append("  return a;\n}\n");
+      line += 3;
+    }
+
+    return source;
+  }
+
+  // Generates a program of roughly `lines` lines that compiles and whose
+  // functions terminate, made of functions of random statements calling
+  // the functions before them.
+  inline std::shared_ptr<std::string> typed_program_source(size_t lines) {
+    static const char* statements[] = {
+        "  {\n    int x = a + b * 2;\n    total = total + x;\n  }\n",
+        "  {\n    float ratio = 3.14159 / (a - b + 0.5);\n"
+        "    b = ratio;\n  }\n",
+        "  if (a < 10) { a = a + 1; } else { b = b - 1; }\n",
+        "  while (a > 0) {\n    a = a - 1 - b % 3 * (b % 3);\n  }\n",
+        "  for (int i = 0; i < 10; i = i + 1) { total = total + i * a; }\n",
+        "  // a line comment describing the next statement\n",
+        "  total = total + a * (b - 1) % 7;\n",
+        "  {\n    char c = total;\n    bool odd = c % 2 == 1;\n  }\n"};
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> pick(0, std::size(statements) - 1);
+    std::uniform_int_distribution<int> length(10, 60);
+
+    auto source = std::make_shared<std::string>();
+    size_t line = 0;
+
+    for (int function = 0; line < lines; function++) {
+      source->append("int f" + std::to_string(function) +
+                     "(int a, int b) {\n  int total = 0;\n");
+
+      for (int n = length(rng); n > 0; n--) {
+        const char* statement = statements[pick(rng)];
+        source->append(statement);
+
+        std::string_view text(statement);
+        line += std::count(text.begin(), text.end(), '\n');
+      }
+
+      if (function > 0) {
+        source->append("  total = total + f" + std::to_string(function - 1) +
+                       "(b, total);\n");
+        line++;
+      }
+
+      source->append("  return total;\n}\n");
+      line += 4;
+    }
+
+    return source;
+  }
+}  // namespace excerpt::bench
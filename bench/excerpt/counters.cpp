@@ -0,0 +1,27 @@
+#include "counters.hpp"
+#include "excerpt/memory.hpp"
+
+namespace {
+  // The library's allocator counts when tracking, so track for the whole run
+  const bool tracking = (excerpt::memory::start(), true);
+}  // namespace
+
+namespace excerpt::bench {
+  size_t allocation_count() {
+    size_t count = 0;
+    for (const memory::Usage& usage : memory::subsystems()) {
+      count += usage.allocations;
+    }
+
+    return count;
+  }
+
+  size_t allocation_bytes() {
+    size_t bytes = 0;
+    for (const memory::Usage& usage : memory::subsystems()) {
+      bytes += usage.bytes;
+    }
+
+    return bytes;
+  }
+}  // namespace excerpt::bench
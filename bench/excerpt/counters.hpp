@@ -0,0 +1,71 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+namespace excerpt::bench {
+
+  /**
+   * @brief Get the number of global `operator new` calls made so far.
+   *
+   * The benchmark executable tracks allocations with memory::start() for
+   * the whole run, so allocations made by the code under test can be
+   * reported.
+   *
+   * @return The number of allocations since tracking last started.
+   */
+  size_t allocation_count();
+
+  /**
+   * @brief Get the number of bytes allocated by `operator new` so far.
+   * @return The bytes allocated since tracking last started, freed or not.
+   */
+  size_t allocation_bytes();
+
+  /**
+   * @brief Measures the throughput and allocations of a benchmark's loop.
+   *
+   * Construct it before the timed loop, count the tokens produced inside it,
+   * and call `report()` after it.
+   */
+  class LexCounters {
+   public:
+    /**
+     * @brief Start counting for a benchmark.
+     * @param state The benchmark state to report to.
+     * @param source_size The size of the source lexed per iteration.
+     */
+    LexCounters(benchmark::State& state, size_t source_size)
+        : state(state),
+          source_size(source_size),
+          allocations(allocation_count()),
+          tokens(0) {}
+
+    /**
+     * @brief Count tokens produced by the code under test.
+     * @param count The number of tokens.
+     */
+    void add_tokens(size_t count) { tokens += count; }
+
+    /**
+     * @brief Report MB/s, tokens/s and allocations per token.
+     */
+    void report() {
+      size_t allocated = allocation_count() - allocations;
+
+      state.SetBytesProcessed(state.iterations() * source_size);
+      state.counters["tokens/s"] =
+          benchmark::Counter(tokens, benchmark::Counter::kIsRate);
+      state.counters["allocs/token"] =
+          tokens ? static_cast<double>(allocated) / tokens : 0;
+    }
+
+   private:
+    benchmark::State& state;  //**< The benchmark reported to. */
+    size_t source_size;       //**< The bytes lexed per iteration. */
+    size_t allocations;       //**< The allocation count at the start. */
+    size_t tokens;            //**< The tokens counted so far. */
+  };
+
+}  // namespace excerpt::bench
@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+#include "corpus.hpp"
+#include "excerpt/compile_cache.hpp"
+#include "excerpt/driver.hpp"
+
+#include "llvm/Support/FileSystem.h"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace excerpt;
+using namespace excerpt::bench;
+
+namespace {
+  // A project of source files from a few hundred to a few thousand lines,
+  // written to a temporary directory once
+  struct Project {
+    std::vector<std::string> paths;
+    size_t bytes = 0;
+
+    Project() {
+      for (size_t i = 0; i < 256; i++) {
+        std::string path = "/tmp/excerpt_driver_bench_" + std::to_string(i) +
+                           ".ex";
+        auto source = typed_program_source(200 + (i * 37) % 3000);
+
+        std::ofstream(path, std::ios::binary) << *source;
+        paths.push_back(path);
+        bytes += source->size();
+      }
+    }
+
+    ~Project() {
+      for (const auto& path : paths) {
+        std::remove(path.c_str());
+        std::remove((path.substr(0, path.size() - 3) + ".o").c_str());
+      }
+    }
+  };
+
+  const Project& project() {
+    static Project instance;
+    return instance;
+  }
+}  // namespace
+
+static void BM_CompileFiles(benchmark::State& state) {
+  const Project& files = project();
+  DriverOptions options;
+  options.jobs = static_cast<unsigned>(state.range(0));
+  Driver driver(options);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(driver.run(files.paths));
+  }
+
+  state.SetBytesProcessed(state.iterations() * files.bytes);
+  state.counters["files/s"] = benchmark::Counter(
+      state.iterations() * files.paths.size(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_CompileFiles)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+
+// Recompiling an unchanged project with a warm cache, as CI does
+static void BM_CompileFilesCached(benchmark::State& state) {
+  const Project& files = project();
+  std::string directory = "/tmp/excerpt_driver_bench_cache";
+
+  DriverOptions options;
+  options.jobs = static_cast<unsigned>(state.range(0));
+  options.cache_dir = directory;
+  Driver driver(options);
+
+  llvm::sys::fs::remove_directories(directory);
+  driver.run(files.paths);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(driver.run(files.paths));
+  }
+
+  llvm::sys::fs::remove_directories(directory);
+  state.SetBytesProcessed(state.iterations() * files.bytes);
+  state.counters["files/s"] = benchmark::Counter(
+      state.iterations() * files.paths.size(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_CompileFilesCached)->Arg(1)->Arg(4)->UseRealTime();
+
+static void BM_CacheKey(benchmark::State& state) {
+  auto source = typed_program_source(state.range(0));
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CompileCache::key({"version", *source}));
+  }
+
+  state.SetBytesProcessed(state.iterations() * source->size());
+}
+BENCHMARK(BM_CacheKey)->Arg(1000)->Arg(100000);
@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+#include "corpus.hpp"
+#include "excerpt/backend.hpp"
+#include "excerpt/codegen.hpp"
+#include "excerpt/jit.hpp"
+#include "excerpt/parser.hpp"
+
+#include "llvm/Target/TargetMachine.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace excerpt;
+using namespace excerpt::bench;
+
+namespace {
+  // A large program whose `main` calls one of its functions, as a script
+  // using a small part of a library might
+  const std::string& script() {
+    static const std::string source =
+        *typed_program_source(5000) + "int main() { return f0(1, 2); }\n";
+    return source;
+  }
+
+  // Generates the module of a program
+  std::unique_ptr<llvm::Module> generate(llvm::LLVMContext& context,
+                                         const std::string& source) {
+    Parser parser(source);
+    NodeId program = parser.parse();
+    CodeGenerator generator(context, source, parser.tokens(), parser.ast(),
+                            "bench.ex");
+    return generator.generate(program);
+  }
+
+  const OptLevel levels[] = {OptLevel::O0, OptLevel::O2};
+  const char* level_names[] = {"-O0", "-O2"};
+}  // namespace
+
+// From source to `main` returning, compiling functions as they are called
+static void BM_TimeToMainJit(benchmark::State& state) {
+  const std::string& source = script();
+  OptLevel level = levels[state.range(0)];
+  size_t compiled = 0;
+
+  for (auto _ : state) {
+    auto context = std::make_unique<llvm::LLVMContext>();
+    auto module = generate(*context, source);
+    auto jit = Jit::create(level);
+
+    jit->add(std::move(module), std::move(context));
+    benchmark::DoNotOptimize(jit->run_main());
+    compiled = jit->compiled_functions();
+  }
+
+  state.SetLabel(level_names[state.range(0)]);
+  state.counters["compiled"] = compiled;
+}
+BENCHMARK(BM_TimeToMainJit)
+    ->DenseRange(0, 1)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// From source to `main` returning, compiling the whole program to an object,
+// linking it with the system compiler and running it
+static void BM_TimeToMainAot(benchmark::State& state) {
+  const std::string& source = script();
+  OptLevel level = levels[state.range(0)];
+  std::string object = "/tmp/excerpt_jit_bench.o";
+  std::string executable = "/tmp/excerpt_jit_bench";
+  std::string command =
+      "cc " + object + " -o " + executable + " && " + executable;
+
+  for (auto _ : state) {
+    llvm::LLVMContext context;
+    auto module = generate(context, source);
+    auto machine = create_target_machine(level);
+
+    optimize(*module, *machine, level);
+    emit_object(*module, *machine, object);
+
+    if (std::system(command.c_str()) == -1) {
+      state.SkipWithError("could not link and run the program");
+      break;
+    }
+  }
+
+  std::remove(object.c_str());
+  std::remove(executable.c_str());
+  state.SetLabel(level_names[state.range(0)]);
+}
+BENCHMARK(BM_TimeToMainAot)
+    ->DenseRange(0, 1)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,53 @@
+#include <benchmark/benchmark.h>
+#include "corpus.hpp"
+#include "excerpt/memory.hpp"
+#include "excerpt/parser.hpp"
+
+#include <new>
+
+using namespace excerpt;
+using namespace excerpt::bench;
+
+namespace {
+  // Tracking is on for the whole run (see counters.cpp), so the untracked
+  // cases turn it off and every case leaves it on
+  void track(bool enabled) {
+    if (enabled) {
+      memory::start();
+    } else {
+      memory::stop();
+    }
+  }
+}  // namespace
+
+// A small allocation and its free, with the tracking allocator off or on
+static void BM_Allocate(benchmark::State& state) {
+  track(state.range(0));
+
+  for (auto _ : state) {
+    void* block = ::operator new(64);
+    benchmark::DoNotOptimize(block);
+    ::operator delete(block);
+  }
+
+  memory::start();
+  state.SetLabel(state.range(0) ? "tracked" : "untracked");
+}
+BENCHMARK(BM_Allocate)->DenseRange(0, 1);
+
+// Parsing, which allocates the AST, with tracking off or on
+static void BM_ParseTracked(benchmark::State& state) {
+  auto text = typed_program_source(2000);
+  const std::string& source = *text;
+  track(state.range(0));
+
+  for (auto _ : state) {
+    Parser parser(source);
+    benchmark::DoNotOptimize(parser.parse());
+  }
+
+  memory::stop();
+  state.SetBytesProcessed(state.iterations() * source.size());
+  state.SetLabel(state.range(0) ? "tracked" : "untracked");
+}
+BENCHMARK(BM_ParseTracked)->DenseRange(0, 1);
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include "corpus.hpp"
+#include "counters.hpp"
+#include "excerpt/parser.hpp"
+
+using namespace excerpt;
+using namespace excerpt::bench;
+
+namespace {
+  // Reports MB/s, nodes/s and allocations per node for parsing a source
+  void report_parse(benchmark::State& state, size_t source_size, size_t nodes,
+                    size_t allocations) {
+    double parsed = static_cast<double>(nodes) * state.iterations();
+
+    state.SetBytesProcessed(state.iterations() * source_size);
+    state.counters["nodes/s"] =
+        benchmark::Counter(parsed, benchmark::Counter::kIsRate);
+    state.counters["allocs/node"] = allocations / parsed;
+  }
+}  // namespace
+
+static void BM_ParseProgram(benchmark::State& state) {
+  auto source = program_source(state.range(0));
+  size_t allocations = allocation_count();
+  size_t nodes = 0;
+
+  for (auto _ : state) {
+    Parser parser(*source);
+    benchmark::DoNotOptimize(parser.parse());
+    nodes = parser.ast().size();
+  }
+
+  report_parse(state, source->size(), nodes,
+               allocation_count() - allocations);
+  state.counters["lines/s"] = benchmark::Counter(
+      static_cast<double>(state.range(0)) * state.iterations(),
+      benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ParseProgram)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+// Parses `1 + (1 + (1 + ...))`, nested `n` deep
+static void BM_ParseNestedExpression(benchmark::State& state) {
+  std::string source;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    source += "1 + (";
+  }
+  source += "1" + std::string(state.range(0), ')');
+
+  size_t nodes = 0;
+
+  for (auto _ : state) {
+    Parser parser(source);
+    benchmark::DoNotOptimize(parser.parse_expression());
+    nodes = parser.ast().size();
+  }
+
+  report_parse(state, source.size(), nodes, 0);
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ParseNestedExpression)
+    ->RangeMultiplier(8)
+    ->Range(1 << 8, 1 << 20)
+    ->Complexity(benchmark::oN);
+
+// Parses a function of `n` statements
+static void BM_ParseStatementList(benchmark::State& state) {
+  std::string source = "int main() {\n";
+  for (int64_t i = 0; i < state.range(0); i++) {
+    source += "  x = x * 2 + f(x, 1);\n";
+  }
+  source += "}\n";
+
+  size_t nodes = 0;
+
+  for (auto _ : state) {
+    Parser parser(source);
+    benchmark::DoNotOptimize(parser.parse());
+    nodes = parser.ast().size();
+  }
+
+  report_parse(state, source.size(), nodes, 0);
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ParseStatementList)
+    ->RangeMultiplier(8)
+    ->Range(1 << 8, 1 << 20)
+    ->Complexity(benchmark::oN);
@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+#include "corpus.hpp"
+#include "excerpt/source_buffer.hpp"
+#include "excerpt/token_file.hpp"
+#include "excerpt/tokenizer.hpp"
+
+using namespace excerpt;
+using namespace excerpt::bench;
+
+// Serializing the tokens of a source
+static void BM_WriteTokenFile(benchmark::State& state) {
+  auto source = mixed_source(state.range(0));
+  TokenBuffer tokens = Tokenizer(*source).tokenize_all();
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(write_token_file(tokens, *source));
+  }
+
+  state.SetBytesProcessed(state.iterations() * source->size());
+}
+BENCHMARK(BM_WriteTokenFile)->Arg(1 << 20);
+
+// What a tool does instead of lexing again: view a token file and visit
+// every token's type, line and spelling
+static void BM_ReadTokenFile(benchmark::State& state) {
+  auto source = mixed_source(state.range(0));
+  auto bytes = std::make_shared<const std::string>(
+      write_token_file(Tokenizer(*source).tokenize_all(), *source));
+  auto buffer = SourceBuffer::from_string(bytes, "bench.tok");
+  size_t tokens = 0;
+
+  for (auto _ : state) {
+    auto file = TokenFile::from_buffer(buffer);
+    size_t sum = 0;
+
+    for (TokenFile::TokenView token : *file) {
+      sum += static_cast<size_t>(token.type) + token.line + token.text.size();
+    }
+
+    benchmark::DoNotOptimize(sum);
+    tokens += file->size();
+  }
+
+  state.SetBytesProcessed(state.iterations() * source->size());
+  state.counters["tokens/s"] =
+      benchmark::Counter(tokens, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ReadTokenFile)->Arg(1 << 20);
+
+// Lexing again and resolving lines, the cost the token file saves
+static void BM_RelexWithLines(benchmark::State& state) {
+  auto source = mixed_source(state.range(0));
+  size_t tokens = 0;
+
+  for (auto _ : state) {
+    Tokenizer tokenizer(*source);
+    TokenBuffer buffer = tokenizer.tokenize_all();
+    size_t sum = 0;
+
+    for (size_t i = 0; i < buffer.size(); i++) {
+      sum += tokenizer.source_manager().location(buffer.offsets[i]).line;
+    }
+
+    benchmark::DoNotOptimize(sum);
+    tokens += buffer.size();
+  }
+
+  state.SetBytesProcessed(state.iterations() * source->size());
+  state.counters["tokens/s"] =
+      benchmark::Counter(tokens, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_RelexWithLines)->Arg(1 << 20);
@@ -0,0 +1,226 @@
+#include <benchmark/benchmark.h>
+#include "corpus.hpp"
+#include "counters.hpp"
+#include "excerpt/incremental_tokenizer.hpp"
+#include "excerpt/parallel_tokenizer.hpp"
+#include "excerpt/stream_tokenizer.hpp"
+#include "excerpt/string_literal.hpp"
+#include "excerpt/tokenizer.hpp"
+
+#include <sstream>
+
+using namespace excerpt;
+using namespace excerpt::bench;
+
+namespace {
+  // A corpus generator, taking the approximate size in bytes
+  using Generator = std::shared_ptr<std::string> (*)(size_t size);
+
+  // The corpus size every benchmark lexes per iteration
+  constexpr int CORPUS_SIZE = 1 << 20;
+}  // namespace
+
+static void BM_TokenizerNext(benchmark::State& state, Generator generate) {
+  auto source = generate(state.range(0));
+  LexCounters counters(state, source->size());
+
+  for (auto _ : state) {
+    Tokenizer tokenizer(source);
+    for (auto token = tokenizer.next(); token->type != TokenType::END;
+         token = tokenizer.next()) {
+      benchmark::DoNotOptimize(token);
+      counters.add_tokens(1);
+    }
+  }
+
+  counters.report();
+  state.counters["bytes/token"] = sizeof(Token);
+}
+BENCHMARK_CAPTURE(BM_TokenizerNext, mixed, mixed_source)->Arg(CORPUS_SIZE);
+
+static void BM_TokenizeAll(benchmark::State& state, Generator generate) {
+  auto source = generate(state.range(0));
+  LexCounters counters(state, source->size());
+  size_t bytes = 0;
+  size_t tokens = 0;
+
+  for (auto _ : state) {
+    Tokenizer tokenizer(source);
+    TokenBuffer buffer = tokenizer.tokenize_all();
+    benchmark::DoNotOptimize(buffer.types.data());
+
+    counters.add_tokens(buffer.size());
+    bytes = buffer.capacity_bytes();
+    tokens = buffer.size();
+  }
+
+  counters.report();
+  state.counters["bytes/token"] = static_cast<double>(bytes) / tokens;
+}
+BENCHMARK_CAPTURE(BM_TokenizeAll, mixed, mixed_source)->Arg(CORPUS_SIZE);
+BENCHMARK_CAPTURE(BM_TokenizeAll, identifiers, identifier_source)
+    ->Arg(CORPUS_SIZE);
+BENCHMARK_CAPTURE(BM_TokenizeAll, literals, literal_source)->Arg(CORPUS_SIZE);
+BENCHMARK_CAPTURE(BM_TokenizeAll, constants, constant_source)
+    ->Arg(CORPUS_SIZE);
+BENCHMARK_CAPTURE(BM_TokenizeAll, operators, operator_source)
+    ->Arg(CORPUS_SIZE);
+BENCHMARK_CAPTURE(BM_TokenizeAll, comments, comment_source)->Arg(CORPUS_SIZE);
+
+static void BM_TokenizeInterned(benchmark::State& state, Generator generate) {
+  auto source = generate(state.range(0));
+  LexCounters counters(state, source->size());
+  size_t symbols = 0;
+
+  for (auto _ : state) {
+    Interner interner;
+    Tokenizer tokenizer(source);
+    tokenizer.set_interner(&interner);
+
+    TokenBuffer buffer = tokenizer.tokenize_all();
+    benchmark::DoNotOptimize(buffer.symbols.data());
+
+    counters.add_tokens(buffer.size());
+    symbols = interner.size();
+  }
+
+  counters.report();
+  state.counters["symbols"] = symbols;
+}
+BENCHMARK_CAPTURE(BM_TokenizeInterned, mixed, mixed_source)->Arg(CORPUS_SIZE);
+BENCHMARK_CAPTURE(BM_TokenizeInterned, identifiers, identifier_source)
+    ->Arg(CORPUS_SIZE);
+
+static void BM_TokenizeParallel(benchmark::State& state) {
+  auto source = mixed_source(state.range(0));
+  unsigned threads = state.range(1);
+  LexCounters counters(state, source->size());
+
+  for (auto _ : state) {
+    TokenBuffer buffer = tokenize_parallel(*source, threads);
+    benchmark::DoNotOptimize(buffer.types.data());
+
+    counters.add_tokens(buffer.size());
+  }
+
+  counters.report();
+}
+BENCHMARK(BM_TokenizeParallel)
+    ->ArgsProduct({{1 << 24}, {1, 2, 4, 8, 16}})
+    ->UseRealTime();
+
+static void BM_StreamTokenizer(benchmark::State& state) {
+  auto source = mixed_source(state.range(0));
+  LexCounters counters(state, source->size());
+
+  for (auto _ : state) {
+    std::istringstream input(*source);
+    StreamTokenizer stream(input, 4096);
+
+    while (stream.next().type != TokenType::END) {
+      counters.add_tokens(1);
+    }
+  }
+
+  counters.report();
+}
+BENCHMARK(BM_StreamTokenizer)->Arg(CORPUS_SIZE);
+
+// Types a character in the middle of a source and deletes it again
+static void BM_Relex(benchmark::State& state) {
+  std::string source = *mixed_source(state.range(0));
+  TokenBuffer tokens = Tokenizer(std::string_view{source}).tokenize_all();
+  size_t offset = source.size() / 2;
+
+  for (auto _ : state) {
+    source.insert(offset, 1, 'x');
+    relex(tokens, source, {offset, 0, "x"});
+
+    source.erase(offset, 1);
+    relex(tokens, source, {offset, 1, ""});
+  }
+
+  state.counters["edits/s"] =
+      benchmark::Counter(state.iterations() * 2, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Relex)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+// Skips every gap of whitespace and comments, and the semicolon after it
+static void BM_Skipws(benchmark::State& state) {
+  auto source = gap_source(state.range(0));
+  LexCounters counters(state, source->size());
+
+  for (auto _ : state) {
+    Tokenizer tokenizer(source);
+    while (tokenizer.skipws() != '\0') {
+      tokenizer.advance();
+      counters.add_tokens(1);
+    }
+  }
+
+  counters.report();
+}
+BENCHMARK(BM_Skipws)->Arg(CORPUS_SIZE);
+
+// Calls one parse function on every token of a corpus it alone can lex
+template <Lexeme (Tokenizer::*Parse)()>
+static void parse_each(benchmark::State& state, Generator generate) {
+  auto source = generate(state.range(0));
+  LexCounters counters(state, source->size());
+
+  for (auto _ : state) {
+    Tokenizer tokenizer(source);
+    while (tokenizer.skipws() != '\0') {
+      benchmark::DoNotOptimize((tokenizer.*Parse)());
+      counters.add_tokens(1);
+    }
+  }
+
+  counters.report();
+}
+
+static void BM_ParseNumber(benchmark::State& state) {
+  parse_each<&Tokenizer::parse_number>(state, number_source);
+}
+BENCHMARK(BM_ParseNumber)->Arg(CORPUS_SIZE);
+
+static void BM_ParseString(benchmark::State& state) {
+  parse_each<&Tokenizer::parse_string>(state, string_source);
+}
+BENCHMARK(BM_ParseString)->Arg(CORPUS_SIZE);
+
+static void BM_ParseEscapedString(benchmark::State& state) {
+  parse_each<&Tokenizer::parse_string>(state, escaped_string_source);
+}
+BENCHMARK(BM_ParseEscapedString)->Arg(CORPUS_SIZE);
+
+static void BM_StringValue(benchmark::State& state) {
+  auto source = escaped_string_source(state.range(0));
+  TokenBuffer tokens = Tokenizer(source).tokenize_all();
+  LexCounters counters(state, source->size());
+  std::string storage;
+
+  // Only the escaped fifth are copied, into storage reused between them
+  for (auto _ : state) {
+    for (size_t i = 0; i + 1 < tokens.size(); i++) {
+      std::string_view spelling(source->data() + tokens.offsets[i],
+                                tokens.lengths[i]);
+      benchmark::DoNotOptimize(string_value(spelling, storage));
+    }
+
+    counters.add_tokens(tokens.size() - 1);
+  }
+
+  counters.report();
+}
+BENCHMARK(BM_StringValue)->Arg(CORPUS_SIZE);
+
+static void BM_ParseIdentifier(benchmark::State& state) {
+  parse_each<&Tokenizer::parse_identifier>(state, identifier_source);
+}
+BENCHMARK(BM_ParseIdentifier)->Arg(CORPUS_SIZE);
+
+static void BM_ParseSymbol(benchmark::State& state) {
+  parse_each<&Tokenizer::parse_symbol>(state, operator_source);
+}
+BENCHMARK(BM_ParseSymbol)->Arg(CORPUS_SIZE);
@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+#include "excerpt_utils/logger.hpp"
+
+#include <fstream>
+#include <mutex>
+
+using namespace excerpt;
+
+namespace {
+  // Log lines go to /dev/null, so writing them still costs system calls
+  std::ofstream null_sink("/dev/null");
+  std::streambuf* saved_sink;
+
+  void redirect(const benchmark::State&) {
+    saved_sink = std::cout.rdbuf(null_sink.rdbuf());
+  }
+
+  void restore(const benchmark::State&) {
+    logger::flush();
+    std::cout.rdbuf(saved_sink);
+  }
+
+  void start_blocking(const benchmark::State& state) {
+    redirect(state);
+    logger::start_async(1024, logger::Overflow::BLOCK);
+  }
+
+  void start_dropping(const benchmark::State& state) {
+    redirect(state);
+    logger::start_async(1024, logger::Overflow::DROP);
+  }
+
+  void stop(const benchmark::State& state) {
+    logger::stop_async();
+    restore(state);
+  }
+
+  // The logger as it was: a timestamp from `std::localtime` and a flush on
+  // every line, under a global mutex
+  void legacy_log(const std::string& message) {
+    static std::mutex mtx;
+
+    std::time_t currentTime = std::time(0);
+    std::tm* localTime = std::localtime(&currentTime);
+
+    char timestamp[20];
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localTime);
+
+    std::lock_guard<std::mutex> lock(mtx);
+    std::cout << "[" << timestamp << "] "
+              << "\033[0;32m"
+              << "INFO"
+              << "\033[0m: " << message << std::endl;
+  }
+
+  const std::string MESSAGE = "Lexed 123456 tokens from source.ex";
+}  // namespace
+
+static void BM_LogLegacy(benchmark::State& state) {
+  for (auto _ : state) {
+    legacy_log(MESSAGE);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LogLegacy)
+    ->Setup(redirect)
+    ->Teardown(restore)
+    ->ThreadRange(1, 32)
+    ->UseRealTime();
+
+static void BM_LogSync(benchmark::State& state) {
+  for (auto _ : state) {
+    logger::info(MESSAGE);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LogSync)
+    ->Setup(redirect)
+    ->Teardown(restore)
+    ->ThreadRange(1, 32)
+    ->UseRealTime();
+
+static void BM_LogAsync(benchmark::State& state) {
+  for (auto _ : state) {
+    logger::info(MESSAGE);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LogAsync)
+    ->Setup(start_blocking)
+    ->Teardown(stop)
+    ->ThreadRange(1, 32)
+    ->UseRealTime();
+
+static void BM_LogAsyncDrop(benchmark::State& state) {
+  for (auto _ : state) {
+    logger::info(MESSAGE);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  state.counters["dropped"] = benchmark::Counter(
+      logger::dropped(), benchmark::Counter::kAvgThreads);
+}
+BENCHMARK(BM_LogAsyncDrop)
+    ->Setup(start_dropping)
+    ->Teardown(stop)
+    ->ThreadRange(1, 32)
+    ->UseRealTime();
+
+// Messages below the runtime threshold, built up front or only if logged
+static void BM_LogFilteredEager(benchmark::State& state) {
+  logger::set_level(logger::WARNING);
+  size_t tokens = 123456;
+
+  for (auto _ : state) {
+    logger::info("Lexed " + std::to_string(tokens) + " tokens from " + MESSAGE);
+    benchmark::DoNotOptimize(tokens);
+  }
+
+  logger::set_level(logger::COMPILED_LEVEL);
+}
+BENCHMARK(BM_LogFilteredEager);
+
+static void BM_LogFilteredLazy(benchmark::State& state) {
+  logger::set_level(logger::WARNING);
+  size_t tokens = 123456;
+
+  for (auto _ : state) {
+    logger::info("Lexed {0} tokens from {1}", tokens, MESSAGE);
+    benchmark::DoNotOptimize(tokens);
+  }
+
+  logger::set_level(logger::COMPILED_LEVEL);
+}
+BENCHMARK(BM_LogFilteredLazy);
+
+// Messages below the compiled level, which compile to nothing
+static void BM_LogCompiledOut(benchmark::State& state) {
+  size_t tokens = 123456;
+
+  for (auto _ : state) {
+    logger::debug("Lexed {0} tokens from {1}", tokens, MESSAGE);
+    benchmark::DoNotOptimize(tokens);
+  }
+}
+BENCHMARK(BM_LogCompiledOut);
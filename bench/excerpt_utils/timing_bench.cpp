@@ -0,0 +1,31 @@
+#include <benchmark/benchmark.h>
+#include "excerpt_utils/timing.hpp"
+
+using namespace excerpt;
+
+// A timer while recording is off, as in every compile without a report
+static void BM_TimerDisabled(benchmark::State& state) {
+  timing::stop();
+
+  for (auto _ : state) {
+    timing::ScopedTimer timer(timing::LEX);
+    timer.count(64, 8);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_TimerDisabled);
+
+// A timer while recording, with or without the trace kept
+static void BM_TimerEnabled(benchmark::State& state) {
+  timing::start(state.range(0));
+
+  for (auto _ : state) {
+    timing::ScopedTimer timer(timing::LEX, "bench.ex");
+    timer.count(64, 8);
+    benchmark::ClobberMemory();
+  }
+
+  timing::stop();
+  state.SetLabel(state.range(0) ? "traced" : "summed");
+}
+BENCHMARK(BM_TimerEnabled)->DenseRange(0, 1);
@@ -4,9 +4,11 @@
 mkdir -p build
 cd build
 
-# Check if we need to build tests
+# Check if we need to build tests or benchmarks
 if [ "$1" == "--build-tests" ]; then
   cmake -D BUILD_TESTS=ON ..
+elif [ "$1" == "--build-bench" ]; then
+  cmake -D BUILD_BENCH=ON ..
 else
   cmake ..
 fi
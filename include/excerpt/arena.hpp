@@ -0,0 +1,135 @@
+#pragma once
+
+#include "memory.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace excerpt {
+
+  /**
+   * @brief A bump allocator owning everything allocated from it.
+   *
+   * Memory is carved sequentially out of large blocks, so an allocation is a
+   * pointer bump and the whole arena is released at once when it is reset or
+   * destroyed. Nothing allocated from it is ever destructed, so it only holds
+   * trivially destructible objects.
+   *
+   * When allocations are tracked, an arena reports how full its blocks were
+   * as it releases them, charged to the subsystem owning it.
+   */
+  class Arena {
+   public:
+    /**
+     * @brief Constructs an Arena instance.
+     * @param block_size The size of the first block; later ones double.
+     * @param subsystem The subsystem owning the arena.
+     */
+    explicit Arena(size_t block_size = 64 * 1024,
+                   memory::Subsystem subsystem = memory::OTHER);
+
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    Arena(Arena&& other) noexcept;
+    Arena& operator=(Arena&& other) noexcept;
+
+    /**
+     * @brief Allocate uninitialized memory.
+     * @param size The number of bytes.
+     * @param alignment The alignment, a power of two.
+     * @return The memory, valid until the arena is reset or destroyed.
+     */
+    void* allocate(size_t size,
+                   size_t alignment = alignof(std::max_align_t)) {
+      auto address = reinterpret_cast<uintptr_t>(cursor);
+      size_t padding = -address & (alignment - 1);
+
+      if (size + padding > static_cast<size_t>(limit - cursor)) {
+        return grow(size, alignment);
+      }
+
+      void* result = cursor + padding;
+      cursor += padding + size;
+      used += size;
+
+      return result;
+    }
+
+    /**
+     * @brief Construct an object in the arena.
+     * @param args The arguments to construct the object with.
+     * @return The object.
+     */
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+      static_assert(std::is_trivially_destructible_v<T>,
+                    "arena objects are never destructed");
+
+      return new (allocate(sizeof(T), alignof(T)))
+          T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Copy a string into the arena.
+     * @param text The string to copy.
+     * @return A view of the copy.
+     */
+    std::string_view copy(std::string_view text) {
+      if (text.empty()) {
+        return std::string_view();
+      }
+
+      char* result = static_cast<char*>(allocate(text.size(), 1));
+      std::char_traits<char>::copy(result, text.data(), text.size());
+
+      return std::string_view(result, text.size());
+    }
+
+    /**
+     * @brief Free everything allocated from the arena.
+     */
+    void reset();
+
+    /**
+     * @brief Get the number of bytes handed out by the arena.
+     * @return The bytes allocated, excluding alignment padding.
+     */
+    size_t bytes_used() const { return used; }
+
+    /**
+     * @brief Get the number of bytes the arena holds in its blocks.
+     * @return The total size of the blocks.
+     */
+    size_t bytes_reserved() const { return reserved; }
+
+   private:
+    /**
+     * @brief Allocate from a new block, the current one being too full.
+     * @return The memory.
+     */
+    void* grow(size_t size, size_t alignment);
+
+    std::vector<std::unique_ptr<char[]>> blocks;  //**< The blocks owned. */
+
+    char* cursor;  //**< The next free byte of the current block. */
+    char* limit;   //**< The end of the current block. */
+
+    size_t first_block_size;  //**< The size of the first block. */
+    size_t next_block_size;   //**< The size of the next block. */
+
+    size_t used;      //**< The bytes handed out. */
+    size_t reserved;  //**< The bytes held in blocks. */
+
+    memory::Subsystem subsystem;  //**< The subsystem owning the arena. */
+  };
+
+}  // namespace excerpt
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "arena.hpp"
+#include "token.hpp"
+
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace excerpt {
+
+  /**
+   * @brief The index of a node in an Ast.
+   */
+  using NodeId = uint32_t;
+
+  /**
+   * @brief The index of a list of node ids in an Ast.
+   */
+  using ListId = uint32_t;
+
+  /**
+   * @brief The id standing for a missing node, i.e an omitted `else`.
+   */
+  inline constexpr NodeId NO_NODE = std::numeric_limits<NodeId>::max();
+
+  /**
+   * @brief The kinds of AST nodes.
+   *
+   * The comment on each kind describes how its node uses the `op`, `token`,
+   * `lhs` and `rhs` fields of Node. Fields left out are unused.
+   */
+  enum class NodeKind : uint8_t {
+    // Expressions
+    INTEGER,  // token: the literal
+    FLOAT,    // token: the literal
+    STRING,   // token: the literal
+    BOOLEAN,  // token: `true` or `false`
+    NAME,     // token: the identifier
+    UNARY,    // op: the operator, lhs: the operand
+    BINARY,   // op: the operator, lhs/rhs: the operands
+    ASSIGN,   // lhs: the target, rhs: the value
+    CALL,     // lhs: the callee, rhs: the list of arguments
+
+    // Statements
+    EXPRESSION,   // lhs: the expression
+    DECLARATION,  // op: the type, token: the name, lhs: the initializer
+    BLOCK,        // lhs: the list of statements
+    IF,           // lhs: the condition, rhs: the list {then, else}
+    WHILE,        // lhs: the condition, rhs: the body
+    FOR,          // lhs: the list {init, condition, step}, rhs: the body
+    RETURN,       // lhs: the value
+    BREAK,        // token: the keyword
+    CONTINUE,     // token: the keyword
+
+    // Declarations
+    PARAMETER,  // op: the type, token: the name
+    FUNCTION,   // op: the return type, token: the name, lhs: the list of
+                // parameters, rhs: the body
+    PROGRAM     // lhs: the list of functions and declarations
+  };
+
+  /**
+   * @brief A node of the AST.
+   *
+   * Nodes refer to their children by id rather than by pointer, and to their
+   * source by the index of a token in the TokenBuffer they were parsed from,
+   * so a node is 16 bytes and owns nothing.
+   */
+  struct Node {
+    NodeKind kind;  /**< The kind of the node. */
+    TokenType op;   /**< The operator or type, depending on the kind. */
+    uint32_t token; /**< The index of the node's main token. */
+    NodeId lhs;     /**< The first child or list, depending on the kind. */
+    NodeId rhs;     /**< The second child or list, depending on the kind. */
+  };
+
+  static_assert(sizeof(Node) == 16, "nodes should stay compact");
+
+  /**
+   * @brief An abstract syntax tree.
+   *
+   * Nodes are addressed by 32-bit NodeId; the variable-length children of a
+   * node (statements, arguments, parameters) are stored as lists addressed
+   * by ListId. Both are carved out of an Arena, nodes in fixed-size chunks,
+   * so that a NodeId is a chunk and an index within it, and each list in one
+   * piece. Nothing is moved as the tree grows, so nodes and lists stay valid
+   * as more are added, a tree costs a handful of allocations however large
+   * it is, and the whole of it is freed at once with the Ast.
+   */
+  class Ast {
+   public:
+    /** The nodes in each chunk, a power of two. */
+    static constexpr size_t CHUNK_SIZE = 1024;
+
+    /**
+     * @brief Append a node.
+     * @return The id of the node.
+     */
+    NodeId add(NodeKind kind, TokenType op, uint32_t token,
+               NodeId lhs = NO_NODE, NodeId rhs = NO_NODE) {
+      if (count % CHUNK_SIZE == 0) {
+        add_chunk();
+      }
+
+      chunks.back()[count % CHUNK_SIZE] = Node{kind, op, token, lhs, rhs};
+      return static_cast<NodeId>(count++);
+    }
+
+    /**
+     * @brief Append a list of node ids.
+     * @param items The ids, which may include NO_NODE.
+     * @return The id of the list.
+     */
+    ListId add_list(std::span<const NodeId> items);
+
+    /**
+     * @brief Append a list of node ids.
+     * @param items The ids, which may include NO_NODE.
+     * @return The id of the list.
+     */
+    ListId add_list(std::initializer_list<NodeId> items) {
+      return add_list(std::span<const NodeId>(items.begin(), items.size()));
+    }
+
+    /**
+     * @brief Get a node.
+     * @param id The id of the node.
+     * @return The node, valid as long as the tree.
+     */
+    const Node& node(NodeId id) const {
+      return chunks[id / CHUNK_SIZE][id % CHUNK_SIZE];
+    }
+
+    /**
+     * @brief Get a node.
+     * @param id The id of the node.
+     * @return The node, valid as long as the tree.
+     */
+    Node& node(NodeId id) { return chunks[id / CHUNK_SIZE][id % CHUNK_SIZE]; }
+
+    /**
+     * @brief Get a list of node ids.
+     * @param id The id of the list.
+     * @return The ids, valid as long as the tree.
+     */
+    std::span<const NodeId> list(ListId id) const {
+      return std::span<const NodeId>(lists[id] + 1, lists[id][0]);
+    }
+
+    /**
+     * @brief Get the number of nodes.
+     * @return The number of nodes.
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Reserve room for a number of nodes.
+     * @param count The number of nodes to reserve room for.
+     */
+    void reserve(size_t count) {
+      chunks.reserve(count / CHUNK_SIZE + 1);
+      lists.reserve(count / 4);
+    }
+
+    /**
+     * @brief Get the number of bytes the tree has allocated.
+     * @return The allocated size in bytes.
+     */
+    size_t capacity_bytes() const {
+      return arena.bytes_reserved() + chunks.capacity() * sizeof(Node*) +
+             lists.capacity() * sizeof(const NodeId*);
+    }
+
+   private:
+    /**
+     * @brief Allocate the chunk the next nodes go in.
+     */
+    void add_chunk();
+
+    Arena arena{64 * 1024, memory::AST};  //**< Holds the chunks and lists. */
+    std::vector<Node*> chunks;  //**< The node chunks, in id order. */
+    std::vector<const NodeId*> lists;  //**< Each list, a count then ids. */
+    size_t count = 0;  //**< The number of nodes. */
+  };
+
+}  // namespace excerpt
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "excerpt_utils/opt_level.hpp"
+
+#include <memory>
+#include <string>
+
+namespace llvm {
+  class Module;
+  class TargetMachine;
+  class raw_pwrite_stream;
+}  // namespace llvm
+
+namespace excerpt {
+
+  /**
+   * @brief Create a machine for the host target.
+   * @param level The optimization level, which sets the code generator's.
+   * @return The machine, or nullptr (after logging an error) if the host is
+   * not a supported target.
+   */
+  std::unique_ptr<llvm::TargetMachine> create_target_machine(OptLevel level);
+
+  /**
+   * @brief Describe the target `create_target_machine()` creates machines
+   * for, i.e to tell apart outputs compiled for different hosts.
+   * @return The target triple and CPU name.
+   */
+  std::string host_target();
+
+  /**
+   * @brief Optimize a module with the new pass manager's default pipeline
+   * for a level.
+   *
+   * `-O0` runs only the passes needed for correctness, `-O1` the cheap
+   * simplifications, `-O2` adds inlining, vectorization and the rest of the
+   * expensive passes, `-O3` more aggressive versions of them, and `-Os` the
+   * `-O2` pipeline tuned for size.
+   *
+   * @param module The module, which is set to target `machine`.
+   * @param machine The target, whose cost model the passes use.
+   * @param level The optimization level.
+   * @param timings If not nullptr, receives a report of the time each pass
+   * took, as LLVM's `-time-passes` prints it.
+   */
+  void optimize(llvm::Module& module, llvm::TargetMachine& machine,
+                OptLevel level, std::string* timings = nullptr);
+
+  /**
+   * @brief Write a module as an object file.
+   * @param module The module, which is set to target `machine`.
+   * @param machine The target.
+   * @param path The path of the object file.
+   * @return True if the file was written, otherwise false (after logging an
+   * error).
+   */
+  bool emit_object(llvm::Module& module, llvm::TargetMachine& machine,
+                   const std::string& path);
+
+  /**
+   * @brief Write a module as an object file to a stream.
+   * @param module The module, which is set to target `machine`.
+   * @param machine The target.
+   * @param stream The stream, i.e a buffer in memory.
+   * @return True if the object was written, otherwise false (after logging
+   * an error).
+   */
+  bool emit_object(llvm::Module& module, llvm::TargetMachine& machine,
+                   llvm::raw_pwrite_stream& stream);
+
+}  // namespace excerpt
@@ -0,0 +1,279 @@
+#pragma once
+
+#include "ast.hpp"
+#include "interner.hpp"
+#include "source_manager.hpp"
+#include "token_buffer.hpp"
+
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace excerpt {
+
+  /**
+   * @brief Generates LLVM IR from an Ast.
+   *
+   * Types map to `int` i32, `float` double, `char` i8 and `bool` i1, and
+   * mix as in C: operands are promoted to `int` or `float`, and values are
+   * converted implicitly on assignment, on calls and on return. Locals live
+   * in stack slots, left for mem2reg to promote. Functions may be called
+   * before they are defined; calls of a name that is not defined anywhere
+   * declare an external function returning `int`, as C89 did.
+   *
+   * Expressions are walked over explicit stacks rather than recursion, as
+   * the Parser builds them, so however deeply they nest they cannot overflow
+   * the call stack.
+   *
+   * Names resolve by SymbolId: each symbol maps to its innermost variable,
+   * which links to the one it shadows, so declaring, finding and leaving a
+   * scope take constant time per name however many are in scope.
+   */
+  class CodeGenerator {
+   public:
+    /**
+     * @brief Constructs a CodeGenerator instance.
+     * @param context The context to create the module in.
+     * @param source The source the tree was parsed from.
+     * @param tokens The tokens the tree's nodes refer to.
+     * @param ast The tree.
+     * @param name The name of the source, used in diagnostics and as the
+     * module's name.
+     */
+    CodeGenerator(llvm::LLVMContext& context, std::string_view source,
+                  const TokenBuffer& tokens, const Ast& ast, std::string name);
+
+    /**
+     * @brief Generate the module of a program.
+     * @param program The PROGRAM node.
+     * @return The module, or nullptr (after logging an error) if the program
+     * is not valid.
+     */
+    std::unique_ptr<llvm::Module> generate(NodeId program);
+
+   private:
+    /**
+     * @brief A value and its source-level type, i.e `TokenType::INT`.
+     */
+    struct Value {
+      llvm::Value* value; /**< The value, or nullptr after an error. */
+      TokenType type;     /**< The type of the value. */
+    };
+
+    /**
+     * @brief A variable in scope.
+     */
+    struct Variable {
+      std::string_view name; /**< The name of the variable. */
+      llvm::Value* address;  /**< Its stack slot or global. */
+      TokenType type;        /**< The type of the variable. */
+      SymbolId symbol;       /**< The interned name. */
+      uint32_t shadowed;     /**< The variable it hides, or NO_VARIABLE. */
+    };
+
+    /**
+     * @brief The index standing for no variable.
+     */
+    static constexpr uint32_t NO_VARIABLE =
+        std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @brief A function that may be called.
+     */
+    struct Function {
+      llvm::Function* function;          /**< The function. */
+      TokenType result;                  /**< The return type. */
+      std::vector<TokenType> parameters; /**< The parameter types. */
+    };
+
+    /**
+     * @brief An expression node being generated.
+     */
+    struct Frame {
+      NodeId id;     /**< The node. */
+      uint32_t done; /**< The number of its operands generated so far. */
+    };
+
+    /**
+     * @brief The targets of `break` and `continue` in a loop.
+     */
+    struct Loop {
+      llvm::BasicBlock* next; /**< Where `continue` goes. */
+      llvm::BasicBlock* exit; /**< Where `break` goes. */
+    };
+
+    /**
+     * @brief Get the LLVM type of a source type.
+     */
+    llvm::Type* type_of(TokenType type);
+
+    /**
+     * @brief Declare a function, so it may be called before its definition.
+     */
+    void declare_function(NodeId id);
+
+    /**
+     * @brief Generate the body of a function.
+     */
+    void define_function(NodeId id);
+
+    /**
+     * @brief Generate a global variable.
+     */
+    void define_global(NodeId id);
+
+    /**
+     * @brief Generate a statement.
+     */
+    void statement(NodeId id);
+
+    /**
+     * @brief Generate a local variable declaration.
+     */
+    void declaration(const Node& node);
+
+    /**
+     * @brief Generate an `if` statement, with any `else if` arms chained to
+     * it.
+     */
+    void if_statement(const Node& first);
+
+    /**
+     * @brief Generate a `while` or `for` loop.
+     * @param init The initializer, or NO_NODE.
+     * @param condition The condition, or NO_NODE for none.
+     * @param step The step expression, or NO_NODE.
+     * @param body The body.
+     */
+    void loop(NodeId init, NodeId condition, NodeId step, NodeId body);
+
+    /**
+     * @brief Generate an expression.
+     * @return The value, whose `value` is nullptr after an error.
+     */
+    Value expression(NodeId id);
+
+    /**
+     * @brief Get an operand of an expression node.
+     * @param node The node.
+     * @param index The index of the operand, in evaluation order.
+     * @return The operand, or NO_NODE past the last.
+     */
+    NodeId operand(const Node& node, uint32_t index) const;
+
+    /**
+     * @brief Generate an expression node whose operands are generated.
+     * @param node The node.
+     * @param values The values of its operands, in evaluation order.
+     */
+    Value operation(const Node& node, std::span<const Value> values);
+
+    /**
+     * @brief Generate a binary operation.
+     */
+    Value binary(const Node& node, Value lhs, Value rhs);
+
+    /**
+     * @brief Generate a call.
+     */
+    Value call(const Node& node, std::span<const Value> values);
+
+    /**
+     * @brief Convert a value to another type, as C does implicitly.
+     */
+    Value convert(Value value, TokenType type);
+
+    /**
+     * @brief Generate an expression as a branch condition.
+     * @return The condition as an i1, or nullptr after an error.
+     */
+    llvm::Value* condition(NodeId id);
+
+    /**
+     * @brief Check whether an expression is made of literals alone.
+     */
+    bool is_constant(NodeId id) const;
+
+    /**
+     * @brief Get the symbol of a name token.
+     */
+    SymbolId symbol(uint32_t token);
+
+    /**
+     * @brief Check whether the innermost scope already has a variable of a
+     * name, reporting an error if it does.
+     * @param token The name token.
+     */
+    bool redefines(uint32_t token);
+
+    /**
+     * @brief Bring a variable into the innermost scope.
+     * @param token The name token.
+     */
+    void bind(uint32_t token, llvm::Value* address, TokenType type);
+
+    /**
+     * @brief Close the innermost scope, unbinding its variables.
+     */
+    void close_scope();
+
+    /**
+     * @brief Find a variable in scope.
+     * @param token The name token.
+     * @return The variable, or nullptr if there is none of that name.
+     */
+    const Variable* lookup(uint32_t token);
+
+    /**
+     * @brief Continue generating into a new block, i.e after a `return`.
+     */
+    void start_block(const char* name);
+
+    /**
+     * @brief Report an error at a token.
+     * @param token The index of the token.
+     * @param message The error message.
+     * @return A failed Value, for convenience.
+     */
+    Value error(uint32_t token, const std::string& message);
+
+    /**
+     * @brief Get the spelling of a token.
+     */
+    std::string_view spelling(uint32_t token) const {
+      return source.substr(tokens.offsets[token], tokens.lengths[token]);
+    }
+
+    llvm::LLVMContext& context;  //**< The context of the module. */
+    llvm::IRBuilder<> builder;   //**< Inserts instructions. */
+    std::unique_ptr<llvm::Module> module;  //**< The module being built. */
+
+    std::string_view source;    //**< The source of the tree. */
+    const TokenBuffer& tokens;  //**< The tokens of the tree. */
+    const Ast& ast;             //**< The tree. */
+    std::string name;           //**< The name of the source. */
+    SourceManager manager;      //**< Resolves positions for diagnostics. */
+
+    std::unordered_map<std::string_view, Function> functions;  //**< By name. */
+    std::vector<Variable> variables;  //**< Those in scope, innermost last. */
+    std::vector<uint32_t> bindings;   //**< Innermost variable, by symbol. */
+    std::vector<size_t> scopes;       //**< Where each open scope begins. */
+    Interner names;  //**< Interns names, if the tokens' were not. */
+    std::vector<Loop> loops;          //**< The enclosing loops. */
+
+    std::vector<Frame> frames;    //**< The expression nodes being generated. */
+    std::vector<Value> operands;  //**< The values of their operands. */
+
+    const Function* current;  //**< The function being generated. */
+    bool failed;              //**< True once an error has been reported. */
+  };
+
+}  // namespace excerpt
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace excerpt {
+
+  /**
+   * @brief Counts of what a CompileCache did.
+   */
+  struct CacheStats {
+    size_t hits = 0;      /**< Lookups that found an entry. */
+    size_t misses = 0;    /**< Lookups that found none. */
+    size_t stores = 0;    /**< Entries written. */
+    size_t evictions = 0; /**< Entries removed to bound the size. */
+  };
+
+  /**
+   * @brief A content-addressed cache of compiler outputs in a directory.
+   *
+   * Entries are named by a SHA-256 key of everything the output depends on,
+   * so an entry never goes stale: a changed input is a different key. An
+   * entry is written to a unique temporary file that is then renamed over
+   * its name, so processes and threads sharing the directory only ever see
+   * whole entries. A hit refreshes the entry's modification time, and
+   * `prune()` removes the least recently used entries beyond the size limit.
+   */
+  class CompileCache {
+   public:
+    /**
+     * @brief Constructs a CompileCache instance.
+     * @param directory The cache directory, created when first written to.
+     * @param max_bytes The size `prune()` bounds the entries to.
+     */
+    CompileCache(std::string directory, uint64_t max_bytes);
+
+    /**
+     * @brief Compute the key of a set of inputs.
+     * @param parts The inputs, i.e the compiler version, the options and the
+     * source. Each is hashed with its length, so parts are never confused
+     * by moving bytes between them.
+     * @return The key, as 64 hexadecimal digits.
+     */
+    static std::string key(std::initializer_list<std::string_view> parts);
+
+    /**
+     * @brief Find an entry, marking it as recently used.
+     * @param key The key of the entry.
+     * @return The contents of the entry, or nothing on a miss.
+     */
+    std::optional<std::string> lookup(const std::string& key);
+
+    /**
+     * @brief Write an entry, replacing any entry of the same key.
+     * @param key The key of the entry.
+     * @param contents The contents of the entry.
+     * @return True if the entry was written, otherwise false (after logging
+     * a warning); the cache is an optimization, so failing to write to it
+     * is not an error.
+     */
+    bool store(const std::string& key, std::string_view contents);
+
+    /**
+     * @brief Remove the least recently used entries until the entries fit
+     * in the size limit, along with temporary files abandoned by processes
+     * that stopped while writing.
+     */
+    void prune();
+
+    /**
+     * @brief Get the counts of what the cache did so far.
+     * @return The counts.
+     */
+    CacheStats stats() const;
+
+   private:
+    /**
+     * @brief Get the path of an entry.
+     */
+    std::string path_of(const std::string& key) const;
+
+    std::string directory;  //**< The cache directory. */
+    uint64_t max_bytes;     //**< The size bound of the entries. */
+
+    std::atomic<size_t> hits;       //**< Lookups that found an entry. */
+    std::atomic<size_t> misses;     //**< Lookups that found none. */
+    std::atomic<size_t> stores;     //**< Entries written. */
+    std::atomic<size_t> evictions;  //**< Entries removed by `prune()`. */
+  };
+
+}  // namespace excerpt
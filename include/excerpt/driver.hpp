@@ -0,0 +1,130 @@
+#pragma once
+
+#include "backend.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace llvm {
+  class LLVMContext;
+  class Module;
+}  // namespace llvm
+
+namespace excerpt {
+
+  class CompileCache;
+  class SourceBuffer;
+
+  /**
+   * @brief The options of a compilation.
+   */
+  struct DriverOptions {
+    unsigned jobs = 0; /**< The threads to use, 0 for one per core. */
+    OptLevel opt_level = OptLevel::O0; /**< The optimization level. */
+    bool time_passes = false; /**< Report the time each pass takes. */
+    bool emit_llvm = false;   /**< Write IR rather than objects. */
+    std::string output;       /**< The output path, for one input. */
+    std::string cache_dir;    /**< The cache directory, empty for none. */
+    uint64_t cache_size = uint64_t(1) << 30; /**< The cache size bound. */
+    bool cache_stats = false; /**< Report what the cache did. */
+    bool emit_tokens = false; /**< Write token files rather than objects. */
+  };
+
+  /**
+   * @brief Compiles source files, each through every phase in turn.
+   *
+   * Each file is lexed, parsed, lowered to IR, optimized and written as an
+   * object file beside it, with its extension replaced by `.o` (or `.ll`
+   * for IR), unless an output path is given. Standard input is written to
+   * standard output.
+   *
+   * A single input is compiled on the calling thread, lexed with every
+   * thread. Several are compiled at once on a work-stealing pool, one
+   * thread per file. Each file's diagnostics are then collected and written
+   * whole, in the order the files were given, as soon as every file before
+   * it has finished, so the output is the same however the work is spread.
+   *
+   * With `emit_tokens`, each file is only lexed, and its tokens are written
+   * as a token file (see TokenFile) with the extension `.tok`.
+   *
+   * With a cache directory, outputs are also stored in a CompileCache,
+   * keyed by the source and everything else they depend on, and a source
+   * compiled before is not compiled again: its output is copied from the
+   * cache.
+   *
+   * `execute()` instead runs the program the inputs make up in memory, on
+   * a Jit, without writing anything.
+   */
+  class Driver {
+   public:
+    /**
+     * @brief Constructs a Driver instance.
+     * @param options The options of the compilation.
+     */
+    explicit Driver(DriverOptions options);
+
+    ~Driver();
+
+    /**
+     * @brief Compile every input.
+     * @param inputs The paths of the source files, "-" for standard input.
+     * @return The number of inputs that failed to compile.
+     */
+    size_t run(const std::vector<std::string>& inputs);
+
+    /**
+     * @brief Compile one source file, reporting errors through the logger.
+     * @param path The path of the source file, "-" for standard input.
+     * @param threads The threads to lex it with, 0 for one per core.
+     * @return True if the file compiled.
+     */
+    bool compile(const std::string& path, unsigned threads);
+
+    /**
+     * @brief Run the program the inputs make up, compiling its functions
+     * in memory as they are first called.
+     * @param inputs The paths of the source files, "-" for standard input.
+     * @return The value the program's `main` returned, or nothing if the
+     * inputs failed to compile.
+     */
+    std::optional<int> execute(const std::vector<std::string>& inputs);
+
+   private:
+    /**
+     * @brief Compile several inputs at once, on a thread pool.
+     * @return The number of inputs that failed to compile.
+     */
+    size_t compile_parallel(const std::vector<std::string>& inputs);
+
+    /**
+     * @brief Lex, parse and generate the IR of a source file, reporting
+     * errors through the logger.
+     * @param source The source file.
+     * @param threads The threads to lex it with, 0 for one per core.
+     * @param context The context to create the module in.
+     * @return The module, or nullptr if the file does not compile.
+     */
+    std::unique_ptr<llvm::Module> generate(const SourceBuffer& source,
+                                           unsigned threads,
+                                           llvm::LLVMContext& context);
+
+    /**
+     * @brief Lex a source file and write its tokens as a token file.
+     * @return True if the file was written.
+     */
+    bool emit_tokens(const SourceBuffer& source, const std::string& output,
+                     unsigned threads);
+
+    /**
+     * @brief Get the path to write an input's output to.
+     */
+    std::string output_path(const std::string& path) const;
+
+    DriverOptions options;  //**< The options of the compilation. */
+    std::unique_ptr<CompileCache> cache;  //**< The cache, if enabled. */
+  };
+
+}  // namespace excerpt
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "interner.hpp"
+#include "token_buffer.hpp"
+
+#include <cstddef>
+#include <string_view>
+
+namespace excerpt {
+
+  /**
+   * @brief An edit of a source buffer: a range replaced by new text.
+   */
+  struct SourceEdit {
+    size_t offset;             /**< Where the edit begins. */
+    size_t removed;            /**< The number of bytes removed there. */
+    std::string_view inserted; /**< The text inserted in their place. */
+  };
+
+  /**
+   * @brief The tokens an incremental re-lex replaced.
+   */
+  struct RelexResult {
+    size_t first;    /**< The index of the first token replaced. */
+    size_t removed;  /**< The number of old tokens replaced. */
+    size_t inserted; /**< The number of new tokens in their place. */
+  };
+
+  /**
+   * @brief Update the tokens of a source buffer after it has been edited.
+   *
+   * Lexing is restarted at the last token the edit cannot have affected, and
+   * stops at the first position past the edit where the old tokens also
+   * ended: the lexer carries no state between tokens bar its position, so
+   * from there on the old tokens are still right, only shifted by the change
+   * in length. The work done is thereby proportional to the size of the edit
+   * and of the tokens around it, not to the size of the source, bar moving
+   * the tokens past the edit along in the buffer.
+   *
+   * @param tokens The tokens of the source before the edit, as from
+   * `tokenize_all()`, updated in place.
+   * @param source The source after the edit.
+   * @param edit The edit.
+   * @param interner The interner `tokens` was lexed with, if any.
+   * @return The range of tokens that was replaced.
+   */
+  RelexResult relex(TokenBuffer& tokens, std::string_view source,
+                    const SourceEdit& edit, Interner* interner = nullptr);
+
+}  // namespace excerpt
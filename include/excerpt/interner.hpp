@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+namespace excerpt {
+
+  /**
+   * @brief The dense id of an interned name.
+   */
+  using SymbolId = uint32_t;
+
+  /**
+   * @brief The id standing for no symbol, i.e on tokens other than names.
+   */
+  inline constexpr SymbolId NO_SYMBOL = std::numeric_limits<SymbolId>::max();
+
+  /**
+   * @brief Stores each distinct name once and maps it to a dense id.
+   *
+   * Names are appended to a single contiguous pool and found again through an
+   * open-addressing hash table, so interning a name already seen is one hash
+   * and one comparison, and later phases compare names by id alone. Ids are
+   * handed out in order of first occurrence, starting at 0.
+   *
+   * An interner is not thread-safe. Threads lexing at once each fill their own
+   * shard, whose names are interned into one as their tokens are merged (see
+   * `tokenize_parallel()`).
+   */
+  class Interner {
+   public:
+    /**
+     * @brief Intern a name.
+     * @param name The name.
+     * @return The id of the name, the same for every occurrence.
+     */
+    SymbolId intern(std::string_view name);
+
+    /**
+     * @brief Look up a name without interning it.
+     * @param name The name.
+     * @return The id of the name, or NO_SYMBOL if it was never interned.
+     */
+    SymbolId find(std::string_view name) const;
+
+    /**
+     * @brief Get the name of a symbol.
+     * @param id The id of the symbol.
+     * @return A view of the name, valid until the next name is interned.
+     */
+    std::string_view name(SymbolId id) const {
+      return std::string_view(pool.data() + starts[id],
+                              starts[id + 1] - starts[id]);
+    }
+
+    /**
+     * @brief Get the number of distinct names interned.
+     * @return The number of names.
+     */
+    size_t size() const { return starts.size() - 1; }
+
+   private:
+    /**
+     * @brief A slot of the hash table.
+     */
+    struct Slot {
+      uint32_t hash; /**< The low bits of the name's hash. */
+      SymbolId id;   /**< The name's id, or NO_SYMBOL if the slot is empty. */
+    };
+
+    /**
+     * @brief Find the slot of a name, or the empty slot it would go in.
+     * @return The index of the slot.
+     */
+    size_t probe(std::string_view name, uint32_t hash) const;
+
+    /**
+     * @brief Double the hash table and re-insert every name.
+     */
+    void grow();
+
+    std::vector<char> pool;  //**< The names, back to back. */
+    std::vector<uint32_t> starts{0};  //**< Name offsets, then the end. */
+    std::vector<Slot> table;  //**< The hash table, a power of two in size. */
+  };
+
+}  // namespace excerpt
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "backend.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace llvm {
+  class LLVMContext;
+  class Module;
+  class TargetMachine;
+
+  namespace orc {
+    class LLLazyJIT;
+  }  // namespace orc
+}  // namespace llvm
+
+namespace excerpt {
+
+  /**
+   * @brief Compiles modules in memory and runs them, one function at a time.
+   *
+   * Every function of an added module is replaced by a stub. The first call
+   * through the stub optimizes and compiles that function alone, then
+   * patches the stub to jump straight to it, so a program starts once
+   * `main` is compiled, and functions never called are never compiled.
+   * The price is that each function is optimized on its own: calls between
+   * functions are not inlined. Functions not defined by any module, such as
+   * `putchar`, are resolved in the running process.
+   */
+  class Jit {
+   public:
+    /**
+     * @brief Create a JIT for the host.
+     * @param level The optimization level each function is compiled at.
+     * @return The JIT, or nullptr (after logging an error) if the host is
+     * not supported.
+     */
+    static std::unique_ptr<Jit> create(OptLevel level);
+
+    ~Jit();
+
+    /**
+     * @brief Add a module, whose functions are compiled when first called.
+     * @param module The module.
+     * @param context The context the module was created in, which the JIT
+     * takes over.
+     * @return True if the module was added, otherwise false (after logging
+     * an error), i.e if it defines a function already defined.
+     */
+    bool add(std::unique_ptr<llvm::Module> module,
+             std::unique_ptr<llvm::LLVMContext> context);
+
+    /**
+     * @brief Find a function, without compiling it.
+     * @param name The name of the function.
+     * @return The address to call the function at, which compiles it on
+     * the first call, or 0 (after logging an error) if there is none.
+     */
+    uint64_t lookup(const std::string& name);
+
+    /**
+     * @brief Run the program's `int main()`.
+     * @return The value `main` returned, or nothing (after logging an error)
+     * if there is no `main` or a function it may call is defined nowhere.
+     */
+    std::optional<int> run_main();
+
+    /**
+     * @brief Get the number of functions compiled so far.
+     * @return The number of functions compiled.
+     */
+    size_t compiled_functions() const { return compiled; }
+
+   private:
+    Jit(std::unique_ptr<llvm::orc::LLLazyJIT> jit,
+        std::unique_ptr<llvm::TargetMachine> machine, OptLevel level);
+
+    std::unique_ptr<llvm::orc::LLLazyJIT> jit;  //**< The ORC JIT. */
+    std::unique_ptr<llvm::TargetMachine> machine;  //**< The cost model. */
+    OptLevel level;  //**< The optimization level. */
+    std::vector<std::string> externals;  //**< Functions defined elsewhere. */
+    size_t compiled;  //**< The functions compiled so far. */
+  };
+
+}  // namespace excerpt
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "token.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace excerpt {
+
+  /**
+   * @brief Character classes used by the lexer, as bit flags.
+   */
+  enum CharClass : uint8_t {
+    CHAR_SPACE = 1 << 0,       /**< Whitespace, as in the "C" locale. */
+    CHAR_DIGIT = 1 << 1,       /**< Decimal digits. */
+    CHAR_IDENT_START = 1 << 2, /**< Characters that may begin an identifier. */
+    CHAR_IDENT = 1 << 3,       /**< Characters that may continue one. */
+    CHAR_QUOTE = 1 << 4,       /**< The string literal delimiter. */
+    CHAR_OPERATOR = 1 << 5,    /**< Characters that may begin an operator. */
+  };
+
+  /**
+   * @brief An operator or punctuation spelling and its token type.
+   */
+  struct OperatorSpelling {
+    std::string_view spelling; /**< The characters of the operator. */
+    TokenType type;            /**< The type of the token it produces. */
+  };
+
+  /**
+   * @brief The operators and punctuation recognized by the lexer.
+   *
+   * Operators are matched by maximal munch, so supporting a new one (including
+   * multi-character operators such as `&&` or `->`) only takes a new entry.
+   */
+  inline constexpr OperatorSpelling OPERATORS[] = {
+      {"+", TokenType::PLUS},
+      {"-", TokenType::MINUS},
+      {"*", TokenType::STAR},
+      {"/", TokenType::SLASH},
+      {"%", TokenType::PERCENT},
+      {"(", TokenType::LPAREN},
+      {")", TokenType::RPAREN},
+      {"{", TokenType::LBRACE},
+      {"}", TokenType::RBRACE},
+      {"[", TokenType::LBRACKET},
+      {"]", TokenType::RBRACKET},
+      {";", TokenType::SEMICOLON},
+      {":", TokenType::COLON},
+      {",", TokenType::COMMA},
+      {".", TokenType::DOT},
+      {"=", TokenType::ASSIGN},
+      {"==", TokenType::EQUAL},
+      {"!=", TokenType::NOT_EQUAL},
+      {"<", TokenType::LESS},
+      {"<=", TokenType::LESS_EQUAL},
+      {">", TokenType::GREATER},
+      {">=", TokenType::GREATER_EQUAL}};
+
+  namespace detail {
+    constexpr std::array<uint8_t, 256> make_char_classes() {
+      std::array<uint8_t, 256> classes{};
+
+      for (unsigned char ch : std::string_view(" \t\n\v\f\r")) {
+        classes[ch] |= CHAR_SPACE;
+      }
+
+      for (int ch = 0; ch < 256; ch++) {
+        bool digit = ch >= '0' && ch <= '9';
+        bool alpha = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') ||
+                     ch == '_';
+
+        if (digit) classes[ch] |= CHAR_DIGIT | CHAR_IDENT;
+        if (alpha) classes[ch] |= CHAR_IDENT_START | CHAR_IDENT;
+      }
+
+      classes['"'] |= CHAR_QUOTE;
+
+      for (const auto& op : OPERATORS) {
+        classes[static_cast<unsigned char>(op.spelling[0])] |= CHAR_OPERATOR;
+      }
+
+      return classes;
+    }
+
+    constexpr size_t operator_chars() {
+      size_t count = 0;
+      for (const auto& op : OPERATORS) count += op.spelling.size();
+      return count;
+    }
+  }  // namespace detail
+
+  /**
+   * @brief The class flags of every byte value.
+   */
+  inline constexpr std::array<uint8_t, 256> CHAR_CLASSES =
+      detail::make_char_classes();
+
+  /**
+   * @brief Check whether a character belongs to any of the given classes.
+   * @param ch The character.
+   * @param classes The CharClass flags to test.
+   * @return True if the character has any of the flags.
+   */
+  constexpr bool has_class(char ch, uint8_t classes) {
+    return CHAR_CLASSES[static_cast<unsigned char>(ch)] & classes;
+  }
+
+  /**
+   * @brief The result of matching an operator.
+   */
+  struct OperatorMatch {
+    TokenType type; /**< The operator's type, or INVALID if none matched. */
+    size_t length;  /**< The number of characters matched, 0 if none. */
+  };
+
+  /**
+   * @brief A deterministic automaton recognizing the spellings in OPERATORS.
+   *
+   * The automaton is a trie over the operator spellings, built at compile time.
+   * Bytes are first mapped to a column of the (small) operator alphabet, so
+   * the transition table stays a few hundred bytes.
+   */
+  class OperatorDfa {
+   public:
+    /** The upper bound on states: the root plus one per spelled character. */
+    static constexpr size_t MAX_STATES = detail::operator_chars() + 1;
+
+    /** The length of the longest operator. */
+    static constexpr size_t MAX_LENGTH = [] {
+      size_t length = 0;
+      for (const auto& op : OPERATORS) {
+        if (op.spelling.size() > length) length = op.spelling.size();
+      }
+      return length;
+    }();
+
+    static_assert(MAX_STATES <= 256, "operator states must fit in a byte");
+
+    /**
+     * @brief Build the automaton from OPERATORS.
+     */
+    constexpr OperatorDfa() : columns{}, transitions{}, accepts{} {
+      uint8_t column_count = 1;
+      uint8_t state_count = 1;
+
+      for (auto& accept : accepts) accept = TokenType::INVALID;
+
+      for (const auto& op : OPERATORS) {
+        uint8_t state = 0;
+
+        for (unsigned char ch : op.spelling) {
+          if (columns[ch] == 0) columns[ch] = column_count++;
+
+          uint8_t& next = transitions[state][columns[ch]];
+          if (next == 0) next = state_count++;
+
+          state = next;
+        }
+
+        accepts[state] = op.type;
+      }
+    }
+
+    /**
+     * @brief Match the longest operator at the start of the input.
+     * @param input The characters to match against.
+     * @return The longest match, or {INVALID, 0} if no operator matches.
+     */
+    constexpr OperatorMatch match(std::string_view input) const {
+      OperatorMatch result{TokenType::INVALID, 0};
+      uint8_t state = 0;
+
+      for (size_t i = 0; i < input.size(); i++) {
+        unsigned char ch = input[i];
+
+        state = transitions[state][columns[ch]];
+        if (state == 0) break;
+
+        if (accepts[state] != TokenType::INVALID) {
+          result = {accepts[state], i + 1};
+        }
+      }
+
+      return result;
+    }
+
+   private:
+    std::array<uint8_t, 256>
+        columns; /**< The alphabet column of each byte, 0 if none. */
+    std::array<std::array<uint8_t, MAX_STATES>, MAX_STATES>
+        transitions; /**< Next state per state and column, 0 if none. */
+    std::array<TokenType, MAX_STATES>
+        accepts; /**< The token accepted in each state, INVALID if none. */
+  };
+
+  /**
+   * @brief The operator automaton used by the lexer.
+   */
+  inline constexpr OperatorDfa OPERATOR_DFA{};
+
+}  // namespace excerpt
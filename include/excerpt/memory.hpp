@@ -0,0 +1,151 @@
+#pragma once
+
+#include "excerpt_utils/timing.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace excerpt::memory {
+
+  /**
+   * @brief The parts of the compiler allocations are charged to.
+   */
+  enum Subsystem : uint8_t {
+    OTHER,     /**< Anything else, i.e the driver. */
+    TOKENIZER, /**< Lexing and token buffers. */
+    AST,       /**< Parsing and the AST. */
+    SYMBOLS,   /**< Interned names and the tables of names in scope. */
+    LLVM,      /**< IR, optimization and code generation. */
+    SUBSYSTEM_COUNT
+  };
+
+  /**
+   * @brief The names of the subsystems, as reported.
+   */
+  inline constexpr const char* SUBSYSTEM_NAMES[SUBSYSTEM_COUNT] = {
+      "other", "tokenizer", "ast", "symbols", "llvm"};
+
+  /**
+   * @brief What was allocated and freed in a phase or subsystem.
+   *
+   * Sizes are what the allocator handed out, which may exceed what was
+   * asked for.
+   */
+  struct Usage {
+    uint64_t allocations = 0; /**< Blocks allocated. */
+    uint64_t bytes = 0;       /**< Bytes allocated. */
+    uint64_t frees = 0;       /**< Blocks freed. */
+    uint64_t freed_bytes = 0; /**< Bytes freed. */
+    uint64_t peak = 0; /**< The most live bytes in the process it saw. */
+  };
+
+  /**
+   * @brief How full the arenas of a subsystem were when they released
+   * their blocks.
+   */
+  struct ArenaUsage {
+    uint64_t releases = 0; /**< Times an arena released its blocks. */
+    uint64_t used = 0;     /**< Bytes handed out from the blocks. */
+    uint64_t reserved = 0; /**< Bytes of the blocks. */
+  };
+
+  /**
+   * @brief Start tracking allocations, discarding anything tracked before.
+   *
+   * Every `operator new` and `operator delete` of the process is replaced
+   * by ones that count, when tracking, the allocation against the phase of
+   * the calling thread (see `timing::current_phase()`) and its subsystem
+   * (see Scope). When not tracking they only check a flag before calling
+   * `malloc()` or `free()`. Memory LLVM allocates with `malloc()` directly,
+   * i.e for small vectors, is not seen.
+   */
+  void start();
+
+  /**
+   * @brief Stop tracking allocations, keeping what was tracked.
+   */
+  void stop();
+
+  /**
+   * @brief Check if allocations are tracked.
+   * @return True between `start()` and `stop()`.
+   */
+  bool enabled();
+
+  /**
+   * @brief Get the bytes allocated and not yet freed since `start()`.
+   * @return The live bytes; blocks allocated before `start()` and freed
+   * since are subtracted, so it may be negative.
+   */
+  int64_t live();
+
+  /**
+   * @brief Get the most bytes that were live at once since `start()`.
+   * @return The peak live bytes.
+   */
+  uint64_t peak();
+
+  /**
+   * @brief Get the allocations made in each phase.
+   * @return The usage, indexed by timing::Phase, then outside any phase at
+   * index PHASE_COUNT.
+   */
+  std::array<Usage, timing::PHASE_COUNT + 1> phases();
+
+  /**
+   * @brief Get the allocations made by each subsystem.
+   * @return The usage, indexed by Subsystem.
+   */
+  std::array<Usage, SUBSYSTEM_COUNT> subsystems();
+
+  /**
+   * @brief Get how full the arenas of each subsystem were.
+   * @return The usage, indexed by Subsystem.
+   */
+  std::array<ArenaUsage, SUBSYSTEM_COUNT> arenas();
+
+  /**
+   * @brief Record an arena releasing its blocks. Called by Arena.
+   * @param subsystem The subsystem owning the arena.
+   * @param used The bytes handed out from the blocks.
+   * @param reserved The bytes of the blocks.
+   */
+  void arena_released(Subsystem subsystem, uint64_t used, uint64_t reserved);
+
+  /**
+   * @brief Format what was tracked as tables by phase and by subsystem.
+   * @return The report.
+   */
+  std::string report();
+
+  /**
+   * @brief Get the subsystem allocations of the calling thread are charged
+   * to.
+   * @return The subsystem of the innermost live Scope of the thread, or
+   * else the one the thread's phase works on.
+   */
+  Subsystem current_subsystem();
+
+  /**
+   * @brief Charges the allocations of the calling thread to a subsystem
+   * from its construction to its destruction.
+   */
+  class Scope {
+   public:
+    /**
+     * @brief Constructs a Scope instance.
+     * @param subsystem The subsystem to charge allocations to.
+     */
+    explicit Scope(Subsystem subsystem);
+
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    uint8_t outer;  //**< The subsystem of the enclosing scope. */
+  };
+
+}  // namespace excerpt::memory
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "token.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+namespace excerpt {
+
+  /**
+   * @brief Why a numeric literal could not be decoded.
+   */
+  enum class LiteralError : uint8_t {
+    NONE,          /**< The literal is valid. */
+    MALFORMED,     /**< I.e a missing digit or a stray letter. */
+    SEPARATOR,     /**< A `_` not between two digits. */
+    INVALID_DIGIT, /**< A digit beyond the base, i.e `9` in octal. */
+    TOO_LARGE,     /**< An integer beyond the range of int64_t. */
+    OUT_OF_RANGE   /**< A floating-point value beyond double's range. */
+  };
+
+  /**
+   * @brief A decoded numeric literal.
+   */
+  struct NumberLiteral {
+    TokenType type;    /**< INTEGER_LITERAL, FLOAT_LITERAL or INVALID. */
+    NumberValue value; /**< The value, if valid. */
+    LiteralError error = LiteralError::NONE; /**< Why it is invalid. */
+  };
+
+  /**
+   * @brief Decode the spelling of a numeric literal.
+   *
+   * Integers are decimal, hexadecimal (`0x1F`), binary (`0b101`) or, with
+   * a leading zero, octal (`017`), and must fit in an int64_t. A decimal
+   * literal with a fraction or an exponent (`1.5`, `2e-3`, `1.5E+10`) is a
+   * double. Digits may be separated by single underscores (`1_000_000`).
+   *
+   * @param spelling The literal, as lexed: a digit, then any letters,
+   * digits, underscores, dots followed by digits and exponent signs.
+   * @return The literal, with type INVALID and the error if it is not one.
+   */
+  NumberLiteral decode_number(std::string_view spelling);
+
+  /**
+   * @brief Describe why a numeric literal could not be decoded.
+   * @param error The error.
+   * @return The description, to follow the literal in a diagnostic.
+   */
+  const char* describe(LiteralError error);
+
+}  // namespace excerpt
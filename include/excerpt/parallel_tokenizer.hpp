@@ -0,0 +1,36 @@
+#pragma once
+
+#include "token_buffer.hpp"
+
+#include <cstddef>
+#include <string_view>
+
+namespace excerpt {
+
+  /**
+   * @brief Tokenize a whole source buffer on several threads.
+   *
+   * The source is split into one chunk per thread, each starting after a
+   * newline, and every chunk is lexed speculatively as if it began between
+   * tokens. A chunk that actually begins inside a block comment or string
+   * literal is repaired while merging: the end of the previous chunk is
+   * re-lexed serially until it reaches a position the speculative lexer also
+   * stopped at, from which point the two agree. The result is therefore
+   * identical to `Tokenizer(source).tokenize_all()`.
+   *
+   * When interning, each chunk interns into a shard of its own, and the
+   * shards are folded into `interner` while merging, in source order, so the
+   * symbols are also those a single Tokenizer would have produced.
+   *
+   * @param source The source to tokenize, which must outlive the tokens.
+   * @param threads The number of threads, or 0 for one per hardware thread.
+   * @param min_chunk_size The smallest chunk worth a thread, in bytes; fewer
+   * threads are used for sources too small to give each such a chunk.
+   * @param interner The interner to intern identifiers into, if any.
+   * @return The buffer of tokens.
+   */
+  TokenBuffer tokenize_parallel(std::string_view source, unsigned threads = 0,
+                                size_t min_chunk_size = 64 * 1024,
+                                Interner* interner = nullptr);
+
+}  // namespace excerpt
@@ -0,0 +1,277 @@
+#pragma once
+
+#include "ast.hpp"
+#include "source_manager.hpp"
+#include "token_buffer.hpp"
+#include "tokenizer.hpp"
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace excerpt {
+
+  /**
+   * @brief A token in the parser's lookahead window.
+   */
+  struct RingToken {
+    TokenType type;  /**< The type of the token. */
+    uint32_t index;  /**< The index of the token in the parser's buffer. */
+    uint32_t offset; /**< The source offset of the token. */
+    uint32_t length; /**< The spelling length of the token. */
+  };
+
+  /**
+   * @brief A parser building an Ast from source code.
+   *
+   * Tokens are pulled one at a time through a small fixed-size ring, which
+   * holds the few tokens of lookahead the grammar needs (telling a function
+   * from a declaration takes three), and are appended to a TokenBuffer that
+   * AST nodes refer to by index. Expressions are parsed by precedence
+   * climbing over explicit operator and operand stacks instead of recursion,
+   * so however deeply they nest they cannot overflow the call stack;
+   * statements nest recursively, up to `MAX_DEPTH`. The arms of an
+   * `else if` chain are parsed in a loop, so a chain is one level deep
+   * however long it is.
+   *
+   * The grammar:
+   *
+   *     program     := (function | declaration)* END
+   *     function    := type IDENTIFIER '(' (parameter (',' parameter)*)? ')'
+   *                    block
+   *     parameter   := type IDENTIFIER
+   *     declaration := type IDENTIFIER ('=' expression)? ';'
+   *     statement   := block | declaration | ';' | expression ';'
+   *                  | 'if' '(' expression ')' statement ('else' statement)?
+   *                  | 'while' '(' expression ')' statement
+   *                  | 'for' '(' (declaration | expression? ';') expression?
+   *                    ';' expression? ')' statement
+   *                  | 'return' expression? ';'
+   *                  | 'break' ';' | 'continue' ';'
+   *     block       := '{' statement* '}'
+   *     type        := 'int' | 'float' | 'char' | 'bool'
+   *
+   * Expressions are, from the loosest binding: `=` (right associative), then
+   * `==` `!=`, `<` `<=` `>` `>=`, `+` `-`, `*` `/` `%`, unary `+` `-`, and
+   * calls, over literals, names and parenthesized expressions.
+   */
+  class Parser {
+   public:
+    /** The deepest statements may nest. */
+    static constexpr size_t MAX_DEPTH = 256;
+
+    /** The size of the lookahead ring, a power of two. */
+    static constexpr size_t RING_SIZE = 4;
+
+    /**
+     * @brief Constructs a Parser instance, lexing the source as it parses.
+     * @param source The source to parse, which must outlive the parser.
+     * @param name The name of the source, used in diagnostics.
+     */
+    explicit Parser(std::string_view source, std::string name = "<string>");
+
+    /**
+     * @brief Constructs a Parser instance over already lexed tokens.
+     * @param source The source to parse, which must outlive the parser.
+     * @param tokens The tokens of the whole source, as from `tokenize_all()`.
+     * @param name The name of the source, used in diagnostics.
+     */
+    Parser(std::string_view source, TokenBuffer tokens,
+           std::string name = "<string>");
+
+    /**
+     * @brief Parse the whole source as a program.
+     * @return The PROGRAM node, or NO_NODE (after logging an error) if the
+     * source does not parse.
+     */
+    NodeId parse();
+
+    /**
+     * @brief Parse a single expression.
+     * @return The expression, or NO_NODE (after logging an error) if the
+     * source does not begin with one.
+     */
+    NodeId parse_expression();
+
+    /**
+     * @brief Get the tree built so far.
+     * @return The tree.
+     */
+    const Ast& ast() const { return _ast; }
+
+    /**
+     * @brief Get the tokens lexed so far, which nodes refer to by index.
+     * @return The tokens.
+     */
+    const TokenBuffer& tokens() const { return _tokens; }
+
+    /**
+     * @brief Get the spelling of a token.
+     * @param index The index of the token.
+     * @return A view of the token's characters in the source.
+     */
+    std::string_view spelling(uint32_t index) const {
+      return source.substr(_tokens.offsets[index], _tokens.lengths[index]);
+    }
+
+    /**
+     * @brief Render a subtree as an S-expression, i.e for tests.
+     * @param id The root of the subtree.
+     * @return The rendering, such as `(+ 1 (* x 2))`.
+     */
+    std::string dump(NodeId id) const;
+
+   private:
+    /**
+     * @brief A pending operator, group or call of the expression parser.
+     */
+    struct Frame {
+      enum Kind : uint8_t { UNARY, BINARY, GROUP, CALL };
+
+      Kind kind;           /**< The kind of the frame. */
+      TokenType op;        /**< The operator, for UNARY and BINARY. */
+      uint8_t precedence;  /**< The operator's precedence, 0 if none. */
+      uint32_t token;      /**< The index of the operator or parenthesis. */
+      size_t base;         /**< The operand stack size at a CALL's start. */
+    };
+
+    /**
+     * @brief An arm of an `if` / `else if` chain being parsed.
+     */
+    struct Arm {
+      uint32_t keyword; /**< The index of its `if`. */
+      NodeId condition; /**< The condition. */
+      NodeId then;      /**< The statement run if it holds. */
+    };
+
+    /**
+     * @brief Look ahead at a token without consuming it.
+     * @param offset The number of tokens to look past, below RING_SIZE.
+     * @return The token.
+     */
+    const RingToken& peek(size_t offset = 0);
+
+    /**
+     * @brief Consume the current token.
+     * @return The index of the consumed token.
+     */
+    uint32_t advance();
+
+    /**
+     * @brief Consume the current token if it has a given type.
+     * @return True if the token was consumed.
+     */
+    bool match(TokenType type);
+
+    /**
+     * @brief Consume a token of a given type, or report an error.
+     * @param type The expected type.
+     * @param context What the token is expected for, i.e "after expression".
+     * @return True if the token was consumed.
+     */
+    bool expect(TokenType type, const char* context);
+
+    /**
+     * @brief Lex the next token into the ring.
+     */
+    void fill();
+
+    /**
+     * @brief Report an error at the current token.
+     * @param message The error message.
+     * @return NO_NODE, for convenience.
+     */
+    NodeId error(const std::string& message);
+
+    /**
+     * @brief Describe the current token for a diagnostic.
+     * @return The description, i.e "'x'" or "end of file".
+     */
+    std::string found();
+
+    /**
+     * @brief Apply the pending operators that bind tighter than an operator.
+     * @param precedence The precedence of the operator.
+     * @param right True if the operator is right associative.
+     */
+    void reduce(uint8_t precedence, bool right);
+
+    /**
+     * @brief Build the call whose closing parenthesis was just consumed.
+     */
+    void finish_call();
+
+    /**
+     * @brief Parses a function definition.
+     * @return The FUNCTION node, or NO_NODE on error.
+     */
+    NodeId parse_function();
+
+    /**
+     * @brief Parses a variable declaration.
+     * @return The DECLARATION node, or NO_NODE on error.
+     */
+    NodeId parse_declaration();
+
+    /**
+     * @brief Parses a statement.
+     * @return The statement node, or NO_NODE on error.
+     */
+    NodeId parse_statement();
+
+    /**
+     * @brief Parses a block, from its opening brace.
+     * @return The BLOCK node, or NO_NODE on error.
+     */
+    NodeId parse_block();
+
+    /**
+     * @brief Parses an `if` statement.
+     * @return The IF node, or NO_NODE on error.
+     */
+    NodeId parse_if();
+
+    /**
+     * @brief Parses a `while` loop.
+     * @return The WHILE node, or NO_NODE on error.
+     */
+    NodeId parse_while();
+
+    /**
+     * @brief Parses a `for` loop.
+     * @return The FOR node, or NO_NODE on error.
+     */
+    NodeId parse_for();
+
+    /**
+     * @brief Parses a `return` statement.
+     * @return The RETURN node, or NO_NODE on error.
+     */
+    NodeId parse_return();
+
+    std::string_view source;  //**< The source being parsed. */
+    std::string name;         //**< The name of the source. */
+
+    Tokenizer tokenizer;  //**< Lexes tokens on demand. */
+    bool lexed;           //**< True if `_tokens` was lexed up front. */
+    SourceManager manager;  //**< Resolves positions for diagnostics. */
+
+    TokenBuffer _tokens;  //**< Every token pulled through the ring. */
+    Ast _ast;             //**< The tree being built. */
+
+    std::array<RingToken, RING_SIZE> ring;  //**< The lookahead tokens. */
+    size_t head;   //**< The ring slot of the current token. */
+    size_t count;  //**< The number of tokens in the ring. */
+    uint32_t next_token;  //**< The index of the next token to pull in. */
+
+    size_t depth;  //**< The nesting depth of the current statement. */
+    bool failed;   //**< True once an error has been reported. */
+
+    std::vector<NodeId> scratch;  //**< Children of the lists being built. */
+    std::vector<Arm> arms;        //**< The `else if` chains being built. */
+    std::vector<Frame> frames;    //**< The expression operator stack. */
+    std::vector<NodeId> operands;  //**< The expression operand stack. */
+  };
+
+}  // namespace excerpt
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+
+namespace excerpt::scan {
+
+  /**
+   * @brief The instruction sets scanning kernels are implemented for.
+   */
+  enum class Isa { SCALAR, SSE2, AVX2 };
+
+  /**
+   * @brief A scanning kernel.
+   *
+   * Scans forward from `begin` and returns a pointer to the first byte that
+   * stops the scan, or `end` if no byte in [begin, end) does.
+   */
+  using Scanner = const char* (*)(const char* begin, const char* end);
+
+  /**
+   * @brief A set of scanning kernels for one instruction set.
+   */
+  struct Kernels {
+    Scanner skip_space;       /**< Skips whitespace. */
+    Scanner skip_ident;       /**< Skips identifier characters. */
+    Scanner skip_digits;      /**< Skips decimal digits. */
+    Scanner find_newline;     /**< Finds a newline, i.e the end of `//`. */
+    Scanner find_comment_end; /**< Finds the star closing a block comment. */
+    Scanner find_string_end;  /**< Finds a quote, backslash or NUL. */
+
+    /** Counts the newlines in [begin, end). */
+    size_t (*count_newlines)(const char* begin, const char* end);
+  };
+
+  /**
+   * @brief Check whether the running CPU supports an instruction set.
+   * @param isa The instruction set.
+   * @return True if kernels for `isa` can run on this CPU.
+   */
+  bool supported(Isa isa);
+
+  /**
+   * @brief Get the kernels for an instruction set.
+   * @param isa The instruction set, which must be supported.
+   * @return The kernels.
+   */
+  const Kernels& kernels(Isa isa);
+
+  /**
+   * @brief Get the widest instruction set supported by the running CPU.
+   * @return The instruction set the dispatching functions below use.
+   */
+  Isa active_isa();
+
+  /**
+   * @brief Skip whitespace, using the active kernels.
+   * @return The first non-whitespace byte, or `end`.
+   */
+  const char* skip_space(const char* begin, const char* end);
+
+  /**
+   * @brief Skip identifier characters, using the active kernels.
+   * @return The first byte that cannot continue an identifier, or `end`.
+   */
+  const char* skip_ident(const char* begin, const char* end);
+
+  /**
+   * @brief Skip decimal digits, using the active kernels.
+   * @return The first non-digit byte, or `end`.
+   */
+  const char* skip_digits(const char* begin, const char* end);
+
+  /**
+   * @brief Find the next newline, using the active kernels.
+   * @return The first newline, or `end`.
+   */
+  const char* find_newline(const char* begin, const char* end);
+
+  /**
+   * @brief Find the end of a block comment, using the active kernels.
+   * @return The star of the first star-slash pair, or `end`.
+   */
+  const char* find_comment_end(const char* begin, const char* end);
+
+  /**
+   * @brief Find what ends a run of a string literal's characters, using the
+   * active kernels.
+   * @return The first quote, backslash or NUL byte, or `end`.
+   */
+  const char* find_string_end(const char* begin, const char* end);
+
+  /**
+   * @brief Count newlines, using the active kernels.
+   * @return The number of newlines in [begin, end).
+   */
+  size_t count_newlines(const char* begin, const char* end);
+
+}  // namespace excerpt::scan
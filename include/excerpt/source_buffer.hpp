@@ -0,0 +1,71 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace excerpt {
+
+  /**
+   * @brief An immutable buffer holding the contents of a source file.
+   *
+   * Regular files are memory-mapped read-only, so lexing runs directly over
+   * the page cache without copying the file. Standard input, pipes and other
+   * unmappable files are read into an owned buffer instead.
+   */
+  class SourceBuffer {
+   public:
+    /**
+     * @brief Open a source file.
+     * @param path The path of the file, or "-" for standard input.
+     * @return The buffer, or nullptr (after logging an error) on failure.
+     */
+    static std::shared_ptr<SourceBuffer> open(const std::string& path);
+
+    /**
+     * @brief Wrap an in-memory string, without copying it.
+     * @param text The source text, kept alive by the buffer.
+     * @param name The name of the buffer, used in diagnostics.
+     * @return The buffer.
+     */
+    static std::shared_ptr<SourceBuffer> from_string(
+        std::shared_ptr<const std::string> text,
+        const std::string& name = "<string>");
+
+    ~SourceBuffer();
+
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+    /**
+     * @brief Get the contents of the buffer.
+     * @return A view of the contents, valid for the buffer's lifetime.
+     */
+    std::string_view text() const { return std::string_view(data, size); }
+
+    /**
+     * @brief Get the name of the buffer, i.e its file path.
+     * @return The name of the buffer.
+     */
+    const std::string& name() const { return _name; }
+
+    /**
+     * @brief Check if the buffer is memory-mapped.
+     * @return True if the contents are mapped from a file.
+     */
+    bool mapped() const { return is_mapped; }
+
+   private:
+    explicit SourceBuffer(std::string name) : _name(std::move(name)) {}
+
+    std::string _name;  //**< The name of the buffer. */
+
+    const char* data = nullptr;  //**< The contents of the buffer. */
+    size_t size = 0;             //**< The size of the contents. */
+    bool is_mapped = false;      //**< True if `data` is a mapping. */
+
+    std::shared_ptr<const std::string>
+        owned;  //**< The contents, when they are not mapped. */
+  };
+
+}  // namespace excerpt
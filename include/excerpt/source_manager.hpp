@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace excerpt {
+
+  /**
+   * @brief A line and column position in a source buffer, both 1-based.
+   */
+  struct SourceLocation {
+    uint32_t line;   /**< The line number. */
+    uint32_t column; /**< The column number, in bytes. */
+  };
+
+  /**
+   * @brief Maps byte offsets in a source buffer to line/column positions.
+   *
+   * The lexer only records byte offsets; positions are needed for diagnostics
+   * alone, so the table of line start offsets is built on the first lookup
+   * and each lookup is a binary search into it. The source buffer must
+   * outlive the manager.
+   */
+  class SourceManager {
+   public:
+    /**
+     * @brief Constructs a SourceManager instance.
+     * @param source The source buffer offsets refer to.
+     */
+    explicit SourceManager(std::string_view source);
+
+    /**
+     * @brief Get the position of a byte offset.
+     * @param offset The byte offset, at most the size of the source.
+     * @return The line and column of the offset.
+     */
+    SourceLocation location(uint32_t offset) const;
+
+    /**
+     * @brief Get the offsets at which each line begins.
+     * @return The line start offsets, the first of which is always 0.
+     */
+    const std::vector<uint32_t>& line_starts() const;
+
+    /**
+     * @brief Build the line table now, splitting the work across threads.
+     *
+     * Each thread counts the newlines of one chunk of the source; a prefix
+     * sum of the counts then gives every chunk the index of its first line,
+     * so the chunks' line starts are filled in independently.
+     *
+     * @param threads The number of threads, or 0 for one per hardware thread.
+     */
+    void index_lines(unsigned threads) const;
+
+   private:
+    std::string_view source;  //**< The source buffer. */
+
+    mutable std::vector<uint32_t> starts;  //**< Line start offsets. */
+    mutable bool indexed;  //**< True once `starts` has been built. */
+  };
+
+}  // namespace excerpt
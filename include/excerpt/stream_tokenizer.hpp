@@ -0,0 +1,105 @@
+#pragma once
+
+#include "token.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace excerpt {
+
+  /**
+   * @brief A token produced by the StreamTokenizer.
+   */
+  struct StreamToken {
+    TokenType type;         /**< The type of the token. */
+    std::string_view value; /**< The value, valid until the next token. */
+
+    uint64_t offset; /**< The offset of the token in the input. */
+    uint32_t length; /**< The length of the token's spelling. */
+
+    uint32_t line;   /**< The line number. */
+    uint32_t column; /**< The column number. */
+
+    NumberValue number = {}; /**< The value of a numeric literal. */
+  };
+
+  /**
+   * @brief A tokenizer lexing an input stream through a sliding window.
+   *
+   * Only a fixed-size window of the input is held in memory. Whitespace and
+   * comments are discarded as they are skipped, however long; a token that
+   * does not fit in the window is re-lexed once the window has been refilled,
+   * or grown if the token is larger than the whole window. Memory is thereby
+   * bounded by the window size and the longest token, not the input size.
+   *
+   * The tokens produced are identical to those of Tokenizer::tokenize_all()
+   * over the whole input, with positions counted as the window slides.
+   */
+  class StreamTokenizer {
+   public:
+    /**
+     * @brief Constructs a StreamTokenizer instance.
+     * @param input The stream to tokenize, which must outlive the tokenizer.
+     * @param window_size The initial size of the window, in bytes.
+     */
+    explicit StreamTokenizer(std::istream& input,
+                             size_t window_size = 64 * 1024);
+
+    /**
+     * @brief Tokenize the next token of the input.
+     *
+     * Once the input is exhausted every call returns the END token.
+     *
+     * @return The token, whose value is invalidated by the next call.
+     */
+    StreamToken next();
+
+    /**
+     * @brief Get the current size of the window.
+     * @return The window size in bytes.
+     */
+    size_t window_size() const { return window.size(); }
+
+   private:
+    /**
+     * @brief Skip whitespace and comments from the consumed position.
+     * @return True when positioned at a token, false if more input is needed.
+     */
+    bool skip();
+
+    /**
+     * @brief Mark the window up to `target` as consumed, counting positions.
+     * @param target The window index to consume up to.
+     */
+    void consume(size_t target);
+
+    /**
+     * @brief Discard consumed input and read more, growing the window if it
+     * is already full.
+     */
+    void refill();
+
+    // The state of comment skipping, which may span several windows
+    enum class Skipping { CODE, LINE_COMMENT, BLOCK_COMMENT };
+
+    std::istream& input;  //**< The stream to tokenize. */
+    bool eof;             //**< True once the stream is exhausted. */
+
+    std::vector<char> window;  //**< The window over the input. */
+    size_t filled;             //**< The number of bytes in the window. */
+    size_t consumed;           //**< The number of bytes consumed. */
+    uint64_t base;  //**< The input offset of the start of the window. */
+
+    Skipping skipping;  //**< The comment, if any, being skipped. */
+    bool finished;      //**< True once the END token has been produced. */
+
+    uint32_t line;    //**< The line number at the consumed position. */
+    uint32_t column;  //**< The column number at the consumed position. */
+
+    std::string decoded;  //**< The value of the last escaped literal. */
+  };
+
+}  // namespace excerpt
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace excerpt {
+
+  /**
+   * @brief Why a string literal is invalid.
+   */
+  enum class StringError : uint8_t {
+    NONE,           /**< The literal is valid. */
+    UNTERMINATED,   /**< No closing quote before the end of the source. */
+    UNKNOWN_ESCAPE, /**< A backslash before a character with no escape. */
+    HEX_ESCAPE,     /**< `\x` not followed by two hexadecimal digits. */
+    UNICODE_ESCAPE  /**< A malformed `\u{...}`, or one naming no character. */
+  };
+
+  /**
+   * @brief An escape sequence of a string literal.
+   */
+  struct Escape {
+    size_t length;       /**< Its length, including the backslash. */
+    uint32_t code_point; /**< The character, or the byte of a `\xNN`. */
+    StringError error = StringError::NONE; /**< Why it is invalid. */
+  };
+
+  /**
+   * @brief Read the escape sequence at the start of a string.
+   *
+   * The escapes are `\n`, `\t`, `\r`, `\0`, `\\`, `\"`, `\xNN`, a byte of two
+   * hexadecimal digits, and `\u{N...}`, a Unicode code point of one to six.
+   *
+   * @param text The text from the backslash on.
+   * @return The escape. An invalid one spans its backslash and, unless it is
+   * the end of the text or a NUL, the character after it.
+   */
+  Escape read_escape(std::string_view text);
+
+  /**
+   * @brief Check a string literal, as lexed.
+   * @param spelling The literal, with its quotes.
+   * @return The first error in the literal, or NONE.
+   */
+  StringError check_string(std::string_view spelling);
+
+  /**
+   * @brief Get the value of a string literal, decoding its escapes.
+   *
+   * Literals without escapes, nearly all of them, are not copied.
+   *
+   * @param spelling The literal, with its quotes, which must be valid.
+   * @param storage Where the value is decoded to, if it has escapes.
+   * @return The value, viewing either `spelling` or `storage`.
+   */
+  std::string_view string_value(std::string_view spelling,
+                                std::string& storage);
+
+  /**
+   * @brief Describe why a string literal is invalid.
+   * @param error The error.
+   * @return The description, to follow "string literal" in a diagnostic.
+   */
+  const char* describe(StringError error);
+
+}  // namespace excerpt
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <string>
+#include <string_view>
 
 namespace excerpt {
-  enum class TokenType {
+  enum class TokenType : uint8_t {
     // Single-character tokens
     PLUS,       // +
     MINUS,      // -
@@ -105,23 +108,148 @@ namespace excerpt {
       {TokenType::END, "END"},
       {TokenType::INVALID, "INVALID"}};
 
+  /**
+   * @brief Look up the keyword an identifier spells, if any.
+   *
+   * Dispatches on the length and first character of the identifier, so at
+   * most two string comparisons are made.
+   *
+   * @param value The identifier.
+   * @return The keyword's token type, or IDENTIFIER if it is not a keyword.
+   */
+  constexpr TokenType keyword_type(std::string_view value) {
+    switch (value.size()) {
+      case 2:
+        if (value == "if") return TokenType::IF;
+        break;
+
+      case 3:
+        if (value == "for") return TokenType::FOR;
+        if (value == "int") return TokenType::INT;
+        break;
+
+      case 4:
+        switch (value[0]) {
+          case 'e':
+            if (value == "else") return TokenType::ELSE;
+            break;
+          case 't':
+            if (value == "true") return TokenType::TRUE;
+            break;
+          case 'c':
+            if (value == "char") return TokenType::CHAR;
+            break;
+          case 'b':
+            if (value == "bool") return TokenType::BOOL;
+            break;
+        }
+        break;
+
+      case 5:
+        switch (value[0]) {
+          case 'w':
+            if (value == "while") return TokenType::WHILE;
+            break;
+          case 'b':
+            if (value == "break") return TokenType::BREAK;
+            break;
+          case 'f':
+            if (value == "false") return TokenType::FALSE;
+            if (value == "float") return TokenType::FLOAT;
+            break;
+        }
+        break;
+
+      case 6:
+        if (value == "return") return TokenType::RETURN;
+        break;
+
+      case 8:
+        if (value == "continue") return TokenType::CONTINUE;
+        break;
+    }
+
+    return TokenType::IDENTIFIER;
+  }
+
+  /**
+   * @brief The value of a numeric literal, decoded once while lexing: an
+   * integer for INTEGER_LITERAL tokens and a double for FLOAT_LITERAL ones.
+   * Other tokens have no value, and hold zero.
+   */
+  union NumberValue {
+    int64_t integer; /**< The value of an integer literal. */
+    double real;     /**< The value of a floating-point literal. */
+  };
+
+  /**
+   * @brief Get the value of a token from its spelling in the source.
+   *
+   * The value of a string literal excludes its quotes, with any escapes as
+   * spelled (`string_value()` decodes them); the value of every other token
+   * is its spelling.
+   *
+   * @param type The type of the token.
+   * @param spelling The characters the token spans in the source.
+   * @return The value of the token.
+   */
+  constexpr std::string_view token_value(TokenType type,
+                                         std::string_view spelling) {
+    if (type == TokenType::STRING_LITERAL) {
+      return spelling.substr(1, spelling.size() - 2);
+    }
+
+    return spelling;
+  }
+
+  /**
+   * @brief A lexical token.
+   *
+   * Tokens do not own their text: `value` is a view into the source buffer the
+   * token was produced from, so that buffer must outlive the token. Literals
+   * whose value differs from their spelling (i.e after escape processing) keep
+   * the decoded text alive in `owned` instead.
+   */
   struct Token {
-    TokenType type;    /**< The type of the token. */
-    std::string value; /**< The value of the token. */
+    TokenType type;         /**< The type of the token. */
+    std::string_view value; /**< The value of the token. */
 
     int line;   /**< The line number. */
     int column; /**< The column number. */
 
+    std::shared_ptr<const std::string>
+        owned; /**< Storage backing `value` for decoded literals, if any. */
+
     /**
      * @brief Construct a new Token object.
      *
      * @param type The type of the token.
-     * @param value The value of the token.
-     * @param meta The meta value of the token, i.e line number, column number.
+     * @param value The value of the token, viewing the source buffer.
+     * @param line The line number.
+     * @param column The column number.
      */
-    Token(TokenType type, const std::string& value, int line, int column)
+    Token(TokenType type, std::string_view value, int line, int column)
         : type(type), value(value), line(line), column(column) {}
 
+    /**
+     * @brief Construct a Token whose value is owned rather than viewed.
+     *
+     * @param type The type of the token.
+     * @param value The decoded value of the token.
+     * @param line The line number.
+     * @param column The column number.
+     * @return The token, with `value` pointing into its own storage.
+     */
+    static Token decoded(TokenType type, std::string value, int line,
+                         int column) {
+      auto storage = std::make_shared<const std::string>(std::move(value));
+
+      Token token(type, *storage, line, column);
+      token.owned = std::move(storage);
+
+      return token;
+    }
+
     /**
      * @brief Get a string representation of the token.
      *
@@ -129,7 +257,7 @@ namespace excerpt {
      * @param value The value of the token.
      */
     std::string str() const {
-      return "Token(" + TOKEN_STR.at(type) + ", " + value +
+      return "Token(" + TOKEN_STR.at(type) + ", " + std::string(value) +
              ", Line: " + std::to_string(line) +
              ", Column: " + std::to_string(column) + ")";
     }
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "interner.hpp"
+#include "token.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace excerpt {
+
+  /**
+   * @brief A contiguous, struct-of-arrays buffer of tokens.
+   *
+   * Token `i` is described by `types[i]`, `offsets[i]` and `lengths[i]`; the
+   * offset and length locate its spelling within the source buffer it was
+   * lexed from, and `token_value()` recovers its value from that spelling.
+   * Line information is only needed for diagnostics, so it is not stored at
+   * all: a SourceManager recovers it from the offsets on demand.
+   *
+   * Numeric literals are decoded as they are lexed, into `values[i]`, so no
+   * later phase parses their spelling again.
+   *
+   * Tokens lexed with an Interner also carry `symbols[i]`, the interned name
+   * of each identifier; otherwise `symbols` is empty.
+   */
+  struct TokenBuffer {
+    std::vector<TokenType> types;    /**< The type of each token. */
+    std::vector<uint32_t> offsets;   /**< The source offset of each token. */
+    std::vector<uint32_t> lengths;   /**< The spelling length of each token. */
+    std::vector<NumberValue> values; /**< The value of each literal. */
+    std::vector<SymbolId> symbols;   /**< The name of each identifier. */
+
+    /**
+     * @brief Get the number of tokens in the buffer.
+     * @return The number of tokens.
+     */
+    size_t size() const { return types.size(); }
+
+    /**
+     * @brief Reserve room for a number of tokens.
+     * @param count The number of tokens to reserve room for.
+     */
+    void reserve(size_t count) {
+      types.reserve(count);
+      offsets.reserve(count);
+      lengths.reserve(count);
+      values.reserve(count);
+    }
+
+    /**
+     * @brief Append a token to the buffer.
+     *
+     * @param type The type of the token.
+     * @param offset The source offset of the token.
+     * @param length The spelling length of the token.
+     * @param value The value of the token, if a numeric literal.
+     */
+    void push(TokenType type, uint32_t offset, uint32_t length,
+              NumberValue value = {}) {
+      types.push_back(type);
+      offsets.push_back(offset);
+      lengths.push_back(length);
+      values.push_back(value);
+    }
+
+    /**
+     * @brief Append an interned token to the buffer.
+     *
+     * @param type The type of the token.
+     * @param offset The source offset of the token.
+     * @param length The spelling length of the token.
+     * @param symbol The interned name, or NO_SYMBOL if not an identifier.
+     * @param value The value of the token, if a numeric literal.
+     */
+    void push(TokenType type, uint32_t offset, uint32_t length,
+              SymbolId symbol, NumberValue value = {}) {
+      push(type, offset, length, value);
+      symbols.push_back(symbol);
+    }
+
+    /**
+     * @brief Append the tokens of another buffer, from a given token on.
+     * @param other The buffer to copy tokens from.
+     * @param first The index of the first token to copy.
+     */
+    void append(const TokenBuffer& other, size_t first) {
+      types.insert(types.end(), other.types.begin() + first, other.types.end());
+      offsets.insert(offsets.end(), other.offsets.begin() + first,
+                     other.offsets.end());
+      lengths.insert(lengths.end(), other.lengths.begin() + first,
+                     other.lengths.end());
+      values.insert(values.end(), other.values.begin() + first,
+                    other.values.end());
+
+      if (!other.symbols.empty()) {
+        symbols.insert(symbols.end(), other.symbols.begin() + first,
+                       other.symbols.end());
+      }
+    }
+
+    /**
+     * @brief Get the number of bytes the buffer has allocated.
+     * @return The allocated size in bytes.
+     */
+    size_t capacity_bytes() const {
+      return types.capacity() * sizeof(TokenType) +
+             offsets.capacity() * sizeof(uint32_t) +
+             lengths.capacity() * sizeof(uint32_t) +
+             values.capacity() * sizeof(NumberValue) +
+             symbols.capacity() * sizeof(SymbolId);
+    }
+  };
+
+}  // namespace excerpt
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "token.hpp"
+#include "token_buffer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace excerpt {
+
+  class SourceBuffer;
+
+  /**
+   * @brief The header of a token file.
+   *
+   * A token file is the header, then a TokenRecord per token, then the
+   * string table: the source text the tokens were lexed from, which their
+   * offsets and lengths index. Integers are little-endian.
+   */
+  struct TokenFileHeader {
+    char magic[4];         /**< "EXTK". */
+    uint16_t version;      /**< The format version, TOKEN_FILE_VERSION. */
+    uint16_t record_size;  /**< The size of a record, for skipping. */
+    uint32_t token_count;  /**< The number of records. */
+    uint32_t strings_size; /**< The size of the string table. */
+    uint64_t records;      /**< The file offset of the first record. */
+    uint64_t strings;      /**< The file offset of the string table. */
+  };
+
+  /**
+   * @brief The record of a token in a token file.
+   */
+  struct TokenRecord {
+    TokenType type;      /**< The type of the token. */
+    uint8_t reserved[3]; /**< Zero. */
+    uint32_t offset;     /**< The offset of the spelling in the strings. */
+    uint32_t length;     /**< The length of the spelling. */
+    uint32_t line;       /**< The 1-based line the token begins on. */
+  };
+
+  static_assert(sizeof(TokenFileHeader) == 32);
+  static_assert(sizeof(TokenRecord) == 16);
+
+  /**
+   * @brief The version of the token file format written, and the only one
+   * read. Changing the layout of a header or record means a new version.
+   */
+  inline constexpr uint16_t TOKEN_FILE_VERSION = 1;
+
+  /**
+   * @brief Serialize tokens into the token file format.
+   * @param tokens The tokens, i.e from `Tokenizer::tokenize_all()`.
+   * @param source The source the tokens were lexed from.
+   * @return The contents of the token file.
+   */
+  std::string write_token_file(const TokenBuffer& tokens,
+                               std::string_view source);
+
+  /**
+   * @brief A read-only view of a token file.
+   *
+   * Files are memory-mapped, and records are read in place, so opening a
+   * file of any size only checks it: nothing is copied or decoded.
+   */
+  class TokenFile {
+   public:
+    /**
+     * @brief A token of the file, as its record and its spelling.
+     */
+    struct TokenView {
+      TokenType type;         /**< The type of the token. */
+      uint32_t offset;        /**< The offset of the spelling. */
+      uint32_t line;          /**< The 1-based line of the token. */
+      std::string_view text;  /**< The spelling, in the string table. */
+    };
+
+    /**
+     * @brief Iterates over the tokens of a file, in source order.
+     */
+    class Iterator {
+     public:
+      using iterator_category = std::random_access_iterator_tag;
+      using value_type = TokenView;
+      using difference_type = std::ptrdiff_t;
+      using pointer = void;
+      using reference = TokenView;
+
+      Iterator(const TokenFile* file, size_t index)
+          : file(file), index(index) {}
+
+      TokenView operator*() const { return (*file)[index]; }
+
+      Iterator& operator++() {
+        index++;
+        return *this;
+      }
+
+      Iterator operator+(difference_type count) const {
+        return Iterator(file, index + count);
+      }
+
+      difference_type operator-(const Iterator& other) const {
+        return static_cast<difference_type>(index) -
+               static_cast<difference_type>(other.index);
+      }
+
+      bool operator==(const Iterator& other) const {
+        return index == other.index;
+      }
+
+     private:
+      const TokenFile* file;  //**< The file iterated over. */
+      size_t index;           //**< The index of the current token. */
+    };
+
+    /**
+     * @brief Open a token file.
+     * @param path The path of the file, or "-" for standard input.
+     * @return The file, or nullptr (after logging an error) if it cannot be
+     * read or is not a valid token file.
+     */
+    static std::unique_ptr<TokenFile> open(const std::string& path);
+
+    /**
+     * @brief View a token file already in memory.
+     * @param buffer The buffer holding the file.
+     * @return The file, or nullptr (after logging an error) if the buffer
+     * is not a valid token file.
+     */
+    static std::unique_ptr<TokenFile> from_buffer(
+        std::shared_ptr<const SourceBuffer> buffer);
+
+    /**
+     * @brief Get the number of tokens in the file.
+     * @return The number of tokens, including the END token.
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Get a token of the file.
+     * @param index The index of the token, less than `size()`.
+     * @return The token.
+     */
+    TokenView operator[](size_t index) const {
+      const TokenRecord& record = records[index];
+      return TokenView{record.type, record.offset, record.line,
+                   strings.substr(record.offset, record.length)};
+    }
+
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, count); }
+
+    /**
+     * @brief Get the string table, i.e the source the tokens were lexed
+     * from.
+     * @return A view of the string table, valid for the file's lifetime.
+     */
+    std::string_view text() const { return strings; }
+
+    /**
+     * @brief Copy the tokens into a buffer, as a Tokenizer would have
+     * produced them from `text()`.
+     * @return The buffer, without symbols, with the values of literals.
+     */
+    TokenBuffer tokens() const;
+
+   private:
+    explicit TokenFile(std::shared_ptr<const SourceBuffer> buffer)
+        : buffer(std::move(buffer)) {}
+
+    std::shared_ptr<const SourceBuffer> buffer;  //**< The file's contents. */
+
+    const TokenRecord* records = nullptr;  //**< The records, in place. */
+    size_t count = 0;          //**< The number of records. */
+    std::string_view strings;  //**< The string table. */
+  };
+
+}  // namespace excerpt
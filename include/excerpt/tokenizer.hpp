@@ -1,15 +1,29 @@
 #pragma once
 
+#include "interner.hpp"
+#include "scan.hpp"
+#include "source_buffer.hpp"
+#include "source_manager.hpp"
 #include "token.hpp"
+#include "token_buffer.hpp"
 
 #include <iostream>
-#include <functional>
-#include <sstream>
 #include <memory>
-#include <unordered_map>
+#include <optional>
+#include <string_view>
 
 namespace excerpt {
 
+  /**
+   * @brief The result of lexing a single token: its type and spelling.
+   */
+  struct Lexeme {
+    TokenType type;            /**< The type of the token. */
+    std::string_view spelling; /**< The token's characters in the source. */
+    SymbolId symbol = NO_SYMBOL; /**< The interned name of an identifier. */
+    NumberValue value = {};      /**< The value of a numeric literal. */
+  };
+
   /**
    * @brief A class for tokenizing a given input string.
    */
@@ -17,10 +31,34 @@ namespace excerpt {
    public:
     /**
      * @brief Constructs a Tokenizer instance.
+     *
+     * Tokens produced by the tokenizer view into `buffer`, which must be kept
+     * alive for as long as those tokens are in use.
+     *
+     * @param buffer The source buffer to tokenize.
+     */
+    explicit Tokenizer(std::shared_ptr<const SourceBuffer> buffer);
+
+    /**
+     * @brief Constructs a Tokenizer instance over an in-memory string.
+     *
+     * The string is tokenized in place, so it must not be modified while the
+     * tokenizer or its tokens are in use.
+     *
      * @param source The source string to tokenize.
      */
     explicit Tokenizer(std::shared_ptr<std::string> source);
 
+    /**
+     * @brief Constructs a Tokenizer instance over a borrowed view.
+     *
+     * Nothing keeps the viewed characters alive; they must outlive the
+     * tokenizer and its tokens.
+     *
+     * @param source The source string to tokenize.
+     */
+    explicit Tokenizer(std::string_view source);
+
     /**
      * @brief Peek at the next character without consuming it.
      * @param offset The offset to peek at. Defaults to 1.
@@ -47,49 +85,114 @@ namespace excerpt {
     char skipws();
 
     /**
-     * @brief Walk the tokenizer through until the predicate is false.
-     * @param predicate The predicate to match.
-     * @return The characters that matched the predicate.
+     * @brief Walk the tokenizer over the run of characters a scanner skips.
+     * @param scanner The scanning kernel, i.e `scan::skip_digits`.
+     * @return A view of the source characters that were skipped.
+     */
+    std::string_view walk(scan::Scanner scanner);
+
+    /**
+     * @brief Get the source manager resolving positions in the source.
+     * @return The source manager.
+     */
+    const SourceManager& source_manager() const { return manager; }
+
+    /**
+     * @brief Intern the names of identifiers as they are lexed.
+     *
+     * Once set, `parse_identifier()` fills in the symbol of each identifier
+     * and `tokenize_all()` records them in its buffer.
+     *
+     * @param interner The interner, or nullptr to stop interning.
      */
-    std::string walk(std::function<bool(char)> predicate);
+    void set_interner(Interner* interner) { this->interner = interner; }
+
+    /**
+     * @brief Get the current index in the source.
+     * @return The index of the next character to lex.
+     */
+    size_t position() const { return index; }
+
+    /**
+     * @brief Move the current index, i.e to resume lexing elsewhere.
+     * @param position The index to lex from, which must begin a token or lie
+     * between tokens.
+     */
+    void seek(size_t position);
+
+    /**
+     * @brief Lex the next token, skipping any whitespace and comments first.
+     * @return The lexeme of the token, END once the source is exhausted.
+     */
+    Lexeme lex();
+
+    /**
+     * @brief Tokenize the rest of the source into a contiguous buffer.
+     *
+     * The buffer always ends with a single END token. This is the preferred
+     * way to consume the tokenizer, as it performs no per-token allocation.
+     *
+     * @return The buffer of tokens.
+     */
+    TokenBuffer tokenize_all();
 
     /**
      * @brief Tokenize the next character.
+     *
+     * The first call tokenizes the whole source with `tokenize_all()`; each
+     * call then returns a view of the next token in that buffer, with its
+     * position resolved by the source manager. Once the source is exhausted
+     * every call returns the END token.
+     *
      * @return The tokenized character.
      */
     std::shared_ptr<Token> next();
 
     /**
-     * @brief Parses a string literal.
-     * @return The token representation of the literal.
+     * @brief Parses a string literal, checking its escapes.
+     * @return The lexeme of the literal, including the quotes, or an INVALID
+     * lexeme spanning it if it is unterminated or has an invalid escape.
      */
-    std::shared_ptr<Token> parse_string();
+    Lexeme parse_string();
 
     /**
-     * @brief Parses a number literal.
-     * @return The token representation of the literal.
+     * @brief Parses a number literal, decoding its value.
+     * @return The lexeme of the literal, or an INVALID lexeme spanning it
+     * if it cannot be decoded.
      */
-    std::shared_ptr<Token> parse_number();
+    Lexeme parse_number();
 
     /**
      * @brief Parses an identifier.
-     * @return The token representation of the identifier.
+     * @return The lexeme of the identifier.
      */
-    std::shared_ptr<Token> parse_identifier();
+    Lexeme parse_identifier();
 
     /**
      * @brief Parses a symbol.
-     * @return The token representation of the symbol.
+     * @return The lexeme of the symbol.
      */
-    std::shared_ptr<Token> parse_symbol();
+    Lexeme parse_symbol();
 
    private:
-    std::shared_ptr<std::string>
-        source;  //**< The source string to tokenize. */
+    /**
+     * @brief Get a view of the source from `start` up to the current index.
+     * @param start The index the view begins at.
+     * @return The viewed source characters.
+     */
+    std::string_view slice(size_t start) const;
+
+    std::shared_ptr<const SourceBuffer>
+        buffer;               //**< The buffer holding the source. */
+    std::string_view source;  //**< The source string to tokenize. */
 
     size_t index;  //**< The current index in the source string. */
-    int line;      //**< The current line number. */
-    int column;    //**< The current column number. */
+
+    SourceManager manager;  //**< Resolves token positions for `next()`. */
+    Interner* interner;     //**< Interns identifiers, if set. */
+
+    std::optional<TokenBuffer> tokens;  //**< The tokens viewed by `next()`. */
+    size_t cursor;  //**< The index of the next token returned by `next()`. */
   };
 
 }  // namespace excerpt
@@ -1,7 +1,14 @@
 #pragma once
 
+#include "excerpt_utils/logger.hpp"
+#include "excerpt_utils/opt_level.hpp"
+#include "excerpt_utils/timing.hpp"
 #include "llvm/Support/CommandLine.h"
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 namespace excerpt {
 
   /**
@@ -21,10 +28,28 @@ namespace excerpt {
     }
 
     /**
-     * @brief Get the input file name.
-     * @return The input file name specified on the command line.
+     * @brief Get the first input file name.
+     * @return The first input file name specified on the command line, or
+     * "-" for standard input if there are none.
      */
-    std::string input_file() const { return _input_file; }
+    std::string input_file() const {
+      return _input_files.empty() ? "-" : _input_files.front();
+    }
+
+    /**
+     * @brief Get the input file names, with response files (`@file`)
+     * expanded.
+     * @return The input file names, or "-" for standard input if there are
+     * none.
+     */
+    std::vector<std::string> input_files() const {
+      if (_input_files.empty()) {
+        return {"-"};
+      }
+
+      return std::vector<std::string>(_input_files.begin(),
+                                      _input_files.end());
+    }
 
     /**
      * @brief Get the output file name.
@@ -32,6 +57,93 @@ namespace excerpt {
      */
     std::string output_file() const { return _output_file; }
 
+    /**
+     * @brief Get the number of threads to use.
+     * @return The thread count, 0 for one per hardware thread.
+     */
+    unsigned jobs() const { return _jobs; }
+
+    /**
+     * @brief Get the lowest level of log messages to show.
+     * @return The log level specified on the command line.
+     */
+    logger::LogLevel log_level() const { return _log_level; }
+
+    /**
+     * @brief Get the optimization level.
+     * @return The level specified on the command line, `-O0` by default.
+     */
+    OptLevel opt_level() const { return _opt_level; }
+
+    /**
+     * @brief Check if the time each pass takes should be reported.
+     * @return True if `-ftime-passes` is specified, false otherwise.
+     */
+    bool time_passes() const { return _time_passes; }
+
+    /**
+     * @brief Check if IR should be written rather than object files.
+     * @return True if `-emit-llvm` is specified, false otherwise.
+     */
+    bool emit_llvm() const { return _emit_llvm; }
+
+    /**
+     * @brief Check if the time each phase takes should be reported.
+     * @return True if `--time-report` is specified, false otherwise.
+     */
+    bool time_report() const { return _time_report; }
+
+    /**
+     * @brief Get the format to report the time each phase takes in.
+     * @return The format specified on the command line, a table by default.
+     */
+    timing::ReportFormat time_report_format() const {
+      return _time_report_format;
+    }
+
+    /**
+     * @brief Get the file to write a trace of the phases to.
+     * @return The file name, or an empty string for no trace.
+     */
+    std::string time_trace() const { return _time_trace; }
+
+    /**
+     * @brief Check if allocations should be tracked and reported.
+     * @return True if `--mem-report` is specified, false otherwise.
+     */
+    bool mem_report() const { return _mem_report; }
+
+    /**
+     * @brief Check if token files should be written rather than object
+     * files.
+     * @return True if `--emit-tokens` is specified, false otherwise.
+     */
+    bool emit_tokens() const { return _emit_tokens; }
+
+    /**
+     * @brief Get the compilation cache directory.
+     * @return The directory, or an empty string if caching is disabled.
+     */
+    std::string cache_dir() const { return _cache_dir; }
+
+    /**
+     * @brief Get the size the compilation cache is bounded to.
+     * @return The size in bytes.
+     */
+    uint64_t cache_size() const { return _cache_size * 1024 * 1024; }
+
+    /**
+     * @brief Check if what the cache did should be reported.
+     * @return True if `--cache-stats` is specified, false otherwise.
+     */
+    bool cache_stats() const { return _cache_stats; }
+
+    /**
+     * @brief Check if the program should be run rather than compiled.
+     * @return True if `--run` is specified, false otherwise.
+     */
+    bool run() const { return _run; }
+
     /**
      * @brief Check if the help option is specified.
      * @return True if the help option is specified, false otherwise.
@@ -39,16 +151,96 @@ namespace excerpt {
     bool show_help() const { return help; }
 
    private:
-    // The input file name.
-    llvm::cl::opt<std::string> _input_file{
-        llvm::cl::Positional, llvm::cl::desc("Specify input filename"),
-        llvm::cl::value_desc("filename"), llvm::cl::init("-")};
+    // The input file names.
+    llvm::cl::list<std::string> _input_files{
+        llvm::cl::Positional, llvm::cl::desc("Specify input filenames"),
+        llvm::cl::value_desc("filenames")};
 
     // The output file name.
     llvm::cl::opt<std::string> _output_file{
         "output", llvm::cl::desc("Specify output filename"),
         llvm::cl::value_desc("filename")};
 
+    // The number of threads to use.
+    llvm::cl::opt<unsigned> _jobs{
+        "j", llvm::cl::desc("Number of threads to use, 0 for one per core"),
+        llvm::cl::value_desc("threads"), llvm::cl::init(0)};
+
+    // The lowest level of log messages to show.
+    llvm::cl::opt<logger::LogLevel> _log_level{
+        "log-level", llvm::cl::desc("Lowest level of log messages to show"),
+        llvm::cl::values(clEnumValN(logger::DEBUG, "debug", "Everything"),
+                         clEnumValN(logger::INFO, "info", "Progress"),
+                         clEnumValN(logger::WARNING, "warning", "Warnings"),
+                         clEnumValN(logger::ERROR, "error", "Errors only")),
+        llvm::cl::init(logger::COMPILED_LEVEL)};
+
+    // The optimization level.
+    llvm::cl::opt<OptLevel> _opt_level{
+        llvm::cl::desc("Optimization level"),
+        llvm::cl::values(
+            clEnumValN(OptLevel::O0, "O0", "No optimization (default)"),
+            clEnumValN(OptLevel::O1, "O1", "Cheap optimizations"),
+            clEnumValN(OptLevel::O2, "O2", "Most optimizations"),
+            clEnumValN(OptLevel::O3, "O3", "Aggressive optimizations"),
+            clEnumValN(OptLevel::Os, "Os", "Optimize for size")),
+        llvm::cl::init(OptLevel::O0)};
+
+    // True to report the time each pass takes.
+    llvm::cl::opt<bool> _time_passes{
+        "ftime-passes", llvm::cl::desc("Report the time each pass takes")};
+
+    // True to write IR rather than object files.
+    llvm::cl::opt<bool> _emit_llvm{
+        "emit-llvm", llvm::cl::desc("Write LLVM IR rather than object files")};
+
+    // True to write token files rather than object files.
+    llvm::cl::opt<bool> _emit_tokens{
+        "emit-tokens",
+        llvm::cl::desc("Write the tokens of each input as a binary file")};
+
+    // True to report the time each phase takes.
+    llvm::cl::opt<bool> _time_report{
+        "time-report",
+        llvm::cl::desc("Report the time, bytes and items of each phase")};
+
+    // The format to report the time each phase takes in.
+    llvm::cl::opt<timing::ReportFormat> _time_report_format{
+        "time-report-format", llvm::cl::desc("Format of the time report"),
+        llvm::cl::values(
+            clEnumValN(timing::ReportFormat::TABLE, "table", "A table"),
+            clEnumValN(timing::ReportFormat::JSON, "json", "JSON")),
+        llvm::cl::init(timing::ReportFormat::TABLE)};
+
+    // The file to write a Chrome trace of the phases to.
+    llvm::cl::opt<std::string> _time_trace{
+        "time-trace",
+        llvm::cl::desc("Write a Chrome trace of the phases to a file"),
+        llvm::cl::value_desc("filename")};
+
+    // True to track and report allocations.
+    llvm::cl::opt<bool> _mem_report{
+        "mem-report",
+        llvm::cl::desc("Report allocations and peak memory of each phase")};
+
+    // The compilation cache directory.
+    llvm::cl::opt<std::string> _cache_dir{
+        "cache-dir", llvm::cl::desc("Cache compiled outputs in a directory"),
+        llvm::cl::value_desc("directory")};
+
+    // The size the compilation cache is bounded to, in MiB.
+    llvm::cl::opt<uint64_t> _cache_size{
+        "cache-size", llvm::cl::desc("Size to bound the cache to, in MiB"),
+        llvm::cl::value_desc("MiB"), llvm::cl::init(1024)};
+
+    // True to report what the cache did.
+    llvm::cl::opt<bool> _cache_stats{
+        "cache-stats", llvm::cl::desc("Report cache hits and misses")};
+
+    // True to run the program in memory rather than write object files.
+    llvm::cl::opt<bool> _run{
+        "run", llvm::cl::desc("JIT-compile and run the program's main")};
+
     // True if the help flag is set, otherwise false.
     llvm::cl::opt<bool> help{llvm::cl::desc("Show help")};
   };
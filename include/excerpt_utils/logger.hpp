@@ -1,67 +1,597 @@
 #pragma once
 
-#include <iostream>
-#include <string>
+#include <unistd.h>
+
+#include "llvm/Support/FormatVariadic.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
 #include <ctime>
+#include <iostream>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// The lowest level logged at all, 0 for DEBUG to 3 for ERROR. Calls below
+// it compile to nothing. Defaults to INFO in release builds.
+#ifndef EXCERPT_LOG_LEVEL
+#ifdef NDEBUG
+#define EXCERPT_LOG_LEVEL 1
+#else
+#define EXCERPT_LOG_LEVEL 0
+#endif
+#endif
 
 namespace excerpt::logger {
 
   // Log levels
   enum LogLevel { DEBUG, INFO, WARNING, ERROR };
 
+  /**
+   * @brief The lowest level compiled in, set by `EXCERPT_LOG_LEVEL`.
+   */
+  inline constexpr LogLevel COMPILED_LEVEL =
+      static_cast<LogLevel>(EXCERPT_LOG_LEVEL);
+
+  /**
+   * @brief What logging does when the calling thread's ring is full.
+   */
+  enum class Overflow {
+    BLOCK, /**< Wait for the background thread to make room. */
+    DROP   /**< Discard the message, counting it in `dropped()`. */
+  };
+
+  namespace detail {
+    // Format a log line, with its timestamp, level and trailing newline
+    inline void format(std::string& record, LogLevel level,
+                       std::string_view message) {
+      // The timestamp only changes once a second, so each thread caches it
+      thread_local std::time_t cachedTime = -1;
+      thread_local char timestamp[20];
+
+      std::time_t currentTime = std::time(nullptr);
+      if (currentTime != cachedTime) {
+        std::tm localTime;
+        localtime_r(&currentTime, &localTime);
+        std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S",
+                      &localTime);
+        cachedTime = currentTime;
+      }
+
+      // Define log level string and color
+      const char* levelStr;
+      const char* color;
+
+      switch (level) {
+        case DEBUG:
+          levelStr = "DEBUG";
+          color = "\033[0;37m";  // White
+          break;
+        case INFO:
+          levelStr = "INFO";
+          color = "\033[0;32m";  // Green
+          break;
+        case WARNING:
+          levelStr = "WARNING";
+          color = "\033[0;33m";  // Yellow
+          break;
+        case ERROR:
+          levelStr = "ERROR";
+          color = "\033[0;31m";  // Red
+          break;
+        default:
+          levelStr = "UNKNOWN";
+          color = "\033[0m";  // Reset color
+          break;
+      }
+
+      record.clear();
+      record.append("[").append(timestamp).append("] ");
+      record.append(color).append(levelStr).append("\033[0m: ");
+      record.append(message).append("\n");
+    }
+
+    // The lowest level logged at run time
+    inline std::atomic<LogLevel> threshold{COMPILED_LEVEL};
+
+    // Where the calling thread's messages are collected, if anywhere
+    inline thread_local std::string* capture = nullptr;
+
+    class AsyncBackend;
+
+    // The running backend, if logging is asynchronous
+    inline std::atomic<AsyncBackend*> backend{nullptr};
+
+    /**
+     * @brief A single-producer, single-consumer ring of log records.
+     *
+     * Records are swapped in and out of the slots rather than copied, so once
+     * every slot has held a record of a given length, logging one no longer
+     * allocates.
+     */
+    class Ring {
+     public:
+      /**
+       * @brief Constructs a Ring instance.
+       * @param capacity The number of records, a power of two.
+       */
+      explicit Ring(size_t capacity) : slots(capacity), head(0), tail(0) {}
+
+      /**
+       * @brief Push a record, from the producing thread only.
+       * @param record The record, swapped with a consumed one on success.
+       * @return False if the ring is full.
+       */
+      bool push(std::string& record) {
+        size_t end = tail.load(std::memory_order_relaxed);
+
+        if (end - head.load(std::memory_order_acquire) == slots.size()) {
+          return false;
+        }
+
+        slots[end & (slots.size() - 1)].swap(record);
+        tail.store(end + 1, std::memory_order_release);
+        return true;
+      }
+
+      /**
+       * @brief Pass every record pushed so far to a function, from the
+       * consuming thread only.
+       * @param write The function to call with each record.
+       * @return The number of records consumed.
+       */
+      template <typename Write>
+      size_t drain(Write write) {
+        size_t begin = head.load(std::memory_order_relaxed);
+        size_t end = tail.load(std::memory_order_acquire);
+
+        for (size_t i = begin; i != end; i++) {
+          write(std::string_view(slots[i & (slots.size() - 1)]));
+        }
+
+        head.store(end, std::memory_order_release);
+        return end - begin;
+      }
+
+     private:
+      std::vector<std::string> slots;  //**< The records. */
+
+      alignas(64) std::atomic<size_t> head;  //**< The next to consume. */
+      alignas(64) std::atomic<size_t> tail;  //**< The next to fill. */
+    };
+
+    /**
+     * @brief A backend writing log records from a background thread.
+     *
+     * Each logging thread pushes formatted records into a ring of its own, so
+     * threads never wait on each other or on the output; one background thread
+     * drains every ring to standard output.
+     */
+    class AsyncBackend {
+     public:
+      /**
+       * @brief Constructs an AsyncBackend instance and starts its thread.
+       * @param ring_size The number of records each thread's ring holds.
+       * @param overflow What to do when a ring is full.
+       */
+      AsyncBackend(size_t ring_size, Overflow overflow)
+          : ring_size(ring_size),
+            overflow(overflow),
+            generation(next_generation()),
+            stopping(false),
+            requested(0),
+            completed(0),
+            starved(false),
+            dropped(0),
+            reported(0),
+            worker(&AsyncBackend::run, this) {}
+
+      /**
+       * @brief Writes every record still pending and stops the thread.
+       */
+      ~AsyncBackend() {
+        AsyncBackend* self = this;
+        backend.compare_exchange_strong(self, nullptr);
+
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          stopping = true;
+        }
+
+        wake.notify_all();
+        worker.join();
+      }
+
+      /**
+       * @brief Push a record from the calling thread.
+       * @param record The record, swapped with a consumed one.
+       */
+      void push(std::string& record) {
+        Ring& ring = local_ring();
+
+        while (!ring.push(record)) {
+          if (overflow == Overflow::DROP) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+          }
+
+          // The background thread may be asleep, with the ring full
+          starved.store(true, std::memory_order_relaxed);
+          wake.notify_one();
+          std::this_thread::yield();
+        }
+      }
+
+      /**
+       * @brief Wait until every record pushed so far has been written.
+       */
+      void flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        uint64_t target = ++requested;
+
+        wake.notify_all();
+        done.wait(lock, [&] { return completed >= target; });
+      }
+
+      /**
+       * @brief Get the number of records discarded because a ring was full.
+       * @return The number of dropped records.
+       */
+      size_t dropped_count() const {
+        return dropped.load(std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief Write pending records straight to standard output, from a
+       * signal handler. This is a best effort: it skips rings being
+       * registered and may race with the background thread.
+       */
+      void emergency_drain() {
+        std::unique_lock<std::mutex> lock(rings_mutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+          return;
+        }
+
+        for (auto& ring : rings) {
+          ring->drain([](std::string_view record) {
+            ssize_t ignored = ::write(STDOUT_FILENO, record.data(),
+                                      record.size());
+            (void)ignored;
+          });
+        }
+      }
+
+     private:
+      // Tells backends apart, as one may be allocated where another was
+      static uint64_t next_generation() {
+        static std::atomic<uint64_t> counter{0};
+        return ++counter;
+      }
+
+      // The calling thread's ring, registered on first use
+      Ring& local_ring() {
+        thread_local uint64_t owner = 0;
+        thread_local Ring* ring = nullptr;
+
+        if (owner != generation) {
+          auto created = std::make_unique<Ring>(ring_size);
+          ring = created.get();
+          owner = generation;
+
+          std::lock_guard<std::mutex> lock(rings_mutex);
+          rings.push_back(std::move(created));
+        }
+
+        return *ring;
+      }
+
+      // Write every pending record, returning how many there were
+      size_t drain() {
+        size_t count = 0;
+
+        std::lock_guard<std::mutex> lock(rings_mutex);
+        for (auto& ring : rings) {
+          count += ring->drain([](std::string_view record) {
+            std::cout.write(record.data(), record.size());
+          });
+        }
+
+        size_t lost = dropped.load(std::memory_order_relaxed);
+        if (lost != reported) {
+          std::string record;
+          format(record, WARNING,
+                 std::to_string(lost - reported) + " log messages dropped");
+          std::cout << record;
+          reported = lost;
+        }
+
+        return count;
+      }
+
+      // The background thread: drain, then sleep a little while idle
+      void run() {
+        while (true) {
+          uint64_t target;
+          bool stop;
+
+          {
+            std::unique_lock<std::mutex> lock(mutex);
+            target = requested;
+            stop = stopping;
+          }
+
+          while (drain() > 0) {
+          }
+
+          if (target > completed || stop) {
+            std::cout.flush();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            completed = target;
+            done.notify_all();
+          }
+
+          if (stop) {
+            return;
+          }
+
+          std::unique_lock<std::mutex> lock(mutex);
+          wake.wait_for(lock, std::chrono::milliseconds(1), [&] {
+            return stopping || requested > completed ||
+                   starved.load(std::memory_order_relaxed);
+          });
+          starved.store(false, std::memory_order_relaxed);
+        }
+      }
+
+      const size_t ring_size;     //**< The capacity of each ring. */
+      const Overflow overflow;    //**< What a full ring does. */
+      const uint64_t generation;  //**< Identifies this backend's rings. */
+
+      std::mutex rings_mutex;  //**< Guards `rings`. */
+      std::vector<std::unique_ptr<Ring>> rings;  //**< One per thread. */
+
+      std::mutex mutex;  //**< Guards the requests to the thread. */
+      std::condition_variable wake;  //**< Wakes the thread early. */
+      std::condition_variable done;  //**< Signals completed flushes. */
+      bool stopping;       //**< True once the backend is being destroyed. */
+      uint64_t requested;  //**< The number of flushes requested. */
+      uint64_t completed;  //**< The number of flushes completed. */
+
+      std::atomic<bool> starved;  //**< True if a producer waits for room. */
+      std::atomic<size_t> dropped;  //**< The records dropped so far. */
+      size_t reported;  //**< The dropped records already reported. */
+
+      std::thread worker;  //**< Drains the rings. */
+    };
+
+    // Owns the running backend, so it is flushed when the program exits
+    inline std::unique_ptr<AsyncBackend>& owned_backend() {
+      static std::unique_ptr<AsyncBackend> owned;
+      return owned;
+    }
+
+    // Writes what is left of the log before the program dies
+    inline void crash_handler(int signal) {
+      if (AsyncBackend* running = backend.load()) {
+        running->emergency_drain();
+      }
+
+      std::signal(signal, SIG_DFL);
+      std::raise(signal);
+    }
+  }  // namespace detail
+
+  /**
+   * @brief Write log messages from a background thread from now on.
+   *
+   * Logging then only formats the message and pushes it into a ring owned by
+   * the calling thread. Pending messages are written when `flush()` or
+   * `stop_async()` is called, when the program exits, and, as a best effort,
+   * when it crashes. Must not be called while other threads are logging.
+   *
+   * @param ring_size The number of messages each thread may have pending, a
+   * power of two.
+   * @param overflow What to do with a message when they are all pending.
+   */
+  inline void start_async(size_t ring_size = 1024,
+                          Overflow overflow = Overflow::BLOCK) {
+    auto& owned = detail::owned_backend();
+
+    detail::backend.store(nullptr);
+    owned = std::make_unique<detail::AsyncBackend>(ring_size, overflow);
+    detail::backend.store(owned.get());
+
+    for (int signal : {SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT}) {
+      std::signal(signal, detail::crash_handler);
+    }
+  }
+
+  /**
+   * @brief Write the pending messages and go back to logging synchronously.
+   *
+   * Must not be called while other threads are logging.
+   */
+  inline void stop_async() {
+    detail::backend.store(nullptr);
+    detail::owned_backend().reset();
+  }
+
+  /**
+   * @brief Wait until every message logged so far has been written.
+   */
+  inline void flush() {
+    if (detail::AsyncBackend* running = detail::backend.load()) {
+      running->flush();
+    } else {
+      std::cout.flush();
+    }
+  }
+
+  /**
+   * @brief Get the number of messages the asynchronous backend has dropped.
+   * @return The number of dropped messages, 0 if logging synchronously.
+   */
+  inline size_t dropped() {
+    detail::AsyncBackend* running = detail::backend.load();
+    return running ? running->dropped_count() : 0;
+  }
+
+  /**
+   * @brief Set the lowest level logged at run time.
+   *
+   * Levels below `COMPILED_LEVEL` stay disabled whatever the threshold.
+   *
+   * @param level The lowest level to log.
+   */
+  inline void set_level(LogLevel level) {
+    detail::threshold.store(level, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Check whether messages of a level are logged, i.e before
+   * gathering the details of an expensive trace.
+   * @param level The level.
+   * @return True if messages of the level are written.
+   */
+  inline bool enabled(LogLevel level) {
+    return level >= COMPILED_LEVEL &&
+           level >= detail::threshold.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Collects the calling thread's log messages while in scope,
+   * instead of writing them, i.e to keep one job's diagnostics together.
+   */
+  class Capture {
+   public:
+    /**
+     * @brief Start collecting messages.
+     * @param buffer The buffer to append the formatted messages to.
+     */
+    explicit Capture(std::string& buffer) : previous(detail::capture) {
+      detail::capture = &buffer;
+    }
+
+    /**
+     * @brief Go back to where messages were written before.
+     */
+    ~Capture() { detail::capture = previous; }
+
+    Capture(const Capture&) = delete;
+    Capture& operator=(const Capture&) = delete;
+
+   private:
+    std::string* previous;  //**< The enclosing capture's buffer, if any. */
+  };
+
   // Log function
   inline void log(LogLevel level, const std::string& message) {
-    // Use a mutex to ensure thread safety
-    static std::mutex mtx;
+    if (!enabled(level)) {
+      return;
+    }
+
+    thread_local std::string record;
+    detail::format(record, level, message);
 
-    // Get the current time
-    std::time_t currentTime = std::time(0);
-    std::tm* localTime = std::localtime(&currentTime);
-
-    // Format the timestamp
-    char timestamp[20];
-    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localTime);
-
-    // Define log level string and color
-    const char* levelStr;
-    const char* color;
-
-    switch (level) {
-      case DEBUG:
-        levelStr = "DEBUG";
-        color = "\033[0;37m";  // White
-        break;
-      case INFO:
-        levelStr = "INFO";
-        color = "\033[0;32m";  // Green
-        break;
-      case WARNING:
-        levelStr = "WARNING";
-        color = "\033[0;33m";  // Yellow
-        break;
-      case ERROR:
-        levelStr = "ERROR";
-        color = "\033[0;31m";  // Red
-        break;
-      default:
-        levelStr = "UNKNOWN";
-        color = "\033[0m";  // Reset color
-        break;
-    }
-
-    // Lock the mutex for thread safety
+    if (detail::capture) {
+      detail::capture->append(record);
+      return;
+    }
+
+    if (detail::AsyncBackend* running =
+            detail::backend.load(std::memory_order_acquire)) {
+      running->push(record);
+      return;
+    }
+
+    // Use a mutex to keep lines whole, and leave flushing to the stream
+    static std::mutex mtx;
     std::lock_guard<std::mutex> lock(mtx);
 
-    // Print the log message with timestamp and log level to the console
-    std::cout << "[" << timestamp << "] " << color << levelStr
-              << "\033[0m: " << message << std::endl;
+    std::cout << record;
+  }
+
+  /**
+   * @brief Log a message formatted from arguments, as by `llvm::formatv`.
+   *
+   * The arguments are only formatted if the message is logged. Without
+   * any, the message is logged as it is, braces and all.
+   *
+   * @param level The level of the message.
+   * @param format The format string, i.e "{0} tokens in {1}".
+   * @param args The arguments to format.
+   */
+  template <typename... Args>
+  void log(LogLevel level, const char* format, Args&&... args) {
+    if (!enabled(level)) {
+      return;
+    }
+
+    if constexpr (sizeof...(Args) == 0) {
+      log(level, std::string(format));
+    } else {
+      log(level, llvm::formatv(format, std::forward<Args>(args)...).str());
+    }
+  }
+
+  // Convenience functions for specific log levels, which compile to nothing
+  // below `COMPILED_LEVEL`
+  template <typename... Args>
+  void debug(const char* format, Args&&... args) {
+    if constexpr (DEBUG >= COMPILED_LEVEL) {
+      log(DEBUG, format, std::forward<Args>(args)...);
+    }
+  }
+
+  template <typename... Args>
+  void info(const char* format, Args&&... args) {
+    if constexpr (INFO >= COMPILED_LEVEL) {
+      log(INFO, format, std::forward<Args>(args)...);
+    }
+  }
+
+  template <typename... Args>
+  void warn(const char* format, Args&&... args) {
+    if constexpr (WARNING >= COMPILED_LEVEL) {
+      log(WARNING, format, std::forward<Args>(args)...);
+    }
+  }
+
+  template <typename... Args>
+  void error(const char* format, Args&&... args) {
+    if constexpr (ERROR >= COMPILED_LEVEL) {
+      log(ERROR, format, std::forward<Args>(args)...);
+    }
   }
 
-  // Convenience functions for specific log levels
-  inline void debug(const std::string& message) { log(DEBUG, message); }
-  inline void info(const std::string& message) { log(INFO, message); }
-  inline void warn(const std::string& message) { log(WARNING, message); }
-  inline void error(const std::string& message) { log(ERROR, message); }
+  inline void debug(const std::string& message) {
+    if constexpr (DEBUG >= COMPILED_LEVEL) {
+      log(DEBUG, message);
+    }
+  }
+
+  inline void info(const std::string& message) {
+    if constexpr (INFO >= COMPILED_LEVEL) {
+      log(INFO, message);
+    }
+  }
+
+  inline void warn(const std::string& message) {
+    if constexpr (WARNING >= COMPILED_LEVEL) {
+      log(WARNING, message);
+    }
+  }
+
+  inline void error(const std::string& message) {
+    if constexpr (ERROR >= COMPILED_LEVEL) {
+      log(ERROR, message);
+    }
+  }
 
 }  // namespace excerpt::logger
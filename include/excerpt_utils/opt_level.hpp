@@ -0,0 +1,10 @@
+#pragma once
+
+namespace excerpt {
+
+  /**
+   * @brief The optimization levels, as `-O0` to `-O3` and `-Os`.
+   */
+  enum class OptLevel { O0, O1, O2, O3, Os };
+
+}  // namespace excerpt
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "timing.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace excerpt::parallel {
+
+  /**
+   * @brief Resolve a requested thread count.
+   * @param threads The requested count, or 0 for one per hardware thread.
+   * @return The number of threads to use, at least 1.
+   */
+  inline unsigned thread_count(unsigned threads) {
+    if (threads == 0) {
+      threads = std::thread::hardware_concurrency();
+    }
+
+    return std::max(threads, 1u);
+  }
+
+  /**
+   * @brief Call a function for each index in [0, count), one thread each.
+   *
+   * Index 0 runs on the calling thread, and the call returns once every
+   * index has finished. The other threads run in the caller's phase (see
+   * `timing::current_phase()`), so what they do is charged to it.
+   *
+   * @param count The number of indices.
+   * @param function The function to call with each index.
+   */
+  template <typename Function>
+  void for_each_index(size_t count, Function function) {
+    std::vector<std::thread> workers;
+    workers.reserve(count > 0 ? count - 1 : 0);
+
+    timing::Phase phase = timing::current_phase();
+
+    for (size_t i = 1; i < count; i++) {
+      workers.emplace_back([function, phase, i]() mutable {
+        timing::enter_phase(phase);
+        function(i);
+      });
+    }
+
+    if (count > 0) {
+      function(size_t{0});
+    }
+
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+}  // namespace excerpt::parallel
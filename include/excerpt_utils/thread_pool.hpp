@@ -0,0 +1,198 @@
+#pragma once
+
+#include "excerpt_utils/parallel.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace excerpt::parallel {
+
+  /**
+   * @brief A fixed set of worker threads running tasks, with work stealing.
+   *
+   * Every worker has a queue of its own. Tasks submitted by a worker go on
+   * its own queue, which it runs newest first; others are dealt round-robin.
+   * A worker whose queue is empty steals the oldest task of another's, so
+   * uneven tasks, such as source files of very different sizes, keep every
+   * worker busy until the last few.
+   */
+  class ThreadPool {
+   public:
+    /** A task. */
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Constructs a ThreadPool instance and starts its workers.
+     * @param threads The number of workers, or 0 for one per hardware thread.
+     */
+    explicit ThreadPool(unsigned threads = 0)
+        : queued(0), pending(0), stopping(false), next_queue(0) {
+      unsigned count = thread_count(threads);
+
+      for (unsigned i = 0; i < count; i++) {
+        queues.push_back(std::make_unique<Queue>());
+      }
+
+      for (unsigned i = 0; i < count; i++) {
+        workers.emplace_back(&ThreadPool::run, this, i);
+      }
+    }
+
+    /**
+     * @brief Waits for every task, then stops the workers.
+     */
+    ~ThreadPool() {
+      wait();
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+      }
+
+      wake.notify_all();
+
+      for (auto& worker : workers) {
+        worker.join();
+      }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Get the number of workers.
+     * @return The number of workers.
+     */
+    unsigned size() const { return workers.size(); }
+
+    /**
+     * @brief Queue a task, which may itself submit more.
+     * @param task The task.
+     */
+    void submit(Task task) {
+      size_t index = current_pool() == this
+                         ? current_worker()
+                         : next_queue++ % queues.size();
+
+      {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued++;
+        pending++;
+      }
+
+      wake.notify_one();
+    }
+
+    /**
+     * @brief Wait until every task submitted so far, and every task those
+     * submitted, has finished. Must not be called from a task.
+     */
+    void wait() {
+      std::unique_lock<std::mutex> lock(mutex);
+      idle.wait(lock, [&] { return pending == 0; });
+    }
+
+   private:
+    /**
+     * @brief A worker's queue of tasks.
+     */
+    struct Queue {
+      std::mutex mutex;       /**< Guards `tasks`. */
+      std::deque<Task> tasks; /**< The tasks, oldest first. */
+    };
+
+    // The pool the calling thread works for, if any
+    static ThreadPool*& current_pool() {
+      thread_local ThreadPool* pool = nullptr;
+      return pool;
+    }
+
+    // The index of the calling worker in its pool
+    static size_t& current_worker() {
+      thread_local size_t index = 0;
+      return index;
+    }
+
+    // Take a task from a worker's own queue, or else steal one
+    bool take(size_t self, Task& task) {
+      for (size_t i = 0; i < queues.size(); i++) {
+        Queue& queue = *queues[(self + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.tasks.empty()) {
+          continue;
+        }
+
+        // Run its own newest task, whose data is likely still in cache, but
+        // steal the oldest, which likely has the most work behind it
+        if (i == 0) {
+          task = std::move(queue.tasks.back());
+          queue.tasks.pop_back();
+        } else {
+          task = std::move(queue.tasks.front());
+          queue.tasks.pop_front();
+        }
+
+        return true;
+      }
+
+      return false;
+    }
+
+    // A worker: run tasks until the pool stops
+    void run(size_t self) {
+      current_pool() = this;
+      current_worker() = self;
+
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          wake.wait(lock, [&] { return stopping || queued > 0; });
+
+          if (queued == 0) {
+            return;
+          }
+
+          // Claim a task, which is then in some queue until taken
+          queued--;
+        }
+
+        Task task;
+        while (!take(self, task)) {
+          std::this_thread::yield();
+        }
+
+        task();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) {
+          idle.notify_all();
+        }
+      }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;  //**< One per worker. */
+    std::vector<std::thread> workers;  //**< The worker threads. */
+
+    std::mutex mutex;  //**< Guards the counts below. */
+    std::condition_variable wake;  //**< Signals queued tasks. */
+    std::condition_variable idle;  //**< Signals that no task is pending. */
+    size_t queued;   //**< The tasks in queues and not yet claimed. */
+    size_t pending;  //**< The tasks submitted and not yet finished. */
+    bool stopping;   //**< True once the pool is being destroyed. */
+
+    std::atomic<size_t> next_queue;  //**< The next queue to deal to. */
+  };
+
+}  // namespace excerpt::parallel
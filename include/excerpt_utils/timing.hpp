@@ -0,0 +1,369 @@
+#pragma once
+
+#include <time.h>
+
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace excerpt::timing {
+
+  /**
+   * @brief The phases of a compilation. Semantic checks are made while
+   * generating IR, so they are part of IRGEN.
+   */
+  enum Phase : uint8_t {
+    READ,      /**< Opening or reading the source. */
+    CACHE,     /**< Looking the output up in the cache. */
+    LEX,       /**< Lexing, with tokens as items. */
+    PARSE,     /**< Parsing, with AST nodes as items. */
+    IRGEN,     /**< Generating IR, with instructions as items. */
+    OPTIMIZE,  /**< Running the optimization pipeline. */
+    EMIT,      /**< Generating machine code, or printing IR. */
+    WRITE,     /**< Writing the output. */
+    PHASE_COUNT
+  };
+
+  /**
+   * @brief The names of the phases, as reported.
+   */
+  inline constexpr const char* PHASE_NAMES[PHASE_COUNT] = {
+      "read", "cache", "lex", "parse", "irgen", "optimize", "emit", "write"};
+
+  /**
+   * @brief The formats a report of the phases can be written in.
+   */
+  enum class ReportFormat {
+    TABLE, /**< A table for people to read. */
+    JSON   /**< JSON, for tools; see `json()`. */
+  };
+
+  /**
+   * @brief What the timers of a phase recorded, summed over every run of
+   * the phase on every thread.
+   */
+  struct PhaseStats {
+    uint64_t wall_ns = 0; /**< Wall time, in nanoseconds. */
+    uint64_t cpu_ns = 0;  /**< CPU time of the timing threads. */
+    uint64_t bytes = 0;   /**< Bytes processed. */
+    uint64_t items = 0;   /**< Items processed, i.e tokens when lexing. */
+    uint64_t runs = 0;    /**< Times the phase ran. */
+  };
+
+  namespace detail {
+    using Clock = std::chrono::steady_clock;
+
+    // One run of a phase, kept for the trace
+    struct Event {
+      Phase phase;
+      uint32_t thread;
+      uint64_t start_ns;
+      uint64_t wall_ns;
+      uint64_t bytes;
+      uint64_t items;
+      std::string detail;
+    };
+
+    struct State {
+      std::atomic<bool> enabled{false};
+      bool tracing = false;
+      Clock::time_point origin;
+
+      std::mutex mutex;  // Guards everything below
+      std::array<PhaseStats, PHASE_COUNT> phases;
+      std::vector<Event> events;
+      std::unordered_map<std::thread::id, uint32_t> threads;
+    };
+
+    inline State& state() {
+      static State instance;
+      return instance;
+    }
+
+    // The phase the calling thread is in, PHASE_COUNT outside any
+    inline thread_local Phase current = PHASE_COUNT;
+
+    // The CPU time the calling thread has used
+    inline uint64_t thread_cpu_ns() {
+      timespec time;
+      clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+      return time.tv_sec * 1000000000ull + time.tv_nsec;
+    }
+  }  // namespace detail
+
+  /**
+   * @brief Start recording, discarding anything recorded before.
+   * @param trace True to also keep every run of every phase, for
+   * `chrome_trace()`.
+   */
+  inline void start(bool trace = false) {
+    detail::State& state = detail::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    state.tracing = trace;
+    state.origin = detail::Clock::now();
+    state.phases = {};
+    state.events.clear();
+    state.threads.clear();
+    state.enabled.store(true, std::memory_order_release);
+  }
+
+  /**
+   * @brief Stop recording, keeping what was recorded.
+   */
+  inline void stop() {
+    detail::state().enabled.store(false, std::memory_order_release);
+  }
+
+  /**
+   * @brief Check if timers are recording.
+   * @return True between `start()` and `stop()`.
+   */
+  inline bool enabled() {
+    return detail::state().enabled.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the phase the calling thread is in.
+   * @return The phase of the innermost live ScopedTimer of the thread, or
+   * PHASE_COUNT outside any, whether or not timers are recording.
+   */
+  inline Phase current_phase() { return detail::current; }
+
+  /**
+   * @brief Put the calling thread in a phase without timing it, i.e a
+   * worker thread carrying on the phase of the thread that started it.
+   * @param phase The phase, or PHASE_COUNT for none.
+   */
+  inline void enter_phase(Phase phase) { detail::current = phase; }
+
+  /**
+   * @brief Times a phase from its construction to its destruction.
+   *
+   * When recording is off, constructing one reads a flag and notes the
+   * thread's phase, for `current_phase()`, and nothing else, so timers may
+   * stay in the compiler permanently.
+   */
+  class ScopedTimer {
+   public:
+    /**
+     * @brief Constructs a ScopedTimer instance and starts timing.
+     * @param phase The phase being timed.
+     * @param detail What the phase is working on, i.e a file name, shown
+     * in the trace. It must outlive the timer.
+     */
+    explicit ScopedTimer(Phase phase, std::string_view detail = {})
+        : phase(phase),
+          outer(std::exchange(detail::current, phase)),
+          active(enabled()),
+          bytes(0),
+          items(0) {
+      if (active) {
+        this->detail = detail;
+        wall_start = detail::Clock::now();
+        cpu_start = detail::thread_cpu_ns();
+      }
+    }
+
+    ~ScopedTimer() {
+      detail::current = outer;
+
+      if (!active) {
+        return;
+      }
+
+      uint64_t cpu = detail::thread_cpu_ns() - cpu_start;
+      auto end = detail::Clock::now();
+
+      detail::State& state = detail::state();
+      std::lock_guard<std::mutex> lock(state.mutex);
+
+      auto nanoseconds = [](detail::Clock::duration duration) {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+                .count());
+      };
+      uint64_t wall = nanoseconds(end - wall_start);
+
+      PhaseStats& stats = state.phases[phase];
+      stats.wall_ns += wall;
+      stats.cpu_ns += cpu;
+      stats.bytes += bytes;
+      stats.items += items;
+      stats.runs++;
+
+      if (state.tracing) {
+        auto [it, added] = state.threads.emplace(std::this_thread::get_id(),
+                                                 state.threads.size());
+        state.events.push_back(
+            detail::Event{phase, it->second,
+                          nanoseconds(wall_start - state.origin), wall, bytes,
+                          items, std::string(detail)});
+      }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    /**
+     * @brief Count work done in the phase.
+     * @param bytes The bytes processed.
+     * @param items The items processed, i.e tokens when lexing.
+     */
+    void count(uint64_t bytes, uint64_t items = 0) {
+      this->bytes += bytes;
+      this->items += items;
+    }
+
+   private:
+    Phase phase;  //**< The phase being timed. */
+    Phase outer;  //**< The phase the thread was in before. */
+    bool active;  //**< True if recording was on at construction. */
+    uint64_t bytes;  //**< The bytes processed. */
+    uint64_t items;  //**< The items processed. */
+    std::string_view detail;  //**< What the phase is working on. */
+    detail::Clock::time_point wall_start;  //**< When timing started. */
+    uint64_t cpu_start;  //**< The thread's CPU time when timing started. */
+  };
+
+  /**
+   * @brief Get what was recorded for every phase.
+   * @return The stats, indexed by Phase.
+   */
+  inline std::array<PhaseStats, PHASE_COUNT> stats() {
+    detail::State& state = detail::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.phases;
+  }
+
+  /**
+   * @brief Format what was recorded as a table, one phase per line.
+   * @return The table.
+   */
+  inline std::string table() {
+    std::array<PhaseStats, PHASE_COUNT> phases = stats();
+
+    PhaseStats total;
+    for (const PhaseStats& phase : phases) {
+      total.wall_ns += phase.wall_ns;
+      total.cpu_ns += phase.cpu_ns;
+    }
+
+    std::string text;
+    llvm::raw_string_ostream stream(text);
+
+    stream << llvm::formatv("{0,-9} {1,10} {2,10} {3,6} {4,12} {5,10} "
+                            "{6,10} {7,12}\n",
+                            "phase", "wall ms", "cpu ms", "wall%", "bytes",
+                            "items", "MB/s", "items/s");
+
+    for (size_t i = 0; i < PHASE_COUNT; i++) {
+      const PhaseStats& phase = phases[i];
+      if (phase.runs == 0) {
+        continue;
+      }
+
+      double seconds = phase.wall_ns / 1e9;
+      double share = total.wall_ns ? 100.0 * phase.wall_ns / total.wall_ns : 0;
+
+      stream << llvm::formatv(
+          "{0,-9} {1,10:f2} {2,10:f2} {3,6:f1} {4,12} {5,10} {6,10:f1} "
+          "{7,12:f0}\n",
+          PHASE_NAMES[i], phase.wall_ns / 1e6, phase.cpu_ns / 1e6, share,
+          phase.bytes, phase.items,
+          seconds > 0 ? phase.bytes / seconds / 1e6 : 0.0,
+          seconds > 0 ? phase.items / seconds : 0.0);
+    }
+
+    stream << llvm::formatv("{0,-9} {1,10:f2} {2,10:f2}\n", "total",
+                            total.wall_ns / 1e6, total.cpu_ns / 1e6);
+    return stream.str();
+  }
+
+  /**
+   * @brief Format what was recorded as JSON: an object with a `phases`
+   * array of objects with `name`, `wall_ns`, `cpu_ns`, `bytes`, `items` and
+   * `runs`.
+   * @return The JSON text.
+   */
+  inline std::string json() {
+    std::array<PhaseStats, PHASE_COUNT> phases = stats();
+
+    std::string text;
+    llvm::raw_string_ostream stream(text);
+    llvm::json::OStream json(stream, 2);
+
+    json.object([&] {
+      json.attributeArray("phases", [&] {
+        for (size_t i = 0; i < PHASE_COUNT; i++) {
+          const PhaseStats& phase = phases[i];
+
+          json.object([&] {
+            json.attribute("name", PHASE_NAMES[i]);
+            json.attribute("wall_ns", static_cast<int64_t>(phase.wall_ns));
+            json.attribute("cpu_ns", static_cast<int64_t>(phase.cpu_ns));
+            json.attribute("bytes", static_cast<int64_t>(phase.bytes));
+            json.attribute("items", static_cast<int64_t>(phase.items));
+            json.attribute("runs", static_cast<int64_t>(phase.runs));
+          });
+        }
+      });
+    });
+
+    stream << '\n';
+    return stream.str();
+  }
+
+  /**
+   * @brief Format every run of every phase recorded with tracing on in the
+   * Chrome trace event format, which `chrome://tracing` and Perfetto show
+   * as a timeline with a track per thread.
+   * @return The JSON text.
+   */
+  inline std::string chrome_trace() {
+    detail::State& state = detail::state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    std::string text;
+    llvm::raw_string_ostream stream(text);
+    llvm::json::OStream json(stream);
+
+    json.object([&] {
+      json.attributeArray("traceEvents", [&] {
+        for (const detail::Event& event : state.events) {
+          json.object([&] {
+            json.attribute("name", PHASE_NAMES[event.phase]);
+            json.attribute("cat", "excerpt");
+            json.attribute("ph", "X");
+            json.attribute("pid", 1);
+            json.attribute("tid", static_cast<int64_t>(event.thread));
+            json.attribute("ts", event.start_ns / 1e3);
+            json.attribute("dur", event.wall_ns / 1e3);
+            json.attributeObject("args", [&] {
+              json.attribute("detail", event.detail);
+              json.attribute("bytes", static_cast<int64_t>(event.bytes));
+              json.attribute("items", static_cast<int64_t>(event.items));
+            });
+          });
+        }
+      });
+      json.attribute("displayTimeUnit", "ms");
+    });
+
+    stream << '\n';
+    return stream.str();
+  }
+
+}  // namespace excerpt::timing
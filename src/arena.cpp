@@ -0,0 +1,75 @@
+#include "excerpt/arena.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace excerpt {
+  Arena::Arena(size_t block_size, memory::Subsystem subsystem)
+      : cursor(nullptr),
+        limit(nullptr),
+        first_block_size(std::max<size_t>(block_size, 64)),
+        next_block_size(first_block_size),
+        used(0),
+        reserved(0),
+        subsystem(subsystem) {}
+
+  Arena::~Arena() { memory::arena_released(subsystem, used, reserved); }
+
+  Arena::Arena(Arena&& other) noexcept
+      : blocks(std::move(other.blocks)),
+        cursor(std::exchange(other.cursor, nullptr)),
+        limit(std::exchange(other.limit, nullptr)),
+        first_block_size(other.first_block_size),
+        next_block_size(std::exchange(other.next_block_size,
+                                      other.first_block_size)),
+        used(std::exchange(other.used, 0)),
+        reserved(std::exchange(other.reserved, 0)),
+        subsystem(other.subsystem) {
+    other.blocks.clear();
+  }
+
+  Arena& Arena::operator=(Arena&& other) noexcept {
+    if (this != &other) {
+      memory::arena_released(subsystem, used, reserved);
+
+      blocks = std::move(other.blocks);
+      cursor = std::exchange(other.cursor, nullptr);
+      limit = std::exchange(other.limit, nullptr);
+      first_block_size = other.first_block_size;
+      next_block_size =
+          std::exchange(other.next_block_size, other.first_block_size);
+      used = std::exchange(other.used, 0);
+      reserved = std::exchange(other.reserved, 0);
+      subsystem = other.subsystem;
+      other.blocks.clear();
+    }
+
+    return *this;
+  }
+
+  void* Arena::grow(size_t size, size_t alignment) {
+    // Oversized requests get a block of their own
+    size_t block_size = std::max(next_block_size, size + alignment);
+
+    blocks.push_back(std::make_unique_for_overwrite<char[]>(block_size));
+    reserved += block_size;
+    next_block_size *= 2;
+
+    cursor = blocks.back().get();
+    limit = cursor + block_size;
+
+    return allocate(size, alignment);
+  }
+
+  void Arena::reset() {
+    memory::arena_released(subsystem, used, reserved);
+    blocks.clear();
+
+    cursor = nullptr;
+    limit = nullptr;
+    next_block_size = first_block_size;
+    used = 0;
+    reserved = 0;
+  }
+
+}  // namespace excerpt
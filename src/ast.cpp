@@ -0,0 +1,23 @@
+#include "excerpt/ast.hpp"
+
+#include <algorithm>
+
+namespace excerpt {
+  ListId Ast::add_list(std::span<const NodeId> items) {
+    auto* list = static_cast<NodeId*>(arena.allocate(
+        (items.size() + 1) * sizeof(NodeId), alignof(NodeId)));
+
+    list[0] = static_cast<NodeId>(items.size());
+    std::copy(items.begin(), items.end(), list + 1);
+
+    lists.push_back(list);
+    return static_cast<ListId>(lists.size() - 1);
+  }
+
+  void Ast::add_chunk() {
+    // Nodes are trivial, so each is constructed by assigning it
+    chunks.push_back(static_cast<Node*>(
+        arena.allocate(CHUNK_SIZE * sizeof(Node), alignof(Node))));
+  }
+
+}  // namespace excerpt
@@ -0,0 +1,163 @@
+#include "excerpt/backend.hpp"
+#include "excerpt_utils/logger.hpp"
+
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PassTimingInfo.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+
+#include <mutex>
+
+namespace excerpt {
+  namespace {
+    // The level the code generator runs at for an optimization level
+    llvm::CodeGenOpt::Level codegen_level(OptLevel level) {
+      switch (level) {
+        case OptLevel::O0:
+          return llvm::CodeGenOpt::None;
+        case OptLevel::O1:
+          return llvm::CodeGenOpt::Less;
+        case OptLevel::O3:
+          return llvm::CodeGenOpt::Aggressive;
+        default:
+          return llvm::CodeGenOpt::Default;
+      }
+    }
+
+    // The new pass manager's name for an optimization level
+    llvm::OptimizationLevel pipeline_level(OptLevel level) {
+      switch (level) {
+        case OptLevel::O0:
+          return llvm::OptimizationLevel::O0;
+        case OptLevel::O1:
+          return llvm::OptimizationLevel::O1;
+        case OptLevel::O3:
+          return llvm::OptimizationLevel::O3;
+        case OptLevel::Os:
+          return llvm::OptimizationLevel::Os;
+        default:
+          return llvm::OptimizationLevel::O2;
+      }
+    }
+  }  // namespace
+
+  std::unique_ptr<llvm::TargetMachine> create_target_machine(OptLevel level) {
+    static std::once_flag initialized;
+    std::call_once(initialized, [] {
+      llvm::InitializeNativeTarget();
+      llvm::InitializeNativeTargetAsmPrinter();
+    });
+
+    std::string triple = llvm::sys::getProcessTriple();
+    std::string problem;
+    const llvm::Target* target =
+        llvm::TargetRegistry::lookupTarget(triple, problem);
+
+    if (!target) {
+      logger::error("no target for {0}: {1}", triple, problem);
+      return nullptr;
+    }
+
+    llvm::TargetOptions options;
+    return std::unique_ptr<llvm::TargetMachine>(target->createTargetMachine(
+        triple, llvm::sys::getHostCPUName(), "", options, llvm::Reloc::PIC_,
+        llvm::None, codegen_level(level)));
+  }
+
+  std::string host_target() {
+    return llvm::sys::getProcessTriple() + "-" +
+           llvm::sys::getHostCPUName().str();
+  }
+
+  void optimize(llvm::Module& module, llvm::TargetMachine& machine,
+                OptLevel level, std::string* timings) {
+    module.setTargetTriple(machine.getTargetTriple().str());
+    module.setDataLayout(machine.createDataLayout());
+
+    // The stream outlives the timer, which reports again when destroyed
+    std::string report;
+    llvm::raw_string_ostream stream(report);
+    llvm::PassInstrumentationCallbacks callbacks;
+    llvm::TimePassesHandler timer(timings != nullptr);
+
+    if (timings) {
+      timer.setOutStream(stream);
+      timer.registerCallbacks(callbacks);
+    }
+
+    llvm::LoopAnalysisManager loops;
+    llvm::FunctionAnalysisManager functions;
+    llvm::CGSCCAnalysisManager cgscc;
+    llvm::ModuleAnalysisManager modules;
+
+    llvm::PassBuilder builder(&machine, llvm::PipelineTuningOptions(),
+                              llvm::None, &callbacks);
+    builder.registerModuleAnalyses(modules);
+    builder.registerCGSCCAnalyses(cgscc);
+    builder.registerFunctionAnalyses(functions);
+    builder.registerLoopAnalyses(loops);
+    builder.crossRegisterProxies(loops, functions, cgscc, modules);
+
+    llvm::ModulePassManager passes =
+        level == OptLevel::O0
+            ? builder.buildO0DefaultPipeline(llvm::OptimizationLevel::O0)
+            : builder.buildPerModuleDefaultPipeline(pipeline_level(level));
+    passes.run(module, modules);
+
+    if (timings) {
+      timer.print();
+      *timings = std::move(stream.str());
+    }
+  }
+
+  bool emit_object(llvm::Module& module, llvm::TargetMachine& machine,
+                   const std::string& path) {
+    std::error_code code;
+    llvm::raw_fd_ostream file(path, code, llvm::sys::fs::OF_None);
+
+    if (code) {
+      logger::error("could not open {0}: {1}", path, code.message());
+      return false;
+    }
+
+    if (!emit_object(module, machine, file)) {
+      return false;
+    }
+
+    file.close();
+
+    if (file.has_error()) {
+      logger::error("could not write {0}: {1}", path,
+                    file.error().message());
+      file.clear_error();
+      return false;
+    }
+
+    return true;
+  }
+
+  bool emit_object(llvm::Module& module, llvm::TargetMachine& machine,
+                   llvm::raw_pwrite_stream& stream) {
+    module.setTargetTriple(machine.getTargetTriple().str());
+    module.setDataLayout(machine.createDataLayout());
+
+    // Code generation has not moved to the new pass manager yet
+    llvm::legacy::PassManager passes;
+    if (machine.addPassesToEmitFile(passes, stream, nullptr,
+                                    llvm::CGFT_ObjectFile)) {
+      logger::error("{0} cannot emit object files",
+                    machine.getTargetTriple().str());
+      return false;
+    }
+
+    passes.run(module);
+    return true;
+  }
+
+}  // namespace excerpt
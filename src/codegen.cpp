@@ -0,0 +1,802 @@
+#include "excerpt/codegen.hpp"
+#include "excerpt/memory.hpp"
+#include "excerpt_utils/logger.hpp"
+
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <limits>
+
+namespace excerpt {
+  namespace {
+    // Types ordered by rank, as in C's usual arithmetic conversions
+    int rank(TokenType type) {
+      switch (type) {
+        case TokenType::BOOL:
+          return 0;
+        case TokenType::CHAR:
+          return 1;
+        case TokenType::INT:
+          return 2;
+        default:
+          return 3;
+      }
+    }
+
+    // The type arithmetic on two operands is done in, at least `int`
+    TokenType common_type(TokenType lhs, TokenType rhs) {
+      return rank(lhs) >= rank(rhs) ? (rank(lhs) < 2 ? TokenType::INT : lhs)
+                                    : (rank(rhs) < 2 ? TokenType::INT : rhs);
+    }
+
+    bool is_comparison(TokenType op) {
+      return op == TokenType::EQUAL || op == TokenType::NOT_EQUAL ||
+             op == TokenType::LESS || op == TokenType::LESS_EQUAL ||
+             op == TokenType::GREATER || op == TokenType::GREATER_EQUAL;
+    }
+  }  // namespace
+
+  CodeGenerator::CodeGenerator(llvm::LLVMContext& context,
+                               std::string_view source,
+                               const TokenBuffer& tokens, const Ast& ast,
+                               std::string name)
+      : context(context),
+        builder(context),
+        source(source),
+        tokens(tokens),
+        ast(ast),
+        name(std::move(name)),
+        manager(source),
+        current(nullptr),
+        failed(false) {}
+
+  std::unique_ptr<llvm::Module> CodeGenerator::generate(NodeId program) {
+    module = std::make_unique<llvm::Module>(name, context);
+    module->setSourceFileName(name);
+
+    std::span<const NodeId> items = ast.list(ast.node(program).lhs);
+
+    // Functions first, so calls may precede definitions
+    for (NodeId item : items) {
+      if (ast.node(item).kind == NodeKind::FUNCTION) {
+        declare_function(item);
+      }
+    }
+
+    for (NodeId item : items) {
+      if (failed) {
+        break;
+      }
+
+      if (ast.node(item).kind == NodeKind::FUNCTION) {
+        define_function(item);
+      } else {
+        define_global(item);
+      }
+    }
+
+    if (failed) {
+      return nullptr;
+    }
+
+    std::string problems;
+    llvm::raw_string_ostream stream(problems);
+
+    if (llvm::verifyModule(*module, &stream)) {
+      logger::error("{0}: generated invalid IR: {1}", name, stream.str());
+      return nullptr;
+    }
+
+    return std::move(module);
+  }
+
+  llvm::Type* CodeGenerator::type_of(TokenType type) {
+    switch (type) {
+      case TokenType::BOOL:
+        return builder.getInt1Ty();
+      case TokenType::CHAR:
+        return builder.getInt8Ty();
+      case TokenType::FLOAT:
+        return builder.getDoubleTy();
+      default:
+        return builder.getInt32Ty();
+    }
+  }
+
+  void CodeGenerator::declare_function(NodeId id) {
+    const Node& node = ast.node(id);
+    std::string_view function_name = spelling(node.token);
+
+    if (functions.count(function_name)) {
+      error(node.token, "redefinition of '" + std::string(function_name) + "'");
+      return;
+    }
+
+    Function function{nullptr, node.op, {}};
+    std::vector<llvm::Type*> types;
+
+    for (NodeId parameter : ast.list(node.lhs)) {
+      function.parameters.push_back(ast.node(parameter).op);
+      types.push_back(type_of(ast.node(parameter).op));
+    }
+
+    function.function = llvm::Function::Create(
+        llvm::FunctionType::get(type_of(node.op), types, false),
+        llvm::Function::ExternalLinkage, llvm::StringRef(function_name),
+        module.get());
+
+    memory::Scope symbols(memory::SYMBOLS);
+    functions.emplace(function_name, std::move(function));
+  }
+
+  void CodeGenerator::define_function(NodeId id) {
+    const Node& node = ast.node(id);
+    current = &functions.at(spelling(node.token));
+
+    llvm::Function* function = current->function;
+    builder.SetInsertPoint(
+        llvm::BasicBlock::Create(context, "entry", function));
+
+    // Parameters get stack slots too, as they may be assigned
+    scopes.push_back(variables.size());
+
+    std::span<const NodeId> parameters = ast.list(node.lhs);
+    for (size_t i = 0; i < parameters.size(); i++) {
+      const Node& parameter = ast.node(parameters[i]);
+      llvm::Argument* argument = function->getArg(i);
+      argument->setName(llvm::StringRef(spelling(parameter.token)));
+
+      llvm::Value* slot = builder.CreateAlloca(type_of(parameter.op), nullptr,
+                                               argument->getName());
+      builder.CreateStore(argument, slot);
+
+      bind(parameter.token, slot, parameter.op);
+    }
+
+    statement(node.rhs);
+
+    // Falling off the end returns zero, rather than leaving it undefined
+    if (!failed && !builder.GetInsertBlock()->getTerminator()) {
+      builder.CreateRet(llvm::Constant::getNullValue(type_of(current->result)));
+    }
+
+    close_scope();
+    current = nullptr;
+  }
+
+  void CodeGenerator::define_global(NodeId id) {
+    const Node& node = ast.node(id);
+    std::string_view global_name = spelling(node.token);
+    llvm::Type* type = type_of(node.op);
+
+    if (redefines(node.token)) {
+      return;
+    }
+
+    llvm::Constant* initializer = llvm::Constant::getNullValue(type);
+
+    if (node.lhs != NO_NODE) {
+      if (!is_constant(node.lhs)) {
+        error(ast.node(node.lhs).token,
+              "global initializer is not a constant expression");
+        return;
+      }
+
+      // Operations on constants are folded by the builder, so no
+      // instruction is created
+      Value value = convert(expression(node.lhs), node.op);
+      if (!value.value) {
+        return;
+      }
+
+      initializer = llvm::cast<llvm::Constant>(value.value);
+    }
+
+    auto* global = new llvm::GlobalVariable(
+        *module, type, false, llvm::GlobalValue::ExternalLinkage, initializer,
+        llvm::StringRef(global_name));
+
+    bind(node.token, global, node.op);
+  }
+
+  void CodeGenerator::statement(NodeId id) {
+    if (failed) {
+      return;
+    }
+
+    const Node& node = ast.node(id);
+
+    switch (node.kind) {
+      case NodeKind::BLOCK:
+        scopes.push_back(variables.size());
+
+        for (NodeId item : ast.list(node.lhs)) {
+          statement(item);
+        }
+
+        close_scope();
+        break;
+
+      case NodeKind::EXPRESSION:
+        expression(node.lhs);
+        break;
+
+      case NodeKind::DECLARATION:
+        declaration(node);
+        break;
+
+      case NodeKind::IF:
+        if_statement(node);
+        break;
+
+      case NodeKind::WHILE:
+        loop(NO_NODE, node.lhs, NO_NODE, node.rhs);
+        break;
+
+      case NodeKind::FOR: {
+        std::span<const NodeId> parts = ast.list(node.lhs);
+
+        // The initializer's variables are scoped to the loop
+        scopes.push_back(variables.size());
+        loop(parts[0], parts[1], parts[2], node.rhs);
+        close_scope();
+        break;
+      }
+
+      case NodeKind::RETURN: {
+        Value value =
+            node.lhs == NO_NODE
+                ? Value{llvm::Constant::getNullValue(type_of(current->result)),
+                        current->result}
+                : convert(expression(node.lhs), current->result);
+
+        if (value.value) {
+          builder.CreateRet(value.value);
+          start_block("after.return");
+        }
+        break;
+      }
+
+      case NodeKind::BREAK:
+      case NodeKind::CONTINUE:
+        if (loops.empty()) {
+          error(node.token, "'" + std::string(spelling(node.token)) +
+                                "' outside of a loop");
+          break;
+        }
+
+        builder.CreateBr(node.kind == NodeKind::BREAK ? loops.back().exit
+                                                      : loops.back().next);
+        start_block("after.jump");
+        break;
+
+      default:
+        error(node.token, "expected a statement");
+        break;
+    }
+  }
+
+  void CodeGenerator::declaration(const Node& node) {
+    std::string_view variable_name = spelling(node.token);
+
+    if (redefines(node.token)) {
+      return;
+    }
+
+    // Stack slots go in the entry block, where mem2reg looks for them
+    llvm::BasicBlock& entry = current->function->getEntryBlock();
+    llvm::IRBuilder<> slots(&entry, entry.getFirstInsertionPt());
+    llvm::Value* slot = slots.CreateAlloca(type_of(node.op), nullptr,
+                                           llvm::StringRef(variable_name));
+
+    Value value =
+        node.lhs == NO_NODE
+            ? Value{llvm::Constant::getNullValue(type_of(node.op)), node.op}
+            : convert(expression(node.lhs), node.op);
+
+    if (!value.value) {
+      return;
+    }
+
+    builder.CreateStore(value.value, slot);
+
+    // In scope only after its initializer, as in C
+    bind(node.token, slot, node.op);
+  }
+
+  void CodeGenerator::if_statement(const Node& first) {
+    // An `else if` chain is generated in a loop, as the Parser builds it,
+    // with every arm joining at the same end block
+    llvm::Function* function = current->function;
+    auto* end_block = llvm::BasicBlock::Create(context, "if.end", function);
+    const Node* node = &first;
+
+    while (true) {
+      std::span<const NodeId> branches = ast.list(node->rhs);
+
+      llvm::Value* test = condition(node->lhs);
+      if (!test) {
+        return;
+      }
+
+      auto* then_block =
+          llvm::BasicBlock::Create(context, "if.then", function);
+      auto* else_block = branches[1] == NO_NODE
+                             ? nullptr
+                             : llvm::BasicBlock::Create(context, "if.else",
+                                                        function);
+
+      builder.CreateCondBr(test, then_block,
+                           else_block ? else_block : end_block);
+
+      builder.SetInsertPoint(then_block);
+      statement(branches[0]);
+      builder.CreateBr(end_block);
+
+      if (!else_block) {
+        break;
+      }
+
+      else_block->moveAfter(builder.GetInsertBlock());
+      builder.SetInsertPoint(else_block);
+
+      if (ast.node(branches[1]).kind != NodeKind::IF) {
+        statement(branches[1]);
+        builder.CreateBr(end_block);
+        break;
+      }
+
+      node = &ast.node(branches[1]);
+    }
+
+    end_block->moveAfter(builder.GetInsertBlock());
+    builder.SetInsertPoint(end_block);
+  }
+
+  void CodeGenerator::loop(NodeId init, NodeId test, NodeId step,
+                           NodeId body) {
+    if (init != NO_NODE) {
+      statement(init);
+    }
+
+    llvm::Function* function = current->function;
+    auto* condition_block =
+        llvm::BasicBlock::Create(context, "loop.condition", function);
+    auto* body_block = llvm::BasicBlock::Create(context, "loop.body", function);
+    auto* step_block = step == NO_NODE ? condition_block
+                                       : llvm::BasicBlock::Create(
+                                             context, "loop.step", function);
+    auto* end_block = llvm::BasicBlock::Create(context, "loop.end", function);
+
+    builder.CreateBr(condition_block);
+    builder.SetInsertPoint(condition_block);
+
+    if (test == NO_NODE) {
+      builder.CreateBr(body_block);
+    } else if (llvm::Value* value = condition(test)) {
+      builder.CreateCondBr(value, body_block, end_block);
+    } else {
+      return;
+    }
+
+    loops.push_back(Loop{step_block, end_block});
+    builder.SetInsertPoint(body_block);
+    statement(body);
+    loops.pop_back();
+
+    if (step != NO_NODE) {
+      builder.CreateBr(step_block);
+      step_block->moveAfter(builder.GetInsertBlock());
+      builder.SetInsertPoint(step_block);
+      expression(step);
+    }
+
+    builder.CreateBr(condition_block);
+    end_block->moveAfter(builder.GetInsertBlock());
+    builder.SetInsertPoint(end_block);
+  }
+
+  CodeGenerator::Value CodeGenerator::expression(NodeId id) {
+    // Nodes are generated in post-order: a frame stays on the stack until
+    // its operands are generated, their values waiting on `operands`
+    frames.push_back(Frame{id, 0});
+
+    while (!frames.empty() && !failed) {
+      Frame& frame = frames.back();
+      const Node& node = ast.node(frame.id);
+
+      // What an operation applies to is checked before its operands, so
+      // errors are reported in source order
+      if (frame.done == 0) {
+        if (node.kind == NodeKind::ASSIGN) {
+          uint32_t target = ast.node(node.lhs).token;
+
+          if (!lookup(target)) {
+            error(target, "assignment to undeclared name '" +
+                              std::string(spelling(target)) + "'");
+            break;
+          }
+        } else if (node.kind == NodeKind::CALL &&
+                   ast.node(node.lhs).kind != NodeKind::NAME) {
+          error(node.token, "only named functions can be called");
+          break;
+        }
+      }
+
+      NodeId next = operand(node, frame.done);
+
+      if (next != NO_NODE) {
+        frame.done++;
+        frames.push_back(Frame{next, 0});
+        continue;
+      }
+
+      size_t count = frame.done;
+      Value result =
+          operation(node, std::span<const Value>(operands).last(count));
+
+      operands.resize(operands.size() - count);
+      operands.push_back(result);
+      frames.pop_back();
+    }
+
+    if (failed) {
+      frames.clear();
+      operands.clear();
+      return Value{nullptr, TokenType::INT};
+    }
+
+    Value result = operands.back();
+    operands.pop_back();
+    return result;
+  }
+
+  NodeId CodeGenerator::operand(const Node& node, uint32_t index) const {
+    switch (node.kind) {
+      case NodeKind::UNARY:
+        return index == 0 ? node.lhs : NO_NODE;
+
+      case NodeKind::BINARY:
+        return index == 0 ? node.lhs : index == 1 ? node.rhs : NO_NODE;
+
+      case NodeKind::ASSIGN:
+        return index == 0 ? node.rhs : NO_NODE;
+
+      case NodeKind::CALL: {
+        std::span<const NodeId> arguments = ast.list(node.rhs);
+        return index < arguments.size() ? arguments[index] : NO_NODE;
+      }
+
+      default:
+        return NO_NODE;
+    }
+  }
+
+  CodeGenerator::Value CodeGenerator::operation(
+      const Node& node, std::span<const Value> values) {
+    switch (node.kind) {
+      case NodeKind::INTEGER: {
+        // The tokenizer decoded the literal into 64 bits; an int is 32
+        int64_t value = tokens.values[node.token].integer;
+
+        if (value > std::numeric_limits<int32_t>::max()) {
+          return error(node.token, "integer literal is too large");
+        }
+
+        return Value{builder.getInt32(value), TokenType::INT};
+      }
+
+      case NodeKind::FLOAT: {
+        double value = tokens.values[node.token].real;
+
+        return Value{llvm::ConstantFP::get(builder.getDoubleTy(), value),
+                     TokenType::FLOAT};
+      }
+
+      case NodeKind::BOOLEAN:
+        return Value{
+            builder.getInt1(tokens.types[node.token] == TokenType::TRUE),
+            TokenType::BOOL};
+
+      case NodeKind::STRING:
+        return error(node.token, "string values are not supported");
+
+      case NodeKind::NAME: {
+        const Variable* variable = lookup(node.token);
+
+        if (!variable) {
+          return error(node.token, "use of undeclared name '" +
+                                       std::string(spelling(node.token)) +
+                                       "'");
+        }
+
+        return Value{builder.CreateLoad(type_of(variable->type),
+                                        variable->address,
+                                        llvm::StringRef(variable->name)),
+                     variable->type};
+      }
+
+      case NodeKind::UNARY: {
+        Value operand =
+            convert(values[0], common_type(values[0].type, TokenType::INT));
+
+        if (node.op == TokenType::MINUS) {
+          operand.value = operand.type == TokenType::FLOAT
+                              ? builder.CreateFNeg(operand.value)
+                              : builder.CreateNeg(operand.value);
+        }
+
+        return operand;
+      }
+
+      case NodeKind::BINARY:
+        return binary(node, values[0], values[1]);
+
+      case NodeKind::ASSIGN: {
+        const Variable* variable = lookup(ast.node(node.lhs).token);
+        Value result = convert(values[0], variable->type);
+
+        builder.CreateStore(result.value, variable->address);
+        return result;
+      }
+
+      case NodeKind::CALL:
+        return call(node, values);
+
+      default:
+        return error(node.token, "expected an expression");
+    }
+  }
+
+  CodeGenerator::Value CodeGenerator::binary(const Node& node, Value lhs,
+                                             Value rhs) {
+    TokenType type = common_type(lhs.type, rhs.type);
+    lhs = convert(lhs, type);
+    rhs = convert(rhs, type);
+
+    bool real = type == TokenType::FLOAT;
+    llvm::Value* l = lhs.value;
+    llvm::Value* r = rhs.value;
+
+    if (is_comparison(node.op)) {
+      llvm::CmpInst::Predicate predicate;
+
+      switch (node.op) {
+        case TokenType::EQUAL:
+          predicate = real ? llvm::CmpInst::FCMP_OEQ : llvm::CmpInst::ICMP_EQ;
+          break;
+        case TokenType::NOT_EQUAL:
+          predicate = real ? llvm::CmpInst::FCMP_UNE : llvm::CmpInst::ICMP_NE;
+          break;
+        case TokenType::LESS:
+          predicate = real ? llvm::CmpInst::FCMP_OLT : llvm::CmpInst::ICMP_SLT;
+          break;
+        case TokenType::LESS_EQUAL:
+          predicate = real ? llvm::CmpInst::FCMP_OLE : llvm::CmpInst::ICMP_SLE;
+          break;
+        case TokenType::GREATER:
+          predicate = real ? llvm::CmpInst::FCMP_OGT : llvm::CmpInst::ICMP_SGT;
+          break;
+        default:
+          predicate = real ? llvm::CmpInst::FCMP_OGE : llvm::CmpInst::ICMP_SGE;
+          break;
+      }
+
+      return Value{real ? builder.CreateFCmp(predicate, l, r)
+                        : builder.CreateICmp(predicate, l, r),
+                   TokenType::BOOL};
+    }
+
+    llvm::Value* value;
+
+    switch (node.op) {
+      case TokenType::PLUS:
+        value = real ? builder.CreateFAdd(l, r) : builder.CreateAdd(l, r);
+        break;
+      case TokenType::MINUS:
+        value = real ? builder.CreateFSub(l, r) : builder.CreateSub(l, r);
+        break;
+      case TokenType::STAR:
+        value = real ? builder.CreateFMul(l, r) : builder.CreateMul(l, r);
+        break;
+      case TokenType::SLASH:
+        value = real ? builder.CreateFDiv(l, r) : builder.CreateSDiv(l, r);
+        break;
+      default:
+        value = real ? builder.CreateFRem(l, r) : builder.CreateSRem(l, r);
+        break;
+    }
+
+    return Value{value, type};
+  }
+
+  CodeGenerator::Value CodeGenerator::call(
+      const Node& node, std::span<const Value> values) {
+    const Node& callee = ast.node(node.lhs);
+    std::string_view function_name = spelling(callee.token);
+
+    auto it = functions.find(function_name);
+
+    if (it == functions.end()) {
+      if (lookup(callee.token)) {
+        return error(callee.token,
+                     "'" + std::string(function_name) + "' is not a function");
+      }
+
+      // An external function, whose parameters are taken from this call
+      // with the usual promotions
+      Function function{nullptr, TokenType::INT, {}};
+      std::vector<llvm::Type*> types;
+
+      for (const Value& value : values) {
+        TokenType type = common_type(value.type, TokenType::INT);
+        function.parameters.push_back(type);
+        types.push_back(type_of(type));
+      }
+
+      function.function = llvm::Function::Create(
+          llvm::FunctionType::get(builder.getInt32Ty(), types, false),
+          llvm::Function::ExternalLinkage, llvm::StringRef(function_name),
+          module.get());
+
+      memory::Scope symbols(memory::SYMBOLS);
+      it = functions.emplace(function_name, std::move(function)).first;
+    }
+
+    const Function& function = it->second;
+
+    if (values.size() != function.parameters.size()) {
+      return error(node.token, "'" + std::string(function_name) + "' takes " +
+                                   std::to_string(function.parameters.size()) +
+                                   " arguments, not " +
+                                   std::to_string(values.size()));
+    }
+
+    std::vector<llvm::Value*> converted;
+    for (size_t i = 0; i < values.size(); i++) {
+      converted.push_back(convert(values[i], function.parameters[i]).value);
+    }
+
+    return Value{builder.CreateCall(function.function, converted),
+                 function.result};
+  }
+
+  CodeGenerator::Value CodeGenerator::convert(Value value, TokenType type) {
+    if (!value.value || value.type == type) {
+      return Value{value.value, type};
+    }
+
+    llvm::Type* target = type_of(type);
+    llvm::Value* result;
+
+    if (type == TokenType::BOOL) {
+      // Anything non-zero is true
+      result = value.type == TokenType::FLOAT
+                   ? builder.CreateFCmpUNE(
+                         value.value, llvm::ConstantFP::get(target, 0.0))
+                   : builder.CreateICmpNE(
+                         value.value,
+                         llvm::Constant::getNullValue(value.value->getType()));
+    } else if (type == TokenType::FLOAT) {
+      result = value.type == TokenType::BOOL
+                   ? builder.CreateUIToFP(value.value, target)
+                   : builder.CreateSIToFP(value.value, target);
+    } else if (value.type == TokenType::FLOAT) {
+      result = builder.CreateFPToSI(value.value, target);
+    } else if (value.type == TokenType::BOOL) {
+      result = builder.CreateZExt(value.value, target);
+    } else {
+      result = builder.CreateSExtOrTrunc(value.value, target);
+    }
+
+    return Value{result, type};
+  }
+
+  llvm::Value* CodeGenerator::condition(NodeId id) {
+    return convert(expression(id), TokenType::BOOL).value;
+  }
+
+  bool CodeGenerator::is_constant(NodeId id) const {
+    // Walked over an explicit stack too, as the initializer has not been
+    // generated yet
+    std::vector<NodeId> pending{id};
+
+    while (!pending.empty()) {
+      const Node& node = ast.node(pending.back());
+      pending.pop_back();
+
+      switch (node.kind) {
+        case NodeKind::INTEGER:
+        case NodeKind::FLOAT:
+        case NodeKind::BOOLEAN:
+          break;
+
+        case NodeKind::BINARY:
+          pending.push_back(node.rhs);
+          [[fallthrough]];
+
+        case NodeKind::UNARY:
+          pending.push_back(node.lhs);
+          break;
+
+        default:
+          return false;
+      }
+    }
+
+    return true;
+  }
+
+  SymbolId CodeGenerator::symbol(uint32_t token) {
+    // Tokens lexed without an interner are interned here instead; the two
+    // are never mixed, as the tokens either all have symbols or none do
+    SymbolId id = tokens.symbols.empty() ? names.intern(spelling(token))
+                                         : tokens.symbols[token];
+
+    if (id >= bindings.size()) {
+      memory::Scope symbols(memory::SYMBOLS);
+      bindings.resize(id + 1, NO_VARIABLE);
+    }
+
+    return id;
+  }
+
+  bool CodeGenerator::redefines(uint32_t token) {
+    uint32_t index = bindings[symbol(token)];
+    size_t scope = scopes.empty() ? 0 : scopes.back();
+
+    if (index == NO_VARIABLE || index < scope) {
+      return false;
+    }
+
+    error(token, "redefinition of '" + std::string(spelling(token)) + "'");
+    return true;
+  }
+
+  void CodeGenerator::bind(uint32_t token, llvm::Value* address,
+                           TokenType type) {
+    SymbolId id = symbol(token);
+
+    memory::Scope symbols(memory::SYMBOLS);
+    variables.push_back(
+        Variable{spelling(token), address, type, id, bindings[id]});
+    bindings[id] = variables.size() - 1;
+  }
+
+  void CodeGenerator::close_scope() {
+    // Innermost first, so a name bound twice is restored to what it
+    // shadowed before the scope opened
+    while (variables.size() > scopes.back()) {
+      const Variable& variable = variables.back();
+      bindings[variable.symbol] = variable.shadowed;
+      variables.pop_back();
+    }
+
+    scopes.pop_back();
+  }
+
+  const CodeGenerator::Variable* CodeGenerator::lookup(uint32_t token) {
+    uint32_t index = bindings[symbol(token)];
+    return index == NO_VARIABLE ? nullptr : &variables[index];
+  }
+
+  void CodeGenerator::start_block(const char* name) {
+    builder.SetInsertPoint(
+        llvm::BasicBlock::Create(context, name, current->function));
+  }
+
+  CodeGenerator::Value CodeGenerator::error(uint32_t token,
+                                            const std::string& message) {
+    // Only the first error is reported, as generation stops there
+    if (!failed) {
+      SourceLocation location = manager.location(tokens.offsets[token]);
+
+      logger::error("{0}:{1}:{2}: {3}", name, location.line, location.column,
+                    message);
+      failed = true;
+    }
+
+    return Value{nullptr, TokenType::INT};
+  }
+
+}  // namespace excerpt
@@ -0,0 +1,185 @@
+#include "excerpt/compile_cache.hpp"
+#include "excerpt_utils/logger.hpp"
+
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Chrono.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/SHA256.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace excerpt {
+  namespace {
+    // How long a temporary file may live before it is taken as abandoned
+    constexpr std::chrono::hours ABANDONED_AFTER(1);
+
+    constexpr std::string_view TEMPORARY_SUFFIX = ".tmp";
+  }  // namespace
+
+  CompileCache::CompileCache(std::string directory, uint64_t max_bytes)
+      : directory(std::move(directory)),
+        max_bytes(max_bytes),
+        hits(0),
+        misses(0),
+        stores(0),
+        evictions(0) {}
+
+  std::string CompileCache::key(
+      std::initializer_list<std::string_view> parts) {
+    llvm::SHA256 hash;
+
+    for (std::string_view part : parts) {
+      uint64_t length = part.size();
+      hash.update(llvm::StringRef(reinterpret_cast<const char*>(&length),
+                                  sizeof(length)));
+      hash.update(llvm::StringRef(part.data(), part.size()));
+    }
+
+    return llvm::toHex(hash.final(), true);
+  }
+
+  std::optional<std::string> CompileCache::lookup(const std::string& key) {
+    std::string path = path_of(key);
+    int fd;
+
+    if (llvm::sys::fs::openFileForRead(path, fd)) {
+      misses++;
+      return std::nullopt;
+    }
+
+    auto buffer = llvm::MemoryBuffer::getOpenFile(
+        llvm::sys::fs::convertFDToNativeFile(fd), path, -1, false);
+
+    // Refresh the entry, so it is evicted last
+    if (buffer) {
+      llvm::sys::fs::setLastAccessAndModificationTime(
+          fd, std::chrono::system_clock::now());
+    }
+
+    llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+
+    if (!buffer) {
+      misses++;
+      return std::nullopt;
+    }
+
+    hits++;
+    return (*buffer)->getBuffer().str();
+  }
+
+  bool CompileCache::store(const std::string& key, std::string_view contents) {
+    std::string path = path_of(key);
+    llvm::StringRef parent = llvm::sys::path::parent_path(path);
+
+    if (std::error_code code = llvm::sys::fs::create_directories(parent)) {
+      logger::warn("could not create cache directory {0}: {1}", parent,
+                   code.message());
+      return false;
+    }
+
+    // Write a file no one else uses, then rename it into place in one step
+    int fd;
+    llvm::SmallString<128> temporary;
+
+    if (std::error_code code = llvm::sys::fs::createUniqueFile(
+            path + ".%%%%%%%%" + std::string(TEMPORARY_SUFFIX), fd,
+            temporary)) {
+      logger::warn("could not write to cache {0}: {1}", directory,
+                   code.message());
+      return false;
+    }
+
+    {
+      llvm::raw_fd_ostream file(fd, true);
+      file << llvm::StringRef(contents.data(), contents.size());
+      file.close();
+
+      if (file.has_error()) {
+        logger::warn("could not write {0}: {1}", temporary,
+                     file.error().message());
+        file.clear_error();
+        llvm::sys::fs::remove(temporary);
+        return false;
+      }
+    }
+
+    if (std::error_code code = llvm::sys::fs::rename(temporary, path)) {
+      logger::warn("could not write {0}: {1}", path, code.message());
+      llvm::sys::fs::remove(temporary);
+      return false;
+    }
+
+    stores++;
+    return true;
+  }
+
+  void CompileCache::prune() {
+    struct Entry {
+      std::string path;
+      uint64_t size;
+      llvm::sys::TimePoint<> used;
+    };
+
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    auto now = std::chrono::system_clock::now();
+    std::error_code code;
+
+    for (llvm::sys::fs::recursive_directory_iterator it(directory, code), end;
+         it != end && !code; it.increment(code)) {
+      llvm::ErrorOr<llvm::sys::fs::basic_file_status> status = it->status();
+      if (!status || status->type() != llvm::sys::fs::file_type::regular_file) {
+        continue;
+      }
+
+      // Another process may be writing a recent one
+      if (llvm::StringRef(it->path()).endswith(TEMPORARY_SUFFIX.data())) {
+        if (now - status->getLastModificationTime() > ABANDONED_AFTER) {
+          llvm::sys::fs::remove(it->path());
+        }
+        continue;
+      }
+
+      entries.push_back(Entry{it->path(), status->getSize(),
+                              status->getLastModificationTime()});
+      total += status->getSize();
+    }
+
+    if (total <= max_bytes) {
+      return;
+    }
+
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.used < b.used; });
+
+    for (const Entry& entry : entries) {
+      if (total <= max_bytes) {
+        break;
+      }
+
+      // Someone may have removed it already, which frees the space as well
+      llvm::sys::fs::remove(entry.path);
+      total -= entry.size;
+      evictions++;
+    }
+  }
+
+  CacheStats CompileCache::stats() const {
+    return CacheStats{hits, misses, stores, evictions};
+  }
+
+  std::string CompileCache::path_of(const std::string& key) const {
+    // Fan entries out over subdirectories, as directories of many thousands
+    // of files are slow to search on some file systems
+    llvm::SmallString<128> path(directory);
+    llvm::sys::path::append(path, key.substr(0, 2), key.substr(2));
+    return std::string(path);
+  }
+
+}  // namespace excerpt
@@ -0,0 +1,356 @@
+#include "excerpt/driver.hpp"
+#include "excerpt/codegen.hpp"
+#include "excerpt/compile_cache.hpp"
+#include "excerpt/jit.hpp"
+#include "excerpt/number_literal.hpp"
+#include "excerpt/parallel_tokenizer.hpp"
+#include "excerpt/parser.hpp"
+#include "excerpt/source_buffer.hpp"
+#include "excerpt/source_manager.hpp"
+#include "excerpt/string_literal.hpp"
+#include "excerpt/token_file.hpp"
+#include "excerpt_utils/logger.hpp"
+#include "excerpt_utils/thread_pool.hpp"
+#include "excerpt_utils/timing.hpp"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+
+#include <iostream>
+#include <mutex>
+
+namespace excerpt {
+  namespace {
+    // Writes a compiled output to a file, or to standard output for "-"
+    bool write_output(const std::string& path, std::string_view contents) {
+      timing::ScopedTimer timer(timing::WRITE, path);
+      timer.count(contents.size());
+
+      std::error_code code;
+      llvm::raw_fd_ostream file(path, code, llvm::sys::fs::OF_None);
+
+      if (code) {
+        logger::error("could not open {0}: {1}", path, code.message());
+        return false;
+      }
+
+      file << llvm::StringRef(contents.data(), contents.size());
+      file.close();
+
+      if (file.has_error()) {
+        logger::error("could not write {0}: {1}", path,
+                      file.error().message());
+        file.clear_error();
+        return false;
+      }
+
+      return true;
+    }
+
+    // Opens a source file, timing it as the read phase
+    std::shared_ptr<SourceBuffer> open_source(const std::string& path) {
+      timing::ScopedTimer timer(timing::READ, path);
+      auto source = SourceBuffer::open(path);
+
+      if (source) {
+        timer.count(source->text().size());
+      }
+
+      return source;
+    }
+  }  // namespace
+
+  Driver::Driver(DriverOptions options) : options(options) {
+    if (!this->options.cache_dir.empty()) {
+      cache = std::make_unique<CompileCache>(this->options.cache_dir,
+                                             this->options.cache_size);
+    }
+  }
+
+  Driver::~Driver() = default;
+
+  size_t Driver::run(const std::vector<std::string>& inputs) {
+    if (!options.output.empty() && inputs.size() > 1) {
+      logger::error("--output needs a single input, not {0}", inputs.size());
+      return inputs.size();
+    }
+
+    size_t failures = inputs.size() == 1 ? !compile(inputs[0], options.jobs)
+                                         : compile_parallel(inputs);
+
+    if (cache) {
+      cache->prune();
+
+      if (options.cache_stats) {
+        CacheStats stats = cache->stats();
+        logger::info("cache: {0} hits, {1} misses, {2} stored, {3} evicted",
+                     stats.hits, stats.misses, stats.stores,
+                     stats.evictions);
+      }
+    }
+
+    return failures;
+  }
+
+  size_t Driver::compile_parallel(const std::vector<std::string>& inputs) {
+    // Each file's diagnostics, written in input order as files finish
+    std::vector<std::string> diagnostics(inputs.size());
+    std::vector<bool> finished(inputs.size(), false);
+    size_t written = 0;
+    size_t failures = 0;
+    std::mutex mutex;
+
+    parallel::ThreadPool pool(options.jobs);
+
+    for (size_t i = 0; i < inputs.size(); i++) {
+      pool.submit([&, i] {
+        bool compiled;
+
+        {
+          logger::Capture capture(diagnostics[i]);
+          compiled = compile(inputs[i], 1);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        finished[i] = true;
+        failures += !compiled;
+
+        for (; written < inputs.size() && finished[written]; written++) {
+          std::cout << diagnostics[written];
+          diagnostics[written] = std::string();
+        }
+      });
+    }
+
+    pool.wait();
+    return failures;
+  }
+
+  bool Driver::compile(const std::string& path, unsigned threads) {
+    auto source = open_source(path);
+    if (!source) {
+      return false;
+    }
+
+    std::string output = output_path(path);
+    if (options.emit_tokens) {
+      return emit_tokens(*source, output, threads);
+    }
+
+    std::string key;
+
+    // The output depends on the source and on how it is compiled; a report
+    // of pass timings needs the passes to run, so it bypasses the cache
+    if (cache && !options.time_passes) {
+      timing::ScopedTimer timer(timing::CACHE, path);
+      key = CompileCache::key(
+          {EXCERPT_VERSION, LLVM_VERSION_STRING, host_target(),
+           std::to_string(static_cast<int>(options.opt_level)),
+           options.emit_llvm ? "ir" : "object", source->name(),
+           source->text()});
+
+      std::optional<std::string> entry = cache->lookup(key);
+      timer.count(source->text().size());
+
+      if (entry) {
+        timer.count(entry->size());
+        return write_output(output, *entry);
+      }
+    }
+
+    // Each file has a context of its own, so files compile in parallel
+    llvm::LLVMContext context;
+    std::unique_ptr<llvm::Module> module = generate(*source, threads, context);
+    if (!module) {
+      return false;
+    }
+
+    auto machine = create_target_machine(options.opt_level);
+    if (!machine) {
+      return false;
+    }
+
+    std::string timings;
+    {
+      timing::ScopedTimer timer(timing::OPTIMIZE, path);
+      optimize(*module, *machine, options.opt_level,
+               options.time_passes ? &timings : nullptr);
+      timer.count(0, module->getInstructionCount());
+    }
+
+    if (options.time_passes) {
+      logger::info("{0}: pass timings:\n{1}", module->getName(), timings);
+    }
+
+    llvm::SmallString<0> contents;
+    {
+      timing::ScopedTimer timer(timing::EMIT, path);
+      llvm::raw_svector_ostream stream(contents);
+
+      if (options.emit_llvm) {
+        module->print(stream, nullptr);
+      } else if (!emit_object(*module, *machine, stream)) {
+        return false;
+      }
+
+      timer.count(contents.size());
+    }
+
+    std::string_view bytes(contents.data(), contents.size());
+
+    if (!write_output(output, bytes)) {
+      return false;
+    }
+
+    if (!key.empty()) {
+      cache->store(key, bytes);
+    }
+
+    return true;
+  }
+
+  std::optional<int> Driver::execute(const std::vector<std::string>& inputs) {
+    auto jit = Jit::create(options.opt_level);
+    if (!jit) {
+      return std::nullopt;
+    }
+
+    // Only IR is generated up front; functions compile as they are called
+    for (const auto& path : inputs) {
+      auto source = open_source(path);
+      if (!source) {
+        return std::nullopt;
+      }
+
+      auto context = std::make_unique<llvm::LLVMContext>();
+      std::unique_ptr<llvm::Module> module =
+          generate(*source, options.jobs, *context);
+
+      if (!module || !jit->add(std::move(module), std::move(context))) {
+        return std::nullopt;
+      }
+    }
+
+    return jit->run_main();
+  }
+
+  std::unique_ptr<llvm::Module> Driver::generate(const SourceBuffer& source,
+                                                 unsigned threads,
+                                                 llvm::LLVMContext& context) {
+    Interner names;
+    TokenBuffer tokens;
+    {
+      timing::ScopedTimer timer(timing::LEX, source.name());
+      tokens = tokenize_parallel(source.text(), threads, 64 * 1024, &names);
+      timer.count(source.text().size(), tokens.size());
+    }
+
+    SourceManager manager(source.text());
+
+    // Report invalid tokens
+    bool failed = false;
+    for (size_t i = 0; i < tokens.size(); i++) {
+      if (tokens.types[i] != TokenType::INVALID) {
+        continue;
+      }
+
+      // Lines are only indexed once there is something to report, splitting
+      // a large source across the threads that lexed it
+      manager.index_lines(threads);
+
+      auto location = manager.location(tokens.offsets[i]);
+      auto spelling =
+          source.text().substr(tokens.offsets[i], tokens.lengths[i]);
+
+      // A token starting with a digit or a quote is a literal that did not
+      // decode; a string's spelling may be the rest of the file, so is left
+      // out
+      if (spelling[0] >= '0' && spelling[0] <= '9') {
+        logger::error("{0}:{1}:{2}: numeric literal '{3}' {4}", source.name(),
+                      location.line, location.column, spelling,
+                      describe(decode_number(spelling).error));
+      } else if (spelling[0] == '"') {
+        logger::error("{0}:{1}:{2}: string literal {3}", source.name(),
+                      location.line, location.column,
+                      describe(check_string(spelling)));
+      } else {
+        logger::error("{0}:{1}:{2}: invalid token '{3}'", source.name(),
+                      location.line, location.column, spelling);
+      }
+
+      failed = true;
+    }
+
+    if (failed) {
+      return nullptr;
+    }
+
+    // Parse the tokens already lexed
+    Parser parser(source.text(), std::move(tokens), source.name());
+    NodeId program;
+    {
+      timing::ScopedTimer timer(timing::PARSE, source.name());
+      program = parser.parse();
+      timer.count(parser.tokens().size(), parser.ast().size());
+    }
+
+    if (program == NO_NODE) {
+      return nullptr;
+    }
+
+    // Semantic checks are made as IR is generated, so they are timed with it
+    timing::ScopedTimer timer(timing::IRGEN, source.name());
+    CodeGenerator generator(context, source.text(), parser.tokens(),
+                            parser.ast(), source.name());
+    std::unique_ptr<llvm::Module> module = generator.generate(program);
+
+    if (module) {
+      timer.count(0, module->getInstructionCount());
+    }
+
+    return module;
+  }
+
+  bool Driver::emit_tokens(const SourceBuffer& source,
+                           const std::string& output, unsigned threads) {
+    // Invalid tokens are written like any other, for tools to handle
+    TokenBuffer tokens;
+    {
+      timing::ScopedTimer timer(timing::LEX, source.name());
+      tokens = tokenize_parallel(source.text(), threads);
+      timer.count(source.text().size(), tokens.size());
+    }
+
+    std::string contents;
+    {
+      timing::ScopedTimer timer(timing::EMIT, source.name());
+      contents = write_token_file(tokens, source.text());
+      timer.count(contents.size(), tokens.size());
+    }
+
+    return write_output(output, contents);
+  }
+
+  std::string Driver::output_path(const std::string& path) const {
+    if (!options.output.empty() || path == "-") {
+      return options.output.empty() ? "-" : options.output;
+    }
+
+    // Replace the extension of the file name, if it has one
+    size_t slash = path.find_last_of('/');
+    size_t dot = path.find_last_of('.');
+    size_t stem = dot != std::string::npos &&
+                          (slash == std::string::npos || dot > slash + 1)
+                      ? dot
+                      : path.size();
+
+    const char* extension = options.emit_tokens ? ".tok"
+                            : options.emit_llvm ? ".ll"
+                                                : ".o";
+    return path.substr(0, stem) + extension;
+  }
+
+}  // namespace excerpt
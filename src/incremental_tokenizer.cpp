@@ -0,0 +1,124 @@
+#include "excerpt/incremental_tokenizer.hpp"
+#include "excerpt/lexer_tables.hpp"
+#include "excerpt/tokenizer.hpp"
+
+#include <algorithm>
+
+namespace excerpt {
+  namespace {
+    // How far past the end of a token lexing it may look, i.e the digit
+    // after "1." or the rest of a longer operator
+    constexpr size_t LOOKAHEAD = std::max<size_t>(2, OperatorDfa::MAX_LENGTH);
+
+    // Where token `k` ends
+    size_t end_of(const TokenBuffer& tokens, size_t k) {
+      return tokens.offsets[k] + tokens.lengths[k];
+    }
+
+    // The lexer's position before token `k`, i.e after token `k - 1`
+    size_t state_of(const TokenBuffer& tokens, size_t k) {
+      return k == 0 ? 0 : end_of(tokens, k - 1);
+    }
+
+    // Replace the columns' elements in [first, last) with those of `fresh`
+    template <typename T>
+    void splice(std::vector<T>& column, size_t first, size_t last,
+                const std::vector<T>& fresh) {
+      size_t common = std::min(last - first, fresh.size());
+      std::copy_n(fresh.begin(), common, column.begin() + first);
+
+      if (common < fresh.size()) {
+        column.insert(column.begin() + last, fresh.begin() + common,
+                      fresh.end());
+      } else {
+        column.erase(column.begin() + first + common, column.begin() + last);
+      }
+    }
+  }  // namespace
+
+  RelexResult relex(TokenBuffer& tokens, std::string_view source,
+                    const SourceEdit& edit, Interner* interner) {
+    bool interned = !tokens.symbols.empty();
+    size_t resume = edit.offset + edit.inserted.size();
+
+    // Restart at the first token whose lexing looked at the edited range.
+    // Tokens end in order, so it is found by bisection
+    size_t first = 0;
+    size_t last = tokens.size();
+
+    while (first < last) {
+      size_t middle = first + (last - first) / 2;
+
+      if (end_of(tokens, middle) + LOOKAHEAD <= edit.offset) {
+        first = middle + 1;
+      } else {
+        last = middle;
+      }
+    }
+
+    // The old tokens are kept from the first that begins past the edit where
+    // the new ones do too
+    size_t kept = first;
+
+    Tokenizer tokenizer(source);
+    tokenizer.set_interner(interned ? interner : nullptr);
+    tokenizer.seek(state_of(tokens, first));
+
+    TokenBuffer fresh;
+
+    while (true) {
+      size_t state = tokenizer.position();
+
+      if (state >= resume) {
+        // The same position before the edit
+        size_t target = state - edit.inserted.size() + edit.removed;
+
+        while (kept < tokens.size() && state_of(tokens, kept) < target) {
+          kept++;
+        }
+
+        // The END token is empty, so it begins where the token before it
+        // ends; stopping at the first of the two keeps it
+        if (kept < tokens.size() && state_of(tokens, kept) == target) {
+          break;
+        }
+      }
+
+      Lexeme lexeme = tokenizer.lex();
+      uint32_t offset = lexeme.spelling.data() - source.data();
+
+      if (interned) {
+        fresh.push(lexeme.type, offset, lexeme.spelling.length(),
+                   lexeme.symbol, lexeme.value);
+      } else {
+        fresh.push(lexeme.type, offset, lexeme.spelling.length(),
+                   lexeme.value);
+      }
+
+      if (lexeme.type == TokenType::END) {
+        kept = tokens.size();
+        break;
+      }
+    }
+
+    splice(tokens.types, first, kept, fresh.types);
+    splice(tokens.offsets, first, kept, fresh.offsets);
+    splice(tokens.lengths, first, kept, fresh.lengths);
+    splice(tokens.values, first, kept, fresh.values);
+
+    if (interned) {
+      splice(tokens.symbols, first, kept, fresh.symbols);
+    }
+
+    // The kept tokens move by the change in length, modulo 2^32
+    uint32_t shift = static_cast<uint32_t>(edit.inserted.size()) -
+                     static_cast<uint32_t>(edit.removed);
+
+    for (size_t i = first + fresh.size(); i < tokens.size(); i++) {
+      tokens.offsets[i] += shift;
+    }
+
+    return RelexResult{first, kept - first, fresh.size()};
+  }
+
+}  // namespace excerpt
@@ -0,0 +1,104 @@
+#include "excerpt/interner.hpp"
+#include "excerpt/memory.hpp"
+
+#include <cstring>
+
+namespace excerpt {
+  namespace {
+    // The table is kept at most half full
+    constexpr size_t INITIAL_SLOTS = 1024;
+
+    // Hashes a word at a time, as names are mostly short
+    uint32_t hash_name(std::string_view name) {
+      const char* data = name.data();
+      size_t size = name.size();
+      uint64_t hash = 0x9E3779B97F4A7C15ull ^ size;
+
+      auto mix = [&](uint64_t word) {
+        hash = (hash ^ word) * 0xBF58476D1CE4E5B9ull;
+        hash ^= hash >> 31;
+      };
+
+      for (; size >= 8; data += 8, size -= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, 8);
+        mix(word);
+      }
+
+      if (size) {
+        uint64_t word = 0;
+        std::memcpy(&word, data, size);
+        mix(word);
+      }
+
+      hash *= 0x94D049BB133111EBull;
+      return static_cast<uint32_t>(hash >> 32);
+    }
+  }  // namespace
+
+  size_t Interner::probe(std::string_view name, uint32_t hash) const {
+    size_t mask = table.size() - 1;
+
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+      const Slot& entry = table[slot];
+
+      if (entry.id == NO_SYMBOL ||
+          (entry.hash == hash && this->name(entry.id) == name)) {
+        return slot;
+      }
+    }
+  }
+
+  SymbolId Interner::intern(std::string_view name) {
+    if ((size() + 1) * 2 > table.size()) {
+      memory::Scope symbols(memory::SYMBOLS);
+      grow();
+    }
+
+    uint32_t hash = hash_name(name);
+    Slot& entry = table[probe(name, hash)];
+
+    if (entry.id != NO_SYMBOL) {
+      return entry.id;
+    }
+
+    // A new name, appended to the pool
+    memory::Scope symbols(memory::SYMBOLS);
+    entry = Slot{hash, static_cast<SymbolId>(size())};
+    pool.insert(pool.end(), name.begin(), name.end());
+    starts.push_back(static_cast<uint32_t>(pool.size()));
+
+    return entry.id;
+  }
+
+  SymbolId Interner::find(std::string_view name) const {
+    if (table.empty()) {
+      return NO_SYMBOL;
+    }
+
+    return table[probe(name, hash_name(name))].id;
+  }
+
+  void Interner::grow() {
+    std::vector<Slot> old = std::move(table);
+    table.assign(old.empty() ? INITIAL_SLOTS : old.size() * 2,
+                 Slot{0, NO_SYMBOL});
+
+    size_t mask = table.size() - 1;
+
+    for (const Slot& entry : old) {
+      if (entry.id == NO_SYMBOL) {
+        continue;
+      }
+
+      // Names are distinct, so each goes in the first empty slot
+      size_t slot = entry.hash & mask;
+      while (table[slot].id != NO_SYMBOL) {
+        slot = (slot + 1) & mask;
+      }
+
+      table[slot] = entry;
+    }
+  }
+
+}  // namespace excerpt
@@ -0,0 +1,145 @@
+#include "excerpt/jit.hpp"
+#include "excerpt_utils/logger.hpp"
+
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Target/TargetMachine.h"
+
+#include <cstdlib>
+
+namespace excerpt {
+  namespace {
+    // Called instead of a function that failed to compile, from JIT-compiled
+    // code that cannot be unwound, so all it can do is stop
+    void compile_failed() {
+      logger::error("a function failed to compile; stopping");
+      logger::flush();
+      std::exit(EXIT_FAILURE);
+    }
+  }  // namespace
+
+  std::unique_ptr<Jit> Jit::create(OptLevel level) {
+    // Also initializes the native target, which the JIT needs
+    auto machine = create_target_machine(level);
+    if (!machine) {
+      return nullptr;
+    }
+
+    auto jit = llvm::orc::LLLazyJITBuilder()
+                   .setLazyCompileFailureAddr(llvm::pointerToJITTargetAddress(
+                       &compile_failed))
+                   .create();
+    if (!jit) {
+      logger::error("could not create a JIT: {0}",
+                    llvm::toString(jit.takeError()));
+      return nullptr;
+    }
+
+    // Errors while compiling lazily are reported here, not returned
+    (*jit)->getExecutionSession().setErrorReporter([](llvm::Error error) {
+      logger::error("{0}", llvm::toString(std::move(error)));
+    });
+
+    // Resolve functions no module defines, such as `putchar`, in the process
+    auto process =
+        llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+            (*jit)->getDataLayout().getGlobalPrefix());
+    if (!process) {
+      logger::error("could not search the process for symbols: {0}",
+                    llvm::toString(process.takeError()));
+      return nullptr;
+    }
+
+    (*jit)->getMainJITDylib().addGenerator(std::move(*process));
+
+    return std::unique_ptr<Jit>(
+        new Jit(std::move(*jit), std::move(machine), level));
+  }
+
+  Jit::Jit(std::unique_ptr<llvm::orc::LLLazyJIT> jit,
+           std::unique_ptr<llvm::TargetMachine> machine, OptLevel level)
+      : jit(std::move(jit)),
+        machine(std::move(machine)),
+        level(level),
+        compiled(0) {
+    // Each function is split into a module of its own before it is compiled,
+    // so this optimizes one function at a time, as it is first called
+    this->jit->getIRTransformLayer().setTransform(
+        [this](llvm::orc::ThreadSafeModule module,
+               const llvm::orc::MaterializationResponsibility&) {
+          module.withModuleDo([this](llvm::Module& function) {
+            optimize(function, *this->machine, this->level);
+          });
+
+          compiled++;
+
+          return llvm::Expected<llvm::orc::ThreadSafeModule>(
+              std::move(module));
+        });
+  }
+
+  Jit::~Jit() = default;
+
+  bool Jit::add(std::unique_ptr<llvm::Module> module,
+                std::unique_ptr<llvm::LLVMContext> context) {
+    llvm::Function* main = module->getFunction("main");
+
+    if (main && !main->isDeclaration() &&
+        (!main->getReturnType()->isIntegerTy(32) || main->arg_size() != 0)) {
+      logger::error("{0}: 'main' must be declared as 'int main()'",
+                    module->getName());
+      return false;
+    }
+
+    // Every module's undefined functions must be found before running
+    for (const llvm::Function& function : *module) {
+      if (function.isDeclaration()) {
+        externals.push_back(function.getName().str());
+      }
+    }
+
+    module->setDataLayout(jit->getDataLayout());
+    std::string name = module->getName().str();
+
+    llvm::Error error = jit->addLazyIRModule(
+        llvm::orc::ThreadSafeModule(std::move(module), std::move(context)));
+
+    if (error) {
+      logger::error("{0}: {1}", name, llvm::toString(std::move(error)));
+      return false;
+    }
+
+    return true;
+  }
+
+  uint64_t Jit::lookup(const std::string& name) {
+    auto symbol = jit->lookup(name);
+
+    if (!symbol) {
+      logger::error("{0}", llvm::toString(symbol.takeError()));
+      return 0;
+    }
+
+    return symbol->getAddress();
+  }
+
+  std::optional<int> Jit::run_main() {
+    // A function found nowhere would otherwise fail only when first called,
+    // from compiled code that cannot recover; finding it compiles nothing
+    for (const std::string& name : externals) {
+      if (!lookup(name)) {
+        return std::nullopt;
+      }
+    }
+
+    uint64_t address = lookup("main");
+    if (!address) {
+      return std::nullopt;
+    }
+
+    auto main = reinterpret_cast<int (*)()>(address);
+    return main();
+  }
+
+}  // namespace excerpt
@@ -1,9 +1,64 @@
+#include "excerpt/driver.hpp"
+#include "excerpt/memory.hpp"
 #include "excerpt_utils/argparser.hpp"
+#include "excerpt_utils/logger.hpp"
+#include "excerpt_utils/timing.hpp"
 
+#include <fstream>
 #include <iostream>
 
+namespace {
+  // Writes what the phase timers recorded, as asked on the command line
+  void report_timing(const excerpt::ArgParser& args) {
+    excerpt::timing::stop();
+
+    if (args.time_report()) {
+      std::cerr << (args.time_report_format() ==
+                            excerpt::timing::ReportFormat::JSON
+                        ? excerpt::timing::json()
+                        : excerpt::timing::table());
+    }
+
+    if (!args.time_trace().empty()) {
+      std::ofstream trace(args.time_trace(), std::ios::binary);
+      trace << excerpt::timing::chrome_trace();
+
+      if (!trace) {
+        excerpt::logger::error("could not write {0}", args.time_trace());
+      }
+    }
+  }
+}  // namespace
+
 int main(int argc, const char* argv[]) {
-  excerpt::ArgParser parser(argc, argv);
+  excerpt::ArgParser args(argc, argv);
+  excerpt::logger::set_level(args.log_level());
+
+  excerpt::Driver driver({args.jobs(), args.opt_level(), args.time_passes(),
+                          args.emit_llvm(), args.output_file(),
+                          args.cache_dir(), args.cache_size(),
+                          args.cache_stats(), args.emit_tokens()});
+
+  bool timed = args.time_report() || !args.time_trace().empty();
+  if (timed) {
+    excerpt::timing::start(!args.time_trace().empty());
+  }
+
+  if (args.mem_report()) {
+    excerpt::memory::start();
+  }
+
+  int status = args.run() ? driver.execute(args.input_files()).value_or(1)
+                          : driver.run(args.input_files()) == 0 ? 0 : 1;
+
+  if (args.mem_report()) {
+    excerpt::memory::stop();
+    std::cerr << excerpt::memory::report();
+  }
+
+  if (timed) {
+    report_timing(args);
+  }
 
-  return 0;
+  return status;
 }
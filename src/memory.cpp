@@ -0,0 +1,368 @@
+#include "excerpt/memory.hpp"
+
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <malloc.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace excerpt::memory {
+  namespace {
+    // No scope is open, so the phase decides
+    constexpr uint8_t FROM_PHASE = SUBSYSTEM_COUNT;
+
+    struct Counters {
+      std::atomic<uint64_t> allocations;
+      std::atomic<uint64_t> bytes;
+      std::atomic<uint64_t> frees;
+      std::atomic<uint64_t> freed_bytes;
+      std::atomic<uint64_t> peak;
+    };
+
+    struct ArenaCounters {
+      std::atomic<uint64_t> releases;
+      std::atomic<uint64_t> used;
+      std::atomic<uint64_t> reserved;
+    };
+
+    // Plain atomics, zeroed before any constructor runs, so allocations made
+    // during static initialization are safe to count
+    std::atomic<bool> tracking;
+    std::atomic<int64_t> live_bytes;
+    std::atomic<uint64_t> peak_bytes;
+    Counters phase_counters[timing::PHASE_COUNT + 1];
+    Counters subsystem_counters[SUBSYSTEM_COUNT];
+    ArenaCounters arena_counters[SUBSYSTEM_COUNT];
+
+    thread_local uint8_t scope = FROM_PHASE;
+
+    // The subsystem each phase works on, when no scope says otherwise
+    constexpr Subsystem PHASE_SUBSYSTEMS[timing::PHASE_COUNT + 1] = {
+        OTHER, OTHER, TOKENIZER, AST, LLVM, LLVM, LLVM, OTHER, OTHER};
+
+    void raise(std::atomic<uint64_t>& peak, uint64_t value) {
+      uint64_t seen = peak.load(std::memory_order_relaxed);
+      while (seen < value && !peak.compare_exchange_weak(
+                                 seen, value, std::memory_order_relaxed)) {
+      }
+    }
+
+    // Counts allocating or freeing a block against the calling thread's
+    // phase and subsystem
+    void count(void* block, bool allocated) {
+      uint64_t size = malloc_usable_size(block);
+      timing::Phase phase = timing::current_phase();
+      Counters* counters[] = {&phase_counters[phase],
+                              &subsystem_counters[current_subsystem()]};
+
+      if (allocated) {
+        int64_t now = live_bytes.fetch_add(size, std::memory_order_relaxed) +
+                      static_cast<int64_t>(size);
+        uint64_t live = now > 0 ? now : 0;
+        raise(peak_bytes, live);
+
+        for (Counters* counter : counters) {
+          counter->allocations.fetch_add(1, std::memory_order_relaxed);
+          counter->bytes.fetch_add(size, std::memory_order_relaxed);
+          raise(counter->peak, live);
+        }
+      } else {
+        live_bytes.fetch_sub(size, std::memory_order_relaxed);
+
+        for (Counters* counter : counters) {
+          counter->frees.fetch_add(1, std::memory_order_relaxed);
+          counter->freed_bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+      }
+    }
+
+    void* allocate(size_t size, size_t alignment = 0) {
+      void* block = nullptr;
+
+      if (alignment > alignof(std::max_align_t)) {
+        if (posix_memalign(&block, alignment, size ? size : 1)) {
+          block = nullptr;
+        }
+      } else {
+        block = std::malloc(size ? size : 1);
+      }
+
+      if (block && tracking.load(std::memory_order_relaxed)) {
+        count(block, true);
+      }
+
+      return block;
+    }
+
+    void deallocate(void* block) {
+      if (block && tracking.load(std::memory_order_relaxed)) {
+        count(block, false);
+      }
+
+      std::free(block);
+    }
+
+    // Allocates for a throwing `operator new`, calling the new handler until
+    // it frees enough memory or gives up
+    void* allocate_or_throw(size_t size, size_t alignment = 0) {
+      for (;;) {
+        if (void* block = allocate(size, alignment)) {
+          return block;
+        }
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+          throw std::bad_alloc();
+        }
+
+        handler();
+      }
+    }
+
+    Usage load(const Counters& counters) {
+      return Usage{counters.allocations.load(std::memory_order_relaxed),
+                   counters.bytes.load(std::memory_order_relaxed),
+                   counters.frees.load(std::memory_order_relaxed),
+                   counters.freed_bytes.load(std::memory_order_relaxed),
+                   counters.peak.load(std::memory_order_relaxed)};
+    }
+
+    void reset(Counters& counters) {
+      counters.allocations = 0;
+      counters.bytes = 0;
+      counters.frees = 0;
+      counters.freed_bytes = 0;
+      counters.peak = 0;
+    }
+
+    // Writes one row of usage, or nothing if nothing was allocated or freed
+    void write_row(llvm::raw_ostream& stream, const char* name,
+                   const Usage& usage) {
+      if (usage.allocations == 0 && usage.frees == 0) {
+        return;
+      }
+
+      stream << llvm::formatv("{0,-10} {1,12} {2,14} {3,12} {4,14} {5,14}\n",
+                              name, usage.allocations, usage.bytes,
+                              usage.frees, usage.freed_bytes, usage.peak);
+    }
+
+    void write_header(llvm::raw_ostream& stream, const char* name) {
+      stream << llvm::formatv("{0,-10} {1,12} {2,14} {3,12} {4,14} {5,14}\n",
+                              name, "allocations", "bytes", "frees",
+                              "freed bytes", "peak live");
+    }
+  }  // namespace
+
+  void start() {
+    tracking.store(false);
+
+    for (Counters& counters : phase_counters) {
+      reset(counters);
+    }
+
+    for (Counters& counters : subsystem_counters) {
+      reset(counters);
+    }
+
+    for (ArenaCounters& counters : arena_counters) {
+      counters.releases = 0;
+      counters.used = 0;
+      counters.reserved = 0;
+    }
+
+    live_bytes = 0;
+    peak_bytes = 0;
+    tracking.store(true);
+  }
+
+  void stop() { tracking.store(false); }
+
+  bool enabled() { return tracking.load(std::memory_order_relaxed); }
+
+  int64_t live() { return live_bytes.load(std::memory_order_relaxed); }
+
+  uint64_t peak() { return peak_bytes.load(std::memory_order_relaxed); }
+
+  std::array<Usage, timing::PHASE_COUNT + 1> phases() {
+    std::array<Usage, timing::PHASE_COUNT + 1> usage;
+
+    for (size_t i = 0; i < usage.size(); i++) {
+      usage[i] = load(phase_counters[i]);
+    }
+
+    return usage;
+  }
+
+  std::array<Usage, SUBSYSTEM_COUNT> subsystems() {
+    std::array<Usage, SUBSYSTEM_COUNT> usage;
+
+    for (size_t i = 0; i < usage.size(); i++) {
+      usage[i] = load(subsystem_counters[i]);
+    }
+
+    return usage;
+  }
+
+  std::array<ArenaUsage, SUBSYSTEM_COUNT> arenas() {
+    std::array<ArenaUsage, SUBSYSTEM_COUNT> usage;
+
+    for (size_t i = 0; i < usage.size(); i++) {
+      usage[i] = ArenaUsage{
+          arena_counters[i].releases.load(std::memory_order_relaxed),
+          arena_counters[i].used.load(std::memory_order_relaxed),
+          arena_counters[i].reserved.load(std::memory_order_relaxed)};
+    }
+
+    return usage;
+  }
+
+  void arena_released(Subsystem subsystem, uint64_t used, uint64_t reserved) {
+    if (!enabled() || reserved == 0) {
+      return;
+    }
+
+    ArenaCounters& counters = arena_counters[subsystem];
+    counters.releases.fetch_add(1, std::memory_order_relaxed);
+    counters.used.fetch_add(used, std::memory_order_relaxed);
+    counters.reserved.fetch_add(reserved, std::memory_order_relaxed);
+  }
+
+  std::string report() {
+    std::string text;
+    llvm::raw_string_ostream stream(text);
+
+    auto by_phase = phases();
+    write_header(stream, "phase");
+    for (size_t i = 0; i < timing::PHASE_COUNT; i++) {
+      write_row(stream, timing::PHASE_NAMES[i], by_phase[i]);
+    }
+    write_row(stream, "none", by_phase[timing::PHASE_COUNT]);
+
+    stream << '\n';
+
+    auto by_subsystem = subsystems();
+    write_header(stream, "subsystem");
+    for (size_t i = 0; i < SUBSYSTEM_COUNT; i++) {
+      write_row(stream, SUBSYSTEM_NAMES[i], by_subsystem[i]);
+    }
+
+    auto by_arena = arenas();
+    for (size_t i = 0; i < SUBSYSTEM_COUNT; i++) {
+      const ArenaUsage& arena = by_arena[i];
+      if (arena.releases == 0) {
+        continue;
+      }
+
+      stream << llvm::formatv(
+          "{0} arenas: {1} bytes used of {2} reserved ({3:f1}%), {4} "
+          "releases\n",
+          SUBSYSTEM_NAMES[i], arena.used, arena.reserved,
+          100.0 * arena.used / arena.reserved, arena.releases);
+    }
+
+    stream << llvm::formatv("\npeak live: {0} bytes, live at exit: {1} bytes\n",
+                            peak(), live());
+    return stream.str();
+  }
+
+  Subsystem current_subsystem() {
+    return scope != FROM_PHASE ? static_cast<Subsystem>(scope)
+                               : PHASE_SUBSYSTEMS[timing::current_phase()];
+  }
+
+  Scope::Scope(Subsystem subsystem) : outer(scope) { scope = subsystem; }
+
+  Scope::~Scope() { scope = outer; }
+
+}  // namespace excerpt::memory
+
+// The allocation functions of the process, counting when tracking is on
+void* operator new(size_t size) {
+  return excerpt::memory::allocate_or_throw(size);
+}
+
+void* operator new[](size_t size) {
+  return excerpt::memory::allocate_or_throw(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+  return excerpt::memory::allocate_or_throw(size,
+                                            static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+  return excerpt::memory::allocate_or_throw(size,
+                                            static_cast<size_t>(alignment));
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return excerpt::memory::allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return excerpt::memory::allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment,
+                   const std::nothrow_t&) noexcept {
+  return excerpt::memory::allocate(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept {
+  return excerpt::memory::allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* block) noexcept {
+  excerpt::memory::deallocate(block);
+}
+
+void operator delete[](void* block) noexcept {
+  excerpt::memory::deallocate(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+  excerpt::memory::deallocate(block);
+}
+
+void operator delete[](void* block, size_t) noexcept {
+  excerpt::memory::deallocate(block);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept {
+  excerpt::memory::deallocate(block);
+}
+
+void operator delete[](void* block, std::align_val_t) noexcept {
+  excerpt::memory::deallocate(block);
+}
+
+void operator delete(void* block, size_t, std::align_val_t) noexcept {
+  excerpt::memory::deallocate(block);
+}
+
+void operator delete[](void* block, size_t, std::align_val_t) noexcept {
+  excerpt::memory::deallocate(block);
+}
+
+void operator delete(void* block, const std::nothrow_t&) noexcept {
+  excerpt::memory::deallocate(block);
+}
+
+void operator delete[](void* block, const std::nothrow_t&) noexcept {
+  excerpt::memory::deallocate(block);
+}
+
+void operator delete(void* block, std::align_val_t,
+                     const std::nothrow_t&) noexcept {
+  excerpt::memory::deallocate(block);
+}
+
+void operator delete[](void* block, std::align_val_t,
+                       const std::nothrow_t&) noexcept {
+  excerpt::memory::deallocate(block);
+}
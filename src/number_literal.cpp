@@ -0,0 +1,237 @@
+#include "excerpt/number_literal.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <limits>
+#include <string>
+
+namespace excerpt {
+  namespace {
+    // Checks if a character is a digit of a base
+    bool is_digit(char c, int base) {
+      if (base == 16) {
+        char lower = c | 0x20;
+        return (c >= '0' && c <= '9') || (lower >= 'a' && lower <= 'f');
+      }
+
+      return c >= '0' && c <= '9';
+    }
+
+    // Checks every separator lies between two digits; for hexadecimal
+    // literals, prefix letters are not digits, and for decimal ones, an
+    // exponent's letter is not either
+    bool separators_valid(std::string_view spelling, int base) {
+      for (size_t i = 0; i < spelling.size(); i++) {
+        if (spelling[i] == '_' &&
+            (i == 0 || i + 1 == spelling.size() ||
+             !is_digit(spelling[i - 1], base) ||
+             !is_digit(spelling[i + 1], base))) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    // Powers of ten exactly representable as doubles
+    constexpr double POWERS[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                 1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                 1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    // Accumulates the decimal digits from `p` on, returning the first
+    // character past them
+    const char* accumulate(const char* p, const char* end, uint64_t& value) {
+      for (; p != end && static_cast<unsigned char>(*p - '0') < 10; p++) {
+        value = value * 10 + (*p - '0');
+      }
+
+      return p;
+    }
+
+    // Decodes the common literals, short decimal integers and doubles, in a
+    // single pass. A double whose digits and power of ten are both exact
+    // doubles is their product or quotient, correctly rounded (Clinger's
+    // fast path). Anything else, or any doubt, is left to `from_chars`
+    bool decode_short(std::string_view spelling, NumberLiteral& literal) {
+      // At most 15 digits fit a double's mantissa, and cannot overflow
+      constexpr ptrdiff_t MAX_DIGITS = 15;
+
+      const char* begin = spelling.data();
+      const char* end = begin + spelling.size();
+      uint64_t mantissa = 0;
+
+      const char* p = accumulate(begin, end, mantissa);
+      ptrdiff_t digits = p - begin;
+
+      if (p == end) {
+        // A leading zero makes an integer octal
+        if (digits == 0 || digits > MAX_DIGITS ||
+            (*begin == '0' && digits > 1)) {
+          return false;
+        }
+
+        literal.type = TokenType::INTEGER_LITERAL;
+        literal.value.integer = static_cast<int64_t>(mantissa);
+        return true;
+      }
+
+      int scale = 0;
+
+      if (*p == '.') {
+        const char* fraction = p + 1;
+        p = accumulate(fraction, end, mantissa);
+        scale = static_cast<int>(fraction - p);
+        digits += p - fraction;
+      }
+
+      if (digits == 0 || digits > MAX_DIGITS) {
+        return false;
+      }
+
+      if (p != end && (*p | 0x20) == 'e') {
+        bool negative = ++p != end && *p == '-';
+        if (p != end && (*p == '-' || *p == '+')) {
+          p++;
+        }
+
+        // Exponents beyond two digits are beyond the fast path
+        uint64_t exponent = 0;
+        const char* start = p;
+        p = accumulate(start, std::min(end, start + 2), exponent);
+
+        if (p == start) {
+          return false;
+        }
+
+        scale += negative ? -static_cast<int>(exponent)
+                          : static_cast<int>(exponent);
+      }
+
+      if (p != end || scale < -22 || scale > 22) {
+        return false;
+      }
+
+      double value = static_cast<double>(mantissa);
+      literal.type = TokenType::FLOAT_LITERAL;
+      literal.value.real =
+          scale < 0 ? value / POWERS[-scale] : value * POWERS[scale];
+      return true;
+    }
+
+    NumberLiteral invalid(LiteralError error) {
+      return NumberLiteral{TokenType::INVALID, NumberValue{}, error};
+    }
+  }  // namespace
+
+  NumberLiteral decode_number(std::string_view spelling) {
+    NumberLiteral literal;
+    if (decode_short(spelling, literal)) {
+      return literal;
+    }
+
+    // The base is chosen by the prefix; a leading zero alone means octal,
+    // unless the literal turns out to be a decimal double, i.e `0.5`
+    int base = 10;
+    size_t prefix = 0;
+
+    if (spelling.size() > 1 && spelling[0] == '0') {
+      char letter = spelling[1] | 0x20;
+
+      if (letter == 'x') {
+        base = 16;
+        prefix = 2;
+      } else if (letter == 'b') {
+        base = 2;
+        prefix = 2;
+      }
+    }
+
+    // Separators are dropped before decoding, which needs a copy; literals
+    // without any are decoded in place
+    std::string stripped;
+    std::string_view digits = spelling;
+
+    if (spelling.find('_') != std::string_view::npos) {
+      if (!separators_valid(spelling, base == 16 ? 16 : 10)) {
+        return invalid(LiteralError::SEPARATOR);
+      }
+
+      stripped.reserve(spelling.size());
+      for (char c : spelling) {
+        if (c != '_') {
+          stripped.push_back(c);
+        }
+      }
+
+      digits = stripped;
+    }
+
+    const char* begin = digits.data();
+    const char* end = begin + digits.size();
+
+    if (base == 10 && digits.find_first_of(".eE") != std::string_view::npos) {
+      NumberValue value;
+      auto [stop, code] =
+          std::from_chars(begin, end, value.real, std::chars_format::general);
+
+      if (code == std::errc::result_out_of_range) {
+        return invalid(LiteralError::OUT_OF_RANGE);
+      } else if (code != std::errc() || stop != end) {
+        return invalid(LiteralError::MALFORMED);
+      }
+
+      return NumberLiteral{TokenType::FLOAT_LITERAL, value};
+    }
+
+    if (base == 10 && digits.size() > 1 && digits[0] == '0') {
+      base = 8;
+      prefix = 1;
+    }
+
+    if (prefix == digits.size()) {
+      return invalid(LiteralError::MALFORMED);
+    }
+
+    uint64_t magnitude = 0;
+    auto [stop, code] = std::from_chars(begin + prefix, end, magnitude, base);
+
+    if (code == std::errc::result_out_of_range) {
+      return invalid(LiteralError::TOO_LARGE);
+    } else if (code != std::errc() || stop != end) {
+      // A decimal digit past the base, rather than a stray letter
+      const char* wrong = code != std::errc() ? begin + prefix : stop;
+      bool digit = *wrong >= '0' && *wrong <= '9';
+      return invalid(digit ? LiteralError::INVALID_DIGIT
+                           : LiteralError::MALFORMED);
+    }
+
+    if (magnitude > uint64_t(std::numeric_limits<int64_t>::max())) {
+      return invalid(LiteralError::TOO_LARGE);
+    }
+
+    NumberValue value;
+    value.integer = static_cast<int64_t>(magnitude);
+    return NumberLiteral{TokenType::INTEGER_LITERAL, value};
+  }
+
+  const char* describe(LiteralError error) {
+    switch (error) {
+      case LiteralError::NONE:
+        return "is valid";
+      case LiteralError::MALFORMED:
+        return "is malformed";
+      case LiteralError::SEPARATOR:
+        return "has a digit separator not between two digits";
+      case LiteralError::INVALID_DIGIT:
+        return "has a digit invalid in its base";
+      case LiteralError::TOO_LARGE:
+        return "is too large for a 64-bit integer";
+      case LiteralError::OUT_OF_RANGE:
+        return "is out of the range of a double";
+    }
+
+    return "is invalid";
+  }
+
+}  // namespace excerpt
@@ -0,0 +1,210 @@
+#include "excerpt/parallel_tokenizer.hpp"
+#include "excerpt/memory.hpp"
+#include "excerpt/scan.hpp"
+#include "excerpt/tokenizer.hpp"
+#include "excerpt_utils/parallel.hpp"
+
+#include <limits>
+
+namespace excerpt {
+  namespace {
+    // A chunk of the source and the tokens lexed speculatively from its start
+    struct Chunk {
+      size_t begin;        // Where the chunk, and its speculation, begins
+      size_t end;          // Where the next chunk begins
+      TokenBuffer tokens;  // The tokens starting within [begin, end)
+      Interner names;      // The chunk's own names, if interning
+
+      // The lexer's position before token `k`, i.e after token `k - 1`
+      size_t state(size_t k) const {
+        return k == 0 ? begin : tokens.offsets[k - 1] + tokens.lengths[k - 1];
+      }
+    };
+
+    // Split the source into chunks beginning after newlines
+    std::vector<Chunk> split(std::string_view source, size_t count) {
+      const char* begin = source.data();
+      const char* end = begin + source.size();
+
+      std::vector<Chunk> chunks;
+      size_t start = 0;
+
+      for (size_t i = 1; i < count; i++) {
+        const char* newline =
+            scan::find_newline(begin + i * source.size() / count, end);
+        size_t boundary = newline + 1 - begin;
+
+        if (newline != end && boundary > start && boundary < source.size()) {
+          chunks.push_back(Chunk{start, boundary, {}, {}});
+          start = boundary;
+        }
+      }
+
+      // The last chunk runs on to the END token, wherever it is
+      chunks.push_back(
+          Chunk{start, std::numeric_limits<size_t>::max(), {}, {}});
+
+      return chunks;
+    }
+
+    // Lex a chunk as if it began between tokens
+    void speculate(std::string_view source, Chunk& chunk, bool intern) {
+      Tokenizer tokenizer(source);
+      tokenizer.seek(chunk.begin);
+
+      if (intern) {
+        tokenizer.set_interner(&chunk.names);
+      }
+
+      while (true) {
+        Lexeme lexeme = tokenizer.lex();
+        size_t start = lexeme.spelling.data() - source.data();
+
+        if (start >= chunk.end) {
+          return;
+        }
+
+        if (intern) {
+          chunk.tokens.push(lexeme.type, start, lexeme.spelling.length(),
+                            lexeme.symbol, lexeme.value);
+        } else {
+          chunk.tokens.push(lexeme.type, start, lexeme.spelling.length(),
+                            lexeme.value);
+        }
+
+        if (lexeme.type == TokenType::END) {
+          return;
+        }
+      }
+    }
+
+    // Append a chunk's tokens from token `k` on, translating their symbols
+    // from the chunk's names to the global ones. Names are interned in order
+    // of occurrence, so the ids match those of a serial lexer's. Only names
+    // of the tokens kept are, not the whole shard: the tokens before `k`
+    // were lexed again serially, and may have been words of a comment or
+    // string the chunk began inside, which the source never names
+    void adopt(TokenBuffer& result, const Chunk& chunk, size_t k,
+               Interner& interner) {
+      std::vector<SymbolId> remap(chunk.names.size(), NO_SYMBOL);
+
+      for (; k < chunk.tokens.size(); k++) {
+        SymbolId symbol = chunk.tokens.symbols[k];
+
+        if (symbol != NO_SYMBOL) {
+          if (remap[symbol] == NO_SYMBOL) {
+            remap[symbol] = interner.intern(chunk.names.name(symbol));
+          }
+
+          symbol = remap[symbol];
+        }
+
+        result.push(chunk.tokens.types[k], chunk.tokens.offsets[k],
+                    chunk.tokens.lengths[k], symbol, chunk.tokens.values[k]);
+      }
+    }
+  }  // namespace
+
+  TokenBuffer tokenize_parallel(std::string_view source, unsigned threads,
+                                size_t min_chunk_size, Interner* interner) {
+    size_t count =
+        std::min<size_t>(parallel::thread_count(threads),
+                         source.size() / std::max<size_t>(min_chunk_size, 1));
+
+    if (count <= 1) {
+      Tokenizer tokenizer(source);
+      tokenizer.set_interner(interner);
+      return tokenizer.tokenize_all();
+    }
+
+    std::vector<Chunk> chunks = split(source, count);
+
+    // Workers charge their allocations where the caller does
+    memory::Subsystem subsystem = memory::current_subsystem();
+
+    parallel::for_each_index(chunks.size(), [&](size_t i) {
+      memory::Scope scope(subsystem);
+      size_t end = std::min(chunks[i].end, source.size());
+      chunks[i].tokens.reserve((end - chunks[i].begin) / 4 + 1);
+      speculate(source, chunks[i], interner != nullptr);
+    });
+
+    size_t total = 0;
+    for (const auto& chunk : chunks) {
+      total += chunk.tokens.size();
+    }
+
+    TokenBuffer result;
+    result.reserve(total);
+
+    if (interner) {
+      result.symbols.reserve(total);
+    }
+
+    // The lexer is stateless between tokens bar its position, so from the
+    // first position the serial and speculative lexers share, they agree
+    Tokenizer serial(source);
+    serial.set_interner(interner);
+    size_t state = 0;
+
+    for (const auto& chunk : chunks) {
+      // The END token is empty, so the position after it is not a state the
+      // serial lexer can share: it would still have END to lex from there
+      size_t last = chunk.tokens.size();
+      if (last && chunk.tokens.types.back() == TokenType::END) {
+        last--;
+      }
+
+      size_t k = 0;
+
+      while (true) {
+        while (k <= last && chunk.state(k) < state) {
+          k++;
+        }
+
+        if (k <= last && chunk.state(k) == state) {
+          if (interner) {
+            adopt(result, chunk, k, *interner);
+          } else {
+            result.append(chunk.tokens, k);
+          }
+
+          state = chunk.state(chunk.tokens.size());
+          break;
+        }
+
+        // Out of sync, i.e the chunk began inside a comment or literal
+        serial.seek(state);
+
+        Lexeme lexeme = serial.lex();
+        size_t start = lexeme.spelling.data() - source.data();
+
+        if (start >= chunk.end) {
+          break;
+        }
+
+        if (interner) {
+          result.push(lexeme.type, start, lexeme.spelling.length(),
+                      lexeme.symbol, lexeme.value);
+        } else {
+          result.push(lexeme.type, start, lexeme.spelling.length(),
+                      lexeme.value);
+        }
+
+        state = start + lexeme.spelling.length();
+
+        if (lexeme.type == TokenType::END) {
+          return result;
+        }
+      }
+
+      if (result.size() && result.types.back() == TokenType::END) {
+        return result;
+      }
+    }
+
+    // Unreachable: the last chunk always ends with the END token
+    return result;
+  }
+
+}  // namespace excerpt
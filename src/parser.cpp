@@ -0,0 +1,742 @@
+#include "excerpt/parser.hpp"
+#include "excerpt/lexer_tables.hpp"
+#include "excerpt_utils/logger.hpp"
+
+#include <algorithm>
+
+namespace excerpt {
+  namespace {
+    // The precedence of unary operators, above every binary one
+    constexpr uint8_t UNARY_PRECEDENCE = 6;
+
+    // The precedence of a binary operator, or 0 if the token is not one
+    uint8_t binary_precedence(TokenType type) {
+      switch (type) {
+        case TokenType::ASSIGN:
+          return 1;
+
+        case TokenType::EQUAL:
+        case TokenType::NOT_EQUAL:
+          return 2;
+
+        case TokenType::LESS:
+        case TokenType::LESS_EQUAL:
+        case TokenType::GREATER:
+        case TokenType::GREATER_EQUAL:
+          return 3;
+
+        case TokenType::PLUS:
+        case TokenType::MINUS:
+          return 4;
+
+        case TokenType::STAR:
+        case TokenType::SLASH:
+        case TokenType::PERCENT:
+          return 5;
+
+        default:
+          return 0;
+      }
+    }
+
+    bool is_type(TokenType type) {
+      return type == TokenType::INT || type == TokenType::FLOAT ||
+             type == TokenType::CHAR || type == TokenType::BOOL;
+    }
+
+    // Describe an expected token type for a diagnostic
+    std::string describe(TokenType type) {
+      for (const auto& op : OPERATORS) {
+        if (op.type == type) {
+          return "'" + std::string(op.spelling) + "'";
+        }
+      }
+
+      switch (type) {
+        case TokenType::IDENTIFIER:
+          return "an identifier";
+
+        case TokenType::END:
+          return "end of file";
+
+        default:
+          return "'" + TOKEN_STR.at(type) + "'";
+      }
+    }
+  }  // namespace
+
+  Parser::Parser(std::string_view source, std::string name)
+      : source(source),
+        name(std::move(name)),
+        tokenizer(source),
+        lexed(false),
+        manager(source),
+        head(0),
+        count(0),
+        next_token(0),
+        depth(0),
+        failed(false) {
+    // Typical sources average a few bytes per token, and about as many
+    // nodes as tokens
+    _tokens.reserve(source.size() / 4 + 1);
+    _ast.reserve(source.size() / 4 + 1);
+  }
+
+  Parser::Parser(std::string_view source, TokenBuffer tokens,
+                 std::string name)
+      : source(source),
+        name(std::move(name)),
+        tokenizer(source),
+        lexed(true),
+        manager(source),
+        _tokens(std::move(tokens)),
+        head(0),
+        count(0),
+        next_token(0),
+        depth(0),
+        failed(false) {
+    _ast.reserve(_tokens.size());
+  }
+
+  const RingToken& Parser::peek(size_t offset) {
+    while (count <= offset) {
+      fill();
+    }
+
+    return ring[(head + offset) & (RING_SIZE - 1)];
+  }
+
+  uint32_t Parser::advance() {
+    const RingToken& token = peek();
+
+    // Stay on the END token once the source is exhausted
+    if (token.type != TokenType::END) {
+      head = (head + 1) & (RING_SIZE - 1);
+      count--;
+    }
+
+    return token.index;
+  }
+
+  bool Parser::match(TokenType type) {
+    if (peek().type != type) {
+      return false;
+    }
+
+    advance();
+    return true;
+  }
+
+  bool Parser::expect(TokenType type, const char* context) {
+    if (match(type)) {
+      return true;
+    }
+
+    error("expected " + describe(type) + " " + context + ", found " +
+          found());
+    return false;
+  }
+
+  void Parser::fill() {
+    // Lex a token, unless END has been reached, which then repeats
+    if (!lexed && (_tokens.size() == 0 ||
+                   _tokens.types.back() != TokenType::END)) {
+      Lexeme lexeme = tokenizer.lex();
+      _tokens.push(lexeme.type, lexeme.spelling.data() - source.data(),
+                   lexeme.spelling.length(), lexeme.value);
+    }
+
+    uint32_t index = std::min<size_t>(next_token++, _tokens.size() - 1);
+
+    ring[(head + count) & (RING_SIZE - 1)] =
+        RingToken{_tokens.types[index], index, _tokens.offsets[index],
+                  _tokens.lengths[index]};
+    count++;
+  }
+
+  NodeId Parser::error(const std::string& message) {
+    // Only the first error is reported, as parsing stops there
+    if (!failed) {
+      SourceLocation location = manager.location(peek().offset);
+
+      logger::error("{0}:{1}:{2}: {3}", name, location.line, location.column,
+                    message);
+      failed = true;
+    }
+
+    return NO_NODE;
+  }
+
+  std::string Parser::found() {
+    const RingToken& token = peek();
+
+    if (token.type == TokenType::END) {
+      return "end of file";
+    }
+
+    std::string spelling(source.substr(token.offset, token.length));
+
+    if (token.type == TokenType::INVALID) {
+      return "invalid token '" + spelling + "'";
+    }
+
+    return "'" + spelling + "'";
+  }
+
+  NodeId Parser::parse() {
+    size_t base = scratch.size();
+
+    while (peek().type != TokenType::END) {
+      if (!is_type(peek().type)) {
+        return error("expected a function or declaration, found " + found());
+      }
+
+      // A function's name is followed by its parameters
+      NodeId item = peek(2).type == TokenType::LPAREN ? parse_function()
+                                                       : parse_declaration();
+      if (item == NO_NODE) {
+        return NO_NODE;
+      }
+
+      scratch.push_back(item);
+    }
+
+    ListId items = _ast.add_list(std::span(scratch).subspan(base));
+    scratch.resize(base);
+
+    NodeId program = _ast.add(NodeKind::PROGRAM, TokenType::INVALID, 0, items);
+    logger::debug("{0}: parsed {1} tokens into {2} nodes", name,
+                  _tokens.size(), _ast.size());
+
+    return program;
+  }
+
+  NodeId Parser::parse_function() {
+    TokenType type = peek().type;
+    advance();
+
+    if (peek().type != TokenType::IDENTIFIER) {
+      return error("expected a function name, found " + found());
+    }
+
+    uint32_t function = advance();
+    expect(TokenType::LPAREN, "after function name");
+
+    // Parse the parameters
+    size_t base = scratch.size();
+
+    if (!failed && !match(TokenType::RPAREN)) {
+      do {
+        TokenType parameter_type = peek().type;
+        if (!is_type(parameter_type)) {
+          return error("expected a parameter type, found " + found());
+        }
+        advance();
+
+        if (peek().type != TokenType::IDENTIFIER) {
+          return error("expected a parameter name, found " + found());
+        }
+
+        scratch.push_back(
+            _ast.add(NodeKind::PARAMETER, parameter_type, advance()));
+      } while (match(TokenType::COMMA));
+
+      expect(TokenType::RPAREN, "after parameters");
+    }
+
+    if (failed) {
+      return NO_NODE;
+    }
+
+    ListId parameters = _ast.add_list(std::span(scratch).subspan(base));
+    scratch.resize(base);
+
+    if (peek().type != TokenType::LBRACE) {
+      return error("expected '{' before function body, found " + found());
+    }
+
+    NodeId body = parse_block();
+    if (body == NO_NODE) {
+      return NO_NODE;
+    }
+
+    return _ast.add(NodeKind::FUNCTION, type, function, parameters, body);
+  }
+
+  NodeId Parser::parse_declaration() {
+    TokenType type = peek().type;
+    advance();
+
+    if (peek().type != TokenType::IDENTIFIER) {
+      return error("expected a variable name, found " + found());
+    }
+
+    uint32_t variable = advance();
+
+    NodeId initializer = NO_NODE;
+    if (match(TokenType::ASSIGN)) {
+      initializer = parse_expression();
+    }
+
+    if (failed || !expect(TokenType::SEMICOLON, "after declaration")) {
+      return NO_NODE;
+    }
+
+    return _ast.add(NodeKind::DECLARATION, type, variable, initializer);
+  }
+
+  NodeId Parser::parse_statement() {
+    if (depth >= MAX_DEPTH) {
+      return error("statements nested too deeply");
+    }
+
+    TokenType type = peek().type;
+    NodeId result;
+
+    depth++;
+
+    switch (type) {
+      case TokenType::LBRACE:
+        result = parse_block();
+        break;
+
+      case TokenType::IF:
+        result = parse_if();
+        break;
+
+      case TokenType::WHILE:
+        result = parse_while();
+        break;
+
+      case TokenType::FOR:
+        result = parse_for();
+        break;
+
+      case TokenType::RETURN:
+        result = parse_return();
+        break;
+
+      case TokenType::BREAK:
+      case TokenType::CONTINUE: {
+        uint32_t keyword = advance();
+        expect(TokenType::SEMICOLON, type == TokenType::BREAK
+                                         ? "after 'break'"
+                                         : "after 'continue'");
+
+        result = _ast.add(type == TokenType::BREAK ? NodeKind::BREAK
+                                                   : NodeKind::CONTINUE,
+                          TokenType::INVALID, keyword);
+        break;
+      }
+
+      case TokenType::INT:
+      case TokenType::FLOAT:
+      case TokenType::CHAR:
+      case TokenType::BOOL:
+        result = parse_declaration();
+        break;
+
+      case TokenType::SEMICOLON:
+        // An empty statement, as an empty block
+        result = _ast.add(NodeKind::BLOCK, TokenType::INVALID, advance(),
+                          _ast.add_list({}));
+        break;
+
+      default: {
+        uint32_t start = peek().index;
+        NodeId expression = parse_expression();
+
+        expect(TokenType::SEMICOLON, "after expression");
+        result = _ast.add(NodeKind::EXPRESSION, TokenType::INVALID, start,
+                          expression);
+        break;
+      }
+    }
+
+    depth--;
+
+    return failed ? NO_NODE : result;
+  }
+
+  NodeId Parser::parse_block() {
+    uint32_t brace = advance();
+    size_t base = scratch.size();
+
+    while (!match(TokenType::RBRACE)) {
+      if (peek().type == TokenType::END) {
+        return error("expected '}' at end of block, found end of file");
+      }
+
+      NodeId statement = parse_statement();
+      if (statement == NO_NODE) {
+        return NO_NODE;
+      }
+
+      scratch.push_back(statement);
+    }
+
+    ListId statements = _ast.add_list(std::span(scratch).subspan(base));
+    scratch.resize(base);
+
+    return _ast.add(NodeKind::BLOCK, TokenType::INVALID, brace, statements);
+  }
+
+  NodeId Parser::parse_if() {
+    // Each `else if` is an arm of the chain rather than a statement nested
+    // in the `else`, so long chains are not taken for deep nesting; the IF
+    // nodes are linked up, last arm first, once the chain is parsed
+    size_t base = arms.size();
+    NodeId otherwise = NO_NODE;
+
+    while (true) {
+      uint32_t keyword = advance();
+
+      expect(TokenType::LPAREN, "after 'if'");
+      NodeId condition = failed ? NO_NODE : parse_expression();
+      expect(TokenType::RPAREN, "after condition");
+
+      NodeId then = failed ? NO_NODE : parse_statement();
+      arms.push_back(Arm{keyword, condition, then});
+
+      if (failed || !match(TokenType::ELSE)) {
+        break;
+      }
+
+      if (peek().type != TokenType::IF) {
+        otherwise = parse_statement();
+        break;
+      }
+    }
+
+    if (!failed) {
+      for (size_t i = arms.size(); i-- > base;) {
+        otherwise = _ast.add(NodeKind::IF, TokenType::INVALID, arms[i].keyword,
+                             arms[i].condition,
+                             _ast.add_list({arms[i].then, otherwise}));
+      }
+    }
+
+    arms.resize(base);
+    return failed ? NO_NODE : otherwise;
+  }
+
+  NodeId Parser::parse_while() {
+    uint32_t keyword = advance();
+
+    expect(TokenType::LPAREN, "after 'while'");
+    NodeId condition = failed ? NO_NODE : parse_expression();
+    expect(TokenType::RPAREN, "after condition");
+
+    NodeId body = failed ? NO_NODE : parse_statement();
+
+    if (failed) {
+      return NO_NODE;
+    }
+
+    return _ast.add(NodeKind::WHILE, TokenType::INVALID, keyword, condition,
+                    body);
+  }
+
+  NodeId Parser::parse_for() {
+    uint32_t keyword = advance();
+    expect(TokenType::LPAREN, "after 'for'");
+
+    // The initializer is a declaration, an expression or nothing
+    NodeId init = NO_NODE;
+
+    if (failed) {
+      return NO_NODE;
+    } else if (is_type(peek().type)) {
+      init = parse_declaration();
+    } else if (!match(TokenType::SEMICOLON)) {
+      uint32_t start = peek().index;
+      NodeId expression = parse_expression();
+
+      expect(TokenType::SEMICOLON, "after loop initializer");
+      init = _ast.add(NodeKind::EXPRESSION, TokenType::INVALID, start,
+                      expression);
+    }
+
+    NodeId condition = NO_NODE;
+    if (!failed && peek().type != TokenType::SEMICOLON) {
+      condition = parse_expression();
+    }
+    expect(TokenType::SEMICOLON, "after loop condition");
+
+    NodeId step = NO_NODE;
+    if (!failed && peek().type != TokenType::RPAREN) {
+      step = parse_expression();
+    }
+    expect(TokenType::RPAREN, "after loop step");
+
+    NodeId body = failed ? NO_NODE : parse_statement();
+
+    if (failed) {
+      return NO_NODE;
+    }
+
+    return _ast.add(NodeKind::FOR, TokenType::INVALID, keyword,
+                    _ast.add_list({init, condition, step}), body);
+  }
+
+  NodeId Parser::parse_return() {
+    uint32_t keyword = advance();
+
+    NodeId value = NO_NODE;
+    if (peek().type != TokenType::SEMICOLON) {
+      value = parse_expression();
+    }
+
+    if (failed || !expect(TokenType::SEMICOLON, "after return value")) {
+      return NO_NODE;
+    }
+
+    return _ast.add(NodeKind::RETURN, TokenType::INVALID, keyword, value);
+  }
+
+  NodeId Parser::parse_expression() {
+    // Expressions never nest through recursion, so the stacks start empty
+    frames.clear();
+    operands.clear();
+
+    bool want_operand = true;
+
+    while (true) {
+      const RingToken& token = peek();
+
+      if (want_operand) {
+        NodeKind kind;
+
+        switch (token.type) {
+          case TokenType::PLUS:
+          case TokenType::MINUS:
+            frames.push_back(Frame{Frame::UNARY, token.type, UNARY_PRECEDENCE,
+                                   advance(), 0});
+            continue;
+
+          case TokenType::LPAREN:
+            frames.push_back(
+                Frame{Frame::GROUP, TokenType::INVALID, 0, advance(), 0});
+            continue;
+
+          case TokenType::INTEGER_LITERAL:
+            kind = NodeKind::INTEGER;
+            break;
+
+          case TokenType::FLOAT_LITERAL:
+            kind = NodeKind::FLOAT;
+            break;
+
+          case TokenType::STRING_LITERAL:
+            kind = NodeKind::STRING;
+            break;
+
+          case TokenType::TRUE:
+          case TokenType::FALSE:
+            kind = NodeKind::BOOLEAN;
+            break;
+
+          case TokenType::IDENTIFIER:
+            kind = NodeKind::NAME;
+            break;
+
+          default:
+            return error("expected an expression, found " + found());
+        }
+
+        operands.push_back(_ast.add(kind, TokenType::INVALID, advance()));
+        want_operand = false;
+        continue;
+      }
+
+      if (uint8_t precedence = binary_precedence(token.type)) {
+        reduce(precedence, token.type == TokenType::ASSIGN);
+
+        frames.push_back(
+            Frame{Frame::BINARY, token.type, precedence, advance(), 0});
+        want_operand = true;
+        continue;
+      }
+
+      if (token.type == TokenType::LPAREN) {
+        // A call of the operand just parsed
+        frames.push_back(Frame{Frame::CALL, TokenType::INVALID, 0, advance(),
+                               operands.size()});
+
+        if (match(TokenType::RPAREN)) {
+          finish_call();
+        } else {
+          want_operand = true;
+        }
+
+        continue;
+      }
+
+      if (token.type == TokenType::RPAREN || token.type == TokenType::COMMA) {
+        reduce(1, false);
+
+        // Otherwise the token belongs to an enclosing statement
+        if (!frames.empty()) {
+          if (token.type == TokenType::COMMA) {
+            if (frames.back().kind != Frame::CALL) {
+              return error("expected ')', found ','");
+            }
+
+            advance();
+            want_operand = true;
+            continue;
+          }
+
+          advance();
+
+          if (frames.back().kind == Frame::CALL) {
+            finish_call();
+          } else {
+            frames.pop_back();
+          }
+
+          continue;
+        }
+      }
+
+      break;
+    }
+
+    reduce(1, false);
+
+    if (!frames.empty()) {
+      return error("expected ')' to close '(', found " + found());
+    }
+
+    return failed ? NO_NODE : operands.back();
+  }
+
+  void Parser::reduce(uint8_t precedence, bool right) {
+    while (!frames.empty()) {
+      const Frame& frame = frames.back();
+
+      // Groups and calls have no precedence, so they stop reduction
+      if (frame.precedence < precedence ||
+          (frame.precedence == precedence && right)) {
+        return;
+      }
+
+      NodeId rhs = operands.back();
+      operands.pop_back();
+
+      if (frame.kind == Frame::UNARY) {
+        operands.push_back(
+            _ast.add(NodeKind::UNARY, frame.op, frame.token, rhs));
+      } else if (frame.op == TokenType::ASSIGN) {
+        NodeId& lhs = operands.back();
+
+        if (_ast.node(lhs).kind != NodeKind::NAME) {
+          error("invalid assignment target");
+        }
+
+        lhs = _ast.add(NodeKind::ASSIGN, TokenType::INVALID, frame.token, lhs,
+                       rhs);
+      } else {
+        NodeId& lhs = operands.back();
+        lhs = _ast.add(NodeKind::BINARY, frame.op, frame.token, lhs, rhs);
+      }
+
+      frames.pop_back();
+    }
+  }
+
+  void Parser::finish_call() {
+    size_t base = frames.back().base;
+    uint32_t paren = frames.back().token;
+    frames.pop_back();
+
+    // The callee sits below the arguments
+    ListId arguments = _ast.add_list(std::span(operands).subspan(base));
+    operands.resize(base);
+
+    NodeId& callee = operands.back();
+    callee = _ast.add(NodeKind::CALL, TokenType::INVALID, paren, callee,
+                      arguments);
+  }
+
+  std::string Parser::dump(NodeId id) const {
+    if (id == NO_NODE) {
+      return "_";
+    }
+
+    const Node& node = _ast.node(id);
+    std::string token(spelling(node.token));
+
+    // Render the nodes of a list, each preceded by a space
+    auto list = [&](ListId list) {
+      std::string result;
+      for (NodeId item : _ast.list(list)) {
+        result += " " + dump(item);
+      }
+      return result;
+    };
+
+    switch (node.kind) {
+      case NodeKind::INTEGER:
+      case NodeKind::FLOAT:
+      case NodeKind::STRING:
+      case NodeKind::BOOLEAN:
+      case NodeKind::NAME:
+        return token;
+
+      case NodeKind::UNARY:
+        return "(" + token + " " + dump(node.lhs) + ")";
+
+      case NodeKind::BINARY:
+      case NodeKind::ASSIGN:
+        return "(" + token + " " + dump(node.lhs) + " " + dump(node.rhs) + ")";
+
+      case NodeKind::CALL:
+        return "(call " + dump(node.lhs) + list(node.rhs) + ")";
+
+      case NodeKind::EXPRESSION:
+        return dump(node.lhs) + ";";
+
+      case NodeKind::DECLARATION:
+        return "(" + TOKEN_STR.at(node.op) + " " + token +
+               (node.lhs == NO_NODE ? "" : " " + dump(node.lhs)) + ")";
+
+      case NodeKind::BLOCK:
+        return "{" + list(node.lhs) + " }";
+
+      case NodeKind::IF:
+        return "(if " + dump(node.lhs) + list(node.rhs) + ")";
+
+      case NodeKind::WHILE:
+        return "(while " + dump(node.lhs) + " " + dump(node.rhs) + ")";
+
+      case NodeKind::FOR:
+        return "(for" + list(node.lhs) + " " + dump(node.rhs) + ")";
+
+      case NodeKind::RETURN:
+        return node.lhs == NO_NODE ? "(return)"
+                                   : "(return " + dump(node.lhs) + ")";
+
+      case NodeKind::BREAK:
+        return "(break)";
+
+      case NodeKind::CONTINUE:
+        return "(continue)";
+
+      case NodeKind::PARAMETER:
+        return "(" + TOKEN_STR.at(node.op) + " " + token + ")";
+
+      case NodeKind::FUNCTION:
+        return "(function " + TOKEN_STR.at(node.op) + " " + token + " (" +
+               list(node.lhs).substr(std::min<size_t>(
+                   1, _ast.list(node.lhs).size())) +
+               ") " + dump(node.rhs) + ")";
+
+      case NodeKind::PROGRAM:
+        return "(program" + list(node.lhs) + ")";
+    }
+
+    return "?";
+  }
+
+}  // namespace excerpt
@@ -0,0 +1,369 @@
+#include "excerpt/scan.hpp"
+#include "excerpt/lexer_tables.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define EXCERPT_SCAN_X86
+#endif
+
+namespace excerpt::scan {
+  namespace {
+    // Scalar kernels, also used for the tails of the vectorized ones
+
+    template <uint8_t Classes>
+    const char* scalar_skip(const char* begin, const char* end) {
+      while (begin != end && has_class(*begin, Classes)) {
+        begin++;
+      }
+
+      return begin;
+    }
+
+    const char* scalar_find_newline(const char* begin, const char* end) {
+      while (begin != end && *begin != '\n') {
+        begin++;
+      }
+
+      return begin;
+    }
+
+    const char* scalar_find_comment_end(const char* begin, const char* end) {
+      for (; end - begin >= 2; begin++) {
+        if (begin[0] == '*' && begin[1] == '/') {
+          return begin;
+        }
+      }
+
+      return end;
+    }
+
+    const char* scalar_find_string_end(const char* begin, const char* end) {
+      while (begin != end && *begin != '"' && *begin != '\\' &&
+             *begin != '\0') {
+        begin++;
+      }
+
+      return begin;
+    }
+
+    size_t scalar_count_newlines(const char* begin, const char* end) {
+      size_t count = 0;
+
+      for (; begin != end; begin++) {
+        count += *begin == '\n';
+      }
+
+      return count;
+    }
+
+    const Kernels SCALAR_KERNELS = {
+        scalar_skip<CHAR_SPACE>,  scalar_skip<CHAR_IDENT>,
+        scalar_skip<CHAR_DIGIT>,  scalar_find_newline,
+        scalar_find_comment_end, scalar_find_string_end,
+        scalar_count_newlines};
+
+#ifdef EXCERPT_SCAN_X86
+    // SSE2 kernels, 16 bytes at a time
+
+#define EXCERPT_SSE2 __attribute__((target("sse2")))
+
+    // Bytes of `block` within [lo, lo + span], as a vector mask
+    EXCERPT_SSE2 inline __m128i sse2_in_range(__m128i block, char lo,
+                                              char span) {
+      __m128i shifted = _mm_sub_epi8(block, _mm_set1_epi8(lo));
+      return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(span)),
+                            shifted);
+    }
+
+    EXCERPT_SSE2 inline __m128i sse2_space(__m128i block) {
+      return _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')),
+                          sse2_in_range(block, '\t', '\r' - '\t'));
+    }
+
+    EXCERPT_SSE2 inline __m128i sse2_digit(__m128i block) {
+      return sse2_in_range(block, '0', 9);
+    }
+
+    EXCERPT_SSE2 inline __m128i sse2_ident(__m128i block) {
+      // Setting bit 5 folds upper case letters onto lower case ones
+      __m128i folded = _mm_or_si128(block, _mm_set1_epi8(0x20));
+
+      return _mm_or_si128(_mm_or_si128(sse2_in_range(folded, 'a', 'z' - 'a'),
+                                       sse2_digit(block)),
+                          _mm_cmpeq_epi8(block, _mm_set1_epi8('_')));
+    }
+
+    EXCERPT_SSE2 inline __m128i sse2_newline(__m128i block) {
+      return _mm_cmpeq_epi8(block, _mm_set1_epi8('\n'));
+    }
+
+    EXCERPT_SSE2 inline __m128i sse2_string_end(__m128i block) {
+      return _mm_or_si128(
+          _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('"')),
+                       _mm_cmpeq_epi8(block, _mm_set1_epi8('\\'))),
+          _mm_cmpeq_epi8(block, _mm_setzero_si128()));
+    }
+
+    template <__m128i (*Match)(__m128i), Scanner Tail>
+    EXCERPT_SSE2 const char* sse2_skip(const char* begin, const char* end) {
+      for (; end - begin >= 16; begin += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)begin);
+        unsigned mask = ~_mm_movemask_epi8(Match(block)) & 0xFFFF;
+
+        if (mask) {
+          return begin + __builtin_ctz(mask);
+        }
+      }
+
+      return Tail(begin, end);
+    }
+
+    template <__m128i (*Match)(__m128i), Scanner Tail>
+    EXCERPT_SSE2 const char* sse2_find(const char* begin, const char* end) {
+      for (; end - begin >= 16; begin += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)begin);
+        unsigned mask = _mm_movemask_epi8(Match(block));
+
+        if (mask) {
+          return begin + __builtin_ctz(mask);
+        }
+      }
+
+      return Tail(begin, end);
+    }
+
+    EXCERPT_SSE2 const char* sse2_find_comment_end(const char* begin,
+                                                   const char* end) {
+      // Each block is compared with itself shifted by one byte
+      for (; end - begin >= 17; begin += 16) {
+        __m128i stars = _mm_cmpeq_epi8(
+            _mm_loadu_si128((const __m128i*)begin), _mm_set1_epi8('*'));
+        __m128i slashes = _mm_cmpeq_epi8(
+            _mm_loadu_si128((const __m128i*)(begin + 1)), _mm_set1_epi8('/'));
+        unsigned mask = _mm_movemask_epi8(_mm_and_si128(stars, slashes));
+
+        if (mask) {
+          return begin + __builtin_ctz(mask);
+        }
+      }
+
+      return scalar_find_comment_end(begin, end);
+    }
+
+    EXCERPT_SSE2 size_t sse2_count_newlines(const char* begin,
+                                            const char* end) {
+      size_t count = 0;
+
+      for (; end - begin >= 16; begin += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)begin);
+        count += __builtin_popcount(_mm_movemask_epi8(sse2_newline(block)));
+      }
+
+      return count + scalar_count_newlines(begin, end);
+    }
+
+    const Kernels SSE2_KERNELS = {
+        sse2_skip<sse2_space, scalar_skip<CHAR_SPACE>>,
+        sse2_skip<sse2_ident, scalar_skip<CHAR_IDENT>>,
+        sse2_skip<sse2_digit, scalar_skip<CHAR_DIGIT>>,
+        sse2_find<sse2_newline, scalar_find_newline>,
+        sse2_find_comment_end,
+        sse2_find<sse2_string_end, scalar_find_string_end>,
+        sse2_count_newlines};
+
+    // AVX2 kernels, 32 bytes at a time
+
+#define EXCERPT_AVX2 __attribute__((target("avx2")))
+
+    // Bytes of `block` within [lo, lo + span], as a vector mask
+    EXCERPT_AVX2 inline __m256i avx2_in_range(__m256i block, char lo,
+                                              char span) {
+      __m256i shifted = _mm256_sub_epi8(block, _mm256_set1_epi8(lo));
+      return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(span)),
+                               shifted);
+    }
+
+    EXCERPT_AVX2 inline __m256i avx2_space(__m256i block) {
+      return _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')),
+                             avx2_in_range(block, '\t', '\r' - '\t'));
+    }
+
+    EXCERPT_AVX2 inline __m256i avx2_digit(__m256i block) {
+      return avx2_in_range(block, '0', 9);
+    }
+
+    EXCERPT_AVX2 inline __m256i avx2_ident(__m256i block) {
+      // Setting bit 5 folds upper case letters onto lower case ones
+      __m256i folded = _mm256_or_si256(block, _mm256_set1_epi8(0x20));
+
+      return _mm256_or_si256(
+          _mm256_or_si256(avx2_in_range(folded, 'a', 'z' - 'a'),
+                          avx2_digit(block)),
+          _mm256_cmpeq_epi8(block, _mm256_set1_epi8('_')));
+    }
+
+    EXCERPT_AVX2 inline __m256i avx2_newline(__m256i block) {
+      return _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n'));
+    }
+
+    EXCERPT_AVX2 inline __m256i avx2_string_end(__m256i block) {
+      return _mm256_or_si256(
+          _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('"')),
+                          _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\\'))),
+          _mm256_cmpeq_epi8(block, _mm256_setzero_si256()));
+    }
+
+    template <__m256i (*Match)(__m256i), Scanner Tail>
+    EXCERPT_AVX2 const char* avx2_skip(const char* begin, const char* end) {
+      for (; end - begin >= 32; begin += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)begin);
+        unsigned mask =
+            ~static_cast<unsigned>(_mm256_movemask_epi8(Match(block)));
+
+        if (mask) {
+          return begin + __builtin_ctz(mask);
+        }
+      }
+
+      return Tail(begin, end);
+    }
+
+    template <__m256i (*Match)(__m256i), Scanner Tail>
+    EXCERPT_AVX2 const char* avx2_find(const char* begin, const char* end) {
+      for (; end - begin >= 32; begin += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)begin);
+        unsigned mask = _mm256_movemask_epi8(Match(block));
+
+        if (mask) {
+          return begin + __builtin_ctz(mask);
+        }
+      }
+
+      return Tail(begin, end);
+    }
+
+    EXCERPT_AVX2 const char* avx2_find_comment_end(const char* begin,
+                                                   const char* end) {
+      // Each block is compared with itself shifted by one byte
+      for (; end - begin >= 33; begin += 32) {
+        __m256i stars = _mm256_cmpeq_epi8(
+            _mm256_loadu_si256((const __m256i*)begin), _mm256_set1_epi8('*'));
+        __m256i slashes =
+            _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(begin + 1)),
+                              _mm256_set1_epi8('/'));
+        unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(stars, slashes));
+
+        if (mask) {
+          return begin + __builtin_ctz(mask);
+        }
+      }
+
+      return sse2_find_comment_end(begin, end);
+    }
+
+    EXCERPT_AVX2 size_t avx2_count_newlines(const char* begin,
+                                            const char* end) {
+      size_t count = 0;
+
+      for (; end - begin >= 32; begin += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)begin);
+        count += __builtin_popcount(_mm256_movemask_epi8(avx2_newline(block)));
+      }
+
+      return count + sse2_count_newlines(begin, end);
+    }
+
+    const Kernels AVX2_KERNELS = {
+        avx2_skip<avx2_space, sse2_skip<sse2_space, scalar_skip<CHAR_SPACE>>>,
+        avx2_skip<avx2_ident, sse2_skip<sse2_ident, scalar_skip<CHAR_IDENT>>>,
+        avx2_skip<avx2_digit, sse2_skip<sse2_digit, scalar_skip<CHAR_DIGIT>>>,
+        avx2_find<avx2_newline, sse2_find<sse2_newline, scalar_find_newline>>,
+        avx2_find_comment_end,
+        avx2_find<avx2_string_end,
+                  sse2_find<sse2_string_end, scalar_find_string_end>>,
+        avx2_count_newlines};
+#endif
+
+    const Kernels& active() {
+      static const Kernels& kernels = scan::kernels(active_isa());
+      return kernels;
+    }
+  }  // namespace
+
+  bool supported(Isa isa) {
+#ifdef EXCERPT_SCAN_X86
+    // Kernels may be selected before the CPU model has been initialized
+    __builtin_cpu_init();
+#endif
+
+    switch (isa) {
+      case Isa::SCALAR:
+        return true;
+
+#ifdef EXCERPT_SCAN_X86
+      case Isa::SSE2:
+        return __builtin_cpu_supports("sse2");
+
+      case Isa::AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+
+      default:
+        return false;
+    }
+  }
+
+  const Kernels& kernels(Isa isa) {
+    switch (isa) {
+#ifdef EXCERPT_SCAN_X86
+      case Isa::SSE2:
+        return SSE2_KERNELS;
+
+      case Isa::AVX2:
+        return AVX2_KERNELS;
+#endif
+
+      default:
+        return SCALAR_KERNELS;
+    }
+  }
+
+  Isa active_isa() {
+    for (Isa isa : {Isa::AVX2, Isa::SSE2}) {
+      if (supported(isa)) {
+        return isa;
+      }
+    }
+
+    return Isa::SCALAR;
+  }
+
+  const char* skip_space(const char* begin, const char* end) {
+    return active().skip_space(begin, end);
+  }
+
+  const char* skip_ident(const char* begin, const char* end) {
+    return active().skip_ident(begin, end);
+  }
+
+  const char* skip_digits(const char* begin, const char* end) {
+    return active().skip_digits(begin, end);
+  }
+
+  const char* find_newline(const char* begin, const char* end) {
+    return active().find_newline(begin, end);
+  }
+
+  const char* find_comment_end(const char* begin, const char* end) {
+    return active().find_comment_end(begin, end);
+  }
+
+  const char* find_string_end(const char* begin, const char* end) {
+    return active().find_string_end(begin, end);
+  }
+
+  size_t count_newlines(const char* begin, const char* end) {
+    return active().count_newlines(begin, end);
+  }
+
+}  // namespace excerpt::scan
@@ -0,0 +1,121 @@
+#include "excerpt/source_buffer.hpp"
+#include "excerpt_utils/logger.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace excerpt {
+  namespace {
+    // Token offsets are 32-bit, which bounds the size of a source
+    constexpr size_t MAX_SOURCE_SIZE = UINT32_MAX;
+
+    // Reads the rest of a file descriptor into a string
+    bool read_all(int fd, std::string& text) {
+      char chunk[1 << 16];
+
+      while (true) {
+        ssize_t count = ::read(fd, chunk, sizeof(chunk));
+
+        if (count == 0) {
+          return true;
+        } else if (count < 0) {
+          if (errno == EINTR) continue;
+          return false;
+        }
+
+        text.append(chunk, count);
+      }
+    }
+  }  // namespace
+
+  std::shared_ptr<SourceBuffer> SourceBuffer::open(const std::string& path) {
+    bool is_stdin = path == "-";
+    int fd = is_stdin ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY);
+
+    if (fd < 0) {
+      logger::error("{0}: {1}", path, std::strerror(errno));
+      return nullptr;
+    }
+
+    std::shared_ptr<SourceBuffer> buffer(
+        new SourceBuffer(is_stdin ? "<stdin>" : path));
+
+    struct stat info;
+    bool regular = ::fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+
+    if (regular && static_cast<size_t>(info.st_size) > MAX_SOURCE_SIZE) {
+      logger::error("{0}: file is too large", path);
+      if (!is_stdin) ::close(fd);
+      return nullptr;
+    }
+
+    // Map regular, non-empty files; empty ones cannot be mapped
+    if (regular && info.st_size > 0) {
+      void* mapping =
+          ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+      if (mapping != MAP_FAILED) {
+        // The lexer reads the file front to back exactly once
+        ::madvise(mapping, info.st_size, MADV_SEQUENTIAL);
+
+        buffer->data = static_cast<const char*>(mapping);
+        buffer->size = info.st_size;
+        buffer->is_mapped = true;
+
+        if (!is_stdin) ::close(fd);
+        return buffer;
+      }
+    }
+
+    // Fall back to reading the whole file, i.e for pipes
+    auto text = std::make_shared<std::string>();
+    if (regular) {
+      text->reserve(info.st_size);
+    }
+
+    bool ok = read_all(fd, *text);
+    int error = errno;
+
+    if (!is_stdin) ::close(fd);
+
+    if (!ok) {
+      logger::error("{0}: {1}", path, std::strerror(error));
+      return nullptr;
+    }
+
+    if (text->size() > MAX_SOURCE_SIZE) {
+      logger::error("{0}: file is too large", path);
+      return nullptr;
+    }
+
+    buffer->data = text->data();
+    buffer->size = text->size();
+    buffer->owned = std::move(text);
+
+    return buffer;
+  }
+
+  std::shared_ptr<SourceBuffer> SourceBuffer::from_string(
+      std::shared_ptr<const std::string> text, const std::string& name) {
+    std::shared_ptr<SourceBuffer> buffer(new SourceBuffer(name));
+
+    buffer->data = text->data();
+    buffer->size = text->size();
+    buffer->owned = std::move(text);
+
+    return buffer;
+  }
+
+  SourceBuffer::~SourceBuffer() {
+    if (is_mapped) {
+      ::munmap(const_cast<char*>(data), size);
+    }
+  }
+
+}  // namespace excerpt
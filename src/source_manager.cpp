@@ -0,0 +1,76 @@
+#include "excerpt/source_manager.hpp"
+#include "excerpt/scan.hpp"
+#include "excerpt_utils/parallel.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace excerpt {
+  namespace {
+    // Chunks smaller than this are not worth a thread
+    constexpr size_t MIN_CHUNK_SIZE = 1024 * 1024;
+  }  // namespace
+
+  SourceManager::SourceManager(std::string_view source)
+      : source(source), indexed(false) {}
+
+  SourceLocation SourceManager::location(uint32_t offset) const {
+    const auto& lines = line_starts();
+
+    // The last line starting at or before the offset
+    auto it = std::upper_bound(lines.begin(), lines.end(), offset) - 1;
+
+    return SourceLocation{static_cast<uint32_t>(it - lines.begin()) + 1,
+                          offset - *it + 1};
+  }
+
+  const std::vector<uint32_t>& SourceManager::line_starts() const {
+    if (!indexed) {
+      index_lines(1);
+    }
+
+    return starts;
+  }
+
+  void SourceManager::index_lines(unsigned threads) const {
+    if (indexed) {
+      return;
+    }
+
+    const char* begin = source.data();
+    size_t count = std::min<size_t>(parallel::thread_count(threads),
+                                    source.size() / MIN_CHUNK_SIZE + 1);
+
+    // Chunk `i` covers [bounds[i], bounds[i + 1])
+    std::vector<size_t> bounds(count + 1);
+    for (size_t i = 0; i <= count; i++) {
+      bounds[i] = i * source.size() / count;
+    }
+
+    std::vector<size_t> firsts(count + 1);
+    parallel::for_each_index(count, [&](size_t i) {
+      firsts[i + 1] =
+          scan::count_newlines(begin + bounds[i], begin + bounds[i + 1]);
+    });
+
+    // The index of the first line starting in each chunk, after line 0
+    firsts[0] = 1;
+    std::partial_sum(firsts.begin(), firsts.end(), firsts.begin());
+
+    starts.resize(firsts[count]);
+    starts[0] = 0;
+
+    parallel::for_each_index(count, [&](size_t i) {
+      const char* end = begin + bounds[i + 1];
+      size_t line = firsts[i];
+
+      for (const char* ch = scan::find_newline(begin + bounds[i], end);
+           ch != end; ch = scan::find_newline(ch + 1, end)) {
+        starts[line++] = ch + 1 - begin;
+      }
+    });
+
+    indexed = true;
+  }
+
+}  // namespace excerpt
@@ -0,0 +1,184 @@
+#include "excerpt/stream_tokenizer.hpp"
+#include "excerpt/lexer_tables.hpp"
+#include "excerpt/scan.hpp"
+#include "excerpt/string_literal.hpp"
+#include "excerpt/tokenizer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace excerpt {
+  namespace {
+    // How far past the end of a token lexing it may look, i.e the digit
+    // after "1." or the rest of a longer operator
+    constexpr size_t LOOKAHEAD = std::max<size_t>(2, OperatorDfa::MAX_LENGTH);
+  }  // namespace
+
+  StreamTokenizer::StreamTokenizer(std::istream& input, size_t window_size)
+      : input(input),
+        eof(false),
+        window(std::max<size_t>(window_size, 1)),
+        filled(0),
+        consumed(0),
+        base(0),
+        skipping(Skipping::CODE),
+        finished(false),
+        line(1),
+        column(1) {}
+
+  StreamToken StreamTokenizer::next() {
+    while (true) {
+      if (finished) {
+        return StreamToken{TokenType::END, "", base + consumed, 0, line,
+                           column};
+      }
+
+      if (!skip()) {
+        refill();
+        continue;
+      }
+
+      // Lex one token with the same rules as whole-buffer lexing
+      Tokenizer tokenizer(std::string_view(window.data(), filled));
+      tokenizer.seek(consumed);
+
+      Lexeme lexeme = tokenizer.lex();
+      size_t start = lexeme.spelling.data() - window.data();
+      size_t end = start + lexeme.spelling.size();
+
+      // The token, or what decided where it ends, may lie past the window
+      if (!eof && end + LOOKAHEAD > filled) {
+        refill();
+        continue;
+      }
+
+      // A string's escapes are decoded aside, since the window only holds
+      // its spelling
+      std::string_view value = lexeme.type == TokenType::STRING_LITERAL
+                                   ? string_value(lexeme.spelling, decoded)
+                                   : lexeme.spelling;
+
+      StreamToken token{lexeme.type,
+                        value,
+                        base + start,
+                        static_cast<uint32_t>(lexeme.spelling.size()),
+                        line,
+                        column,
+                        lexeme.value};
+
+      consume(end);
+
+      // END is also produced at a NUL byte, where whole-buffer lexing stops
+      finished = token.type == TokenType::END;
+
+      return token;
+    }
+  }
+
+  bool StreamTokenizer::skip() {
+    const char* begin = window.data();
+    const char* end = begin + filled;
+
+    while (true) {
+      const char* current = begin + consumed;
+
+      switch (skipping) {
+        case Skipping::CODE: {
+          current = scan::skip_space(current, end);
+          consume(current - begin);
+
+          if (current == end) {
+            return eof;
+          }
+
+          // Deciding whether a slash begins a comment takes one more byte
+          if (*current == '/') {
+            if (current + 1 == end) {
+              return eof;
+            } else if (current[1] == '/') {
+              consume(current + 2 - begin);
+              skipping = Skipping::LINE_COMMENT;
+              continue;
+            } else if (current[1] == '*') {
+              consume(current + 2 - begin);
+              skipping = Skipping::BLOCK_COMMENT;
+              continue;
+            }
+          }
+
+          return true;
+        }
+
+        case Skipping::LINE_COMMENT: {
+          const char* newline = scan::find_newline(current, end);
+          consume(newline - begin);
+
+          if (newline == end) {
+            return eof;
+          }
+
+          skipping = Skipping::CODE;
+          break;
+        }
+
+        case Skipping::BLOCK_COMMENT: {
+          const char* close = scan::find_comment_end(current, end);
+
+          if (close == end) {
+            if (eof) {
+              // Unclosed multi-line comment
+              consume(filled);
+              return true;
+            }
+
+            // Keep the last byte, which may be the star of the closing
+            consume(std::max(current, end - 1) - begin);
+            return false;
+          }
+
+          consume(close + 2 - begin);
+          skipping = Skipping::CODE;
+          break;
+        }
+      }
+    }
+  }
+
+  void StreamTokenizer::consume(size_t target) {
+    const char* begin = window.data() + consumed;
+    const char* end = window.data() + target;
+
+    size_t newlines = scan::count_newlines(begin, end);
+    if (newlines == 0) {
+      column += target - consumed;
+    } else {
+      // Columns restart after the last newline consumed
+      size_t last = std::string_view(begin, end - begin).rfind('\n');
+
+      line += newlines;
+      column = target - consumed - last;
+    }
+
+    consumed = target;
+  }
+
+  void StreamTokenizer::refill() {
+    // Slide the unconsumed bytes to the front of the window
+    std::memmove(window.data(), window.data() + consumed, filled - consumed);
+    base += consumed;
+    filled -= consumed;
+    consumed = 0;
+
+    // A full window holds a single token, which needs more room
+    if (filled == window.size()) {
+      window.resize(window.size() * 2);
+    }
+
+    input.read(window.data() + filled, window.size() - filled);
+    filled += input.gcount();
+
+    // A short read means the stream is exhausted (or failed)
+    eof = !input;
+  }
+
+}  // namespace excerpt
@@ -0,0 +1,173 @@
+#include "excerpt/string_literal.hpp"
+
+namespace excerpt {
+  namespace {
+    // The value of a hexadecimal digit, or -1 if the character is not one
+    int hex_value(char c) {
+      if (c >= '0' && c <= '9') {
+        return c - '0';
+      }
+
+      char lower = c | 0x20;
+      if (lower >= 'a' && lower <= 'f') {
+        return lower - 'a' + 10;
+      }
+
+      return -1;
+    }
+
+    // Appends a code point in UTF-8
+    void append_utf8(std::string& text, uint32_t code_point) {
+      if (code_point < 0x80) {
+        text.push_back(static_cast<char>(code_point));
+      } else if (code_point < 0x800) {
+        text.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+      } else if (code_point < 0x10000) {
+        text.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        text.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+      } else {
+        text.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        text.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+      }
+    }
+
+    Escape read_hex(std::string_view text) {
+      int high = text.size() > 2 ? hex_value(text[2]) : -1;
+      int low = text.size() > 3 ? hex_value(text[3]) : -1;
+
+      if (high < 0 || low < 0) {
+        return Escape{2, 0, StringError::HEX_ESCAPE};
+      }
+
+      return Escape{4, static_cast<uint32_t>(high * 16 + low)};
+    }
+
+    Escape read_unicode(std::string_view text) {
+      const Escape invalid{2, 0, StringError::UNICODE_ESCAPE};
+
+      if (text.size() < 3 || text[2] != '{') {
+        return invalid;
+      }
+
+      uint32_t code_point = 0;
+      size_t i = 3;
+
+      for (; i < text.size() && i < 9 && hex_value(text[i]) >= 0; i++) {
+        code_point = code_point * 16 + hex_value(text[i]);
+      }
+
+      // One to six digits, closed, naming a character that is not a
+      // surrogate, which UTF-8 cannot encode alone
+      if (i == 3 || i == text.size() || text[i] != '}' ||
+          code_point > 0x10FFFF ||
+          (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+        return invalid;
+      }
+
+      return Escape{i + 1, code_point};
+    }
+  }  // namespace
+
+  Escape read_escape(std::string_view text) {
+    // A NUL ends the source, so is never part of an escape
+    if (text.size() < 2 || text[1] == '\0') {
+      return Escape{1, 0, StringError::UNKNOWN_ESCAPE};
+    }
+
+    switch (text[1]) {
+      case 'n':
+        return Escape{2, '\n'};
+      case 't':
+        return Escape{2, '\t'};
+      case 'r':
+        return Escape{2, '\r'};
+      case '0':
+        return Escape{2, '\0'};
+      case '\\':
+      case '"':
+        return Escape{2, static_cast<uint32_t>(text[1])};
+      case 'x':
+        return read_hex(text);
+      case 'u':
+        return read_unicode(text);
+      default:
+        return Escape{2, 0, StringError::UNKNOWN_ESCAPE};
+    }
+  }
+
+  StringError check_string(std::string_view spelling) {
+    for (size_t i = 1; i < spelling.size(); i++) {
+      if (spelling[i] == '"') {
+        return StringError::NONE;
+      } else if (spelling[i] == '\\') {
+        Escape escape = read_escape(spelling.substr(i));
+
+        if (escape.error != StringError::NONE) {
+          return escape.error;
+        }
+
+        i += escape.length - 1;
+      }
+    }
+
+    return StringError::UNTERMINATED;
+  }
+
+  std::string_view string_value(std::string_view spelling,
+                                std::string& storage) {
+    std::string_view value = spelling.substr(1, spelling.size() - 2);
+    size_t backslash = value.find('\\');
+
+    if (backslash == std::string_view::npos) {
+      return value;
+    }
+
+    storage.assign(value.substr(0, backslash));
+
+    for (size_t i = backslash; i < value.size();) {
+      size_t next = value.find('\\', i);
+
+      if (next != i) {
+        next = next == std::string_view::npos ? value.size() : next;
+        storage.append(value.substr(i, next - i));
+        i = next;
+        continue;
+      }
+
+      Escape escape = read_escape(value.substr(i));
+
+      // A `\xNN` is a byte, which need not be a whole character
+      if (value[i + 1] == 'x') {
+        storage.push_back(static_cast<char>(escape.code_point));
+      } else {
+        append_utf8(storage, escape.code_point);
+      }
+
+      i += escape.length;
+    }
+
+    return storage;
+  }
+
+  const char* describe(StringError error) {
+    switch (error) {
+      case StringError::NONE:
+        return "is valid";
+      case StringError::UNTERMINATED:
+        return "is missing its closing quote";
+      case StringError::UNKNOWN_ESCAPE:
+        return "has an unknown escape sequence";
+      case StringError::HEX_ESCAPE:
+        return "has a \\x escape without two hexadecimal digits";
+      case StringError::UNICODE_ESCAPE:
+        return "has a \\u escape that names no character";
+    }
+
+    return "is invalid";
+  }
+
+}  // namespace excerpt
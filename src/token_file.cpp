@@ -0,0 +1,167 @@
+#include "excerpt/token_file.hpp"
+#include "excerpt/number_literal.hpp"
+#include "excerpt/source_buffer.hpp"
+#include "excerpt_utils/logger.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace excerpt {
+  namespace {
+    // Records are written and read in place, which assumes the file's byte
+    // order is the host's
+    static_assert(std::endian::native == std::endian::little,
+                  "token files are little-endian");
+
+    constexpr char MAGIC[4] = {'E', 'X', 'T', 'K'};
+
+    // Appends the bytes of a trivially copyable value
+    template <typename T>
+    void append(std::string& bytes, const T& value) {
+      bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+  }  // namespace
+
+  std::string write_token_file(const TokenBuffer& tokens,
+                               std::string_view source) {
+    TokenFileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = TOKEN_FILE_VERSION;
+    header.record_size = sizeof(TokenRecord);
+    header.token_count = static_cast<uint32_t>(tokens.size());
+    header.records = sizeof(TokenFileHeader);
+    header.strings = header.records + tokens.size() * sizeof(TokenRecord);
+    header.strings_size = static_cast<uint32_t>(source.size());
+
+    std::string bytes;
+    bytes.reserve(header.strings + source.size());
+    append(bytes, header);
+
+    // Tokens come in source order, so their lines are found by walking the
+    // source once rather than searching for each
+    uint32_t line = 1;
+    size_t scanned = 0;
+
+    for (size_t i = 0; i < tokens.size(); i++) {
+      size_t offset = std::min<size_t>(tokens.offsets[i], source.size());
+
+      if (offset > scanned) {
+        line += std::count(source.begin() + scanned, source.begin() + offset,
+                           '\n');
+        scanned = offset;
+      }
+
+      TokenRecord record{};
+      record.type = tokens.types[i];
+      record.offset = tokens.offsets[i];
+      record.length = tokens.lengths[i];
+      record.line = line;
+      append(bytes, record);
+    }
+
+    bytes.append(source);
+    return bytes;
+  }
+
+  std::unique_ptr<TokenFile> TokenFile::open(const std::string& path) {
+    auto buffer = SourceBuffer::open(path);
+    if (!buffer) {
+      return nullptr;
+    }
+
+    return from_buffer(std::move(buffer));
+  }
+
+  std::unique_ptr<TokenFile> TokenFile::from_buffer(
+      std::shared_ptr<const SourceBuffer> buffer) {
+    std::string_view bytes = buffer->text();
+    const std::string& name = buffer->name();
+
+    TokenFileHeader header;
+    if (bytes.size() < sizeof(header) ||
+        std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) != 0) {
+      logger::error("{0}: not a token file", name);
+      return nullptr;
+    }
+
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    if (header.version != TOKEN_FILE_VERSION ||
+        header.record_size != sizeof(TokenRecord)) {
+      logger::error("{0}: unsupported token file version {1}", name,
+                    header.version);
+      return nullptr;
+    }
+
+    // Each bound is checked before it is added to, so nothing overflows
+    uint64_t records_size =
+        static_cast<uint64_t>(header.token_count) * sizeof(TokenRecord);
+
+    if (header.records < sizeof(header) || header.records > bytes.size() ||
+        records_size > bytes.size() - header.records ||
+        header.strings < header.records + records_size ||
+        header.strings > bytes.size() ||
+        header.strings_size > bytes.size() - header.strings) {
+      logger::error("{0}: token file is truncated", name);
+      return nullptr;
+    }
+
+    // Records are read in place, so they must be aligned, as they are in a
+    // mapping or any buffer from the allocator
+    const char* first = bytes.data() + header.records;
+    if (reinterpret_cast<uintptr_t>(first) % alignof(TokenRecord) != 0) {
+      logger::error("{0}: token records are misaligned", name);
+      return nullptr;
+    }
+
+    std::unique_ptr<TokenFile> file(new TokenFile(std::move(buffer)));
+    file->records = reinterpret_cast<const TokenRecord*>(first);
+    file->count = header.token_count;
+    file->strings = bytes.substr(header.strings, header.strings_size);
+
+    // Check every type is one this compiler knows and every spelling lies
+    // in the string table, so that reading a token never has to
+    for (size_t i = 0; i < file->count; i++) {
+      const TokenRecord& record = file->records[i];
+
+      if (record.type > TokenType::INVALID) {
+        logger::error("{0}: token {1} has unknown type {2}", name, i,
+                      static_cast<unsigned>(record.type));
+        return nullptr;
+      }
+
+      if (static_cast<uint64_t>(record.offset) + record.length >
+          header.strings_size) {
+        logger::error("{0}: token {1} lies outside the string table", name,
+                      i);
+        return nullptr;
+      }
+    }
+
+    return file;
+  }
+
+  TokenBuffer TokenFile::tokens() const {
+    TokenBuffer tokens;
+    tokens.reserve(count);
+
+    // Values are not stored, being cheaper to decode again from the few
+    // literals than to write for every token
+    for (size_t i = 0; i < count; i++) {
+      const TokenRecord& record = records[i];
+      NumberValue value{};
+
+      if (record.type == TokenType::INTEGER_LITERAL ||
+          record.type == TokenType::FLOAT_LITERAL) {
+        value = decode_number(strings.substr(record.offset, record.length))
+                    .value;
+      }
+
+      tokens.push(record.type, record.offset, record.length, value);
+    }
+
+    return tokens;
+  }
+
+}  // namespace excerpt
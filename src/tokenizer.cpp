@@ -1,86 +1,85 @@
 #include "excerpt/tokenizer.hpp"
+#include "excerpt/lexer_tables.hpp"
+#include "excerpt/number_literal.hpp"
+#include "excerpt/scan.hpp"
+#include "excerpt/string_literal.hpp"
 #include "excerpt_utils/logger.hpp"
 
 namespace excerpt {
-  std::shared_ptr<Token> create_token(TokenType type, std::string value,
+  std::shared_ptr<Token> create_token(TokenType type, std::string_view value,
                                       int line, int column) {
-    return make_unique<Token>(type, value, line, column);
+    return std::make_shared<Token>(type, value, line, column);
   }
 
+  Tokenizer::Tokenizer(std::shared_ptr<const SourceBuffer> buffer)
+      : buffer(buffer),
+        source(buffer->text()),
+        index(0),
+        manager(source),
+        interner(nullptr),
+        cursor(0) {}
+
   Tokenizer::Tokenizer(std::shared_ptr<std::string> source)
-      : source(source), index(0), line(1), column(1) {}
+      : Tokenizer(SourceBuffer::from_string(std::move(source))) {}
+
+  Tokenizer::Tokenizer(std::string_view source)
+      : source(source),
+        index(0),
+        manager(source),
+        interner(nullptr),
+        cursor(0) {}
 
   char Tokenizer::peek(int offset) {
-    if (index + offset >= source->length()) {
+    if (index + offset >= source.length()) {
       return '\0';
     }
 
-    return source->at(index + offset);
+    return source[index + offset];
   }
 
   char Tokenizer::advance() {
-    if (index >= source->length()) {
+    if (index >= source.length()) {
       return '\0';
     }
 
-    char current = source->at(index);
-
-    index++;
-    column++;
-
-    if (current == '\n') {
-      line++;
-      column = 1;
-    }
-
-    return current;
+    return source[index++];
   }
 
   char Tokenizer::current() {
-    if (index >= source->length()) {
+    if (index >= source.length()) {
       return '\0';
     }
 
-    return source->at(index);
+    return source[index];
   }
 
   char Tokenizer::skipws() {
+    const char* begin = source.data();
+    const char* end = begin + source.length();
+
     while (true) {
       // Skip whitespace characters
-      while (std::isspace(current())) {
-        advance();
+      if (has_class(current(), CHAR_SPACE)) {
+        index = scan::skip_space(begin + index + 1, end) - begin;
       }
 
       // Check for single-line comments
       if (current() == '/' && peek() == '/') {
-        while (current() != '\0' && current() != '\n') {
-          advance();
-        }
+        index = scan::find_newline(begin + index, end) - begin;
       }
 
       // Check for multi-line comments
       else if (current() == '/' && peek() == '*') {
-        int sline = line;
-        int scol = column;
+        const char* close = scan::find_comment_end(begin + index + 2, end);
 
-        // Skip the opening of the multi-line comment
-        advance();
-        advance();
-
-        while (true) {
-          if (current() == '\0') {
-            // Unclosed multi-line comment
-            return '\0';
-          } else if (current() == '*' && peek() == '/') {
-            // Skip the closing of the multi-line comment
-            advance();
-            advance();
-            break;
-          } else {
-            // Skip other characters in the comment
-            advance();
-          }
+        if (close == end) {
+          // Unclosed multi-line comment
+          index = source.length();
+          return '\0';
         }
+
+        // Skip the comment, including its closing
+        index = close + 2 - begin;
       } else {
         break;
       }
@@ -89,26 +88,33 @@ namespace excerpt {
     return current();
   }
 
-  std::string Tokenizer::walk(std::function<bool(char)> predicate) {
-    std::string result;
+  std::string_view Tokenizer::walk(scan::Scanner scanner) {
+    size_t start = index;
+    const char* begin = source.data();
 
-    while (predicate(current())) {
-      result += current();
-      advance();
-    }
+    index = scanner(begin + index, begin + source.length()) - begin;
 
-    return result;
+    return slice(start);
   }
 
-  std::shared_ptr<Token> Tokenizer::next() {
+  std::string_view Tokenizer::slice(size_t start) const {
+    return source.substr(start, index - start);
+  }
+
+  void Tokenizer::seek(size_t position) {
+    index = position;
+  }
+
+  Lexeme Tokenizer::lex() {
     char current_char = skipws();
+
     if (current_char == '\0')
-      return create_token(TokenType::END, "", line, column);
+      return Lexeme{TokenType::END, slice(index)};
 
-    if (std::isdigit(current_char))
+    else if (has_class(current_char, CHAR_DIGIT))
       return parse_number();
 
-    else if (std::isalpha(current_char) || current_char == '_')
+    else if (has_class(current_char, CHAR_IDENT_START))
       return parse_identifier();
 
     else if (current_char == '"')
@@ -117,116 +123,166 @@ namespace excerpt {
     return parse_symbol();
   }
 
-  std::shared_ptr<Token> Tokenizer::parse_string() {
-    std::stringstream stream;
+  TokenBuffer Tokenizer::tokenize_all() {
+    TokenBuffer result;
+
+    // Typical sources average a few bytes per token
+    result.reserve((source.length() - index) / 4 + 1);
+
+    if (interner) {
+      result.symbols.reserve(result.types.capacity());
+    }
+
+    while (true) {
+      Lexeme lexeme = lex();
+      uint32_t offset = lexeme.spelling.data() - source.data();
+
+      if (interner) {
+        result.push(lexeme.type, offset, lexeme.spelling.length(),
+                    lexeme.symbol, lexeme.value);
+      } else {
+        result.push(lexeme.type, offset, lexeme.spelling.length(),
+                    lexeme.value);
+      }
 
-    int sline = line;
-    int scol = column;
+      if (lexeme.type == TokenType::END) {
+        logger::debug("Tokenized {0} bytes into {1} tokens", source.length(),
+                      result.size());
+        return result;
+      }
+    }
+  }
+
+  std::shared_ptr<Token> Tokenizer::next() {
+    if (!tokens) {
+      tokens = tokenize_all();
+    }
+
+    // Stay on the trailing END token once the buffer is exhausted
+    size_t i = cursor;
+    if (cursor + 1 < tokens->size()) {
+      cursor++;
+    }
+
+    std::string_view spelling(source.data() + tokens->offsets[i],
+                              tokens->lengths[i]);
+    SourceLocation location = manager.location(tokens->offsets[i]);
+
+    // Strings with escapes are the only tokens whose value is not a view
+    if (tokens->types[i] == TokenType::STRING_LITERAL &&
+        spelling.find('\\') != std::string_view::npos) {
+      std::string value;
+      string_value(spelling, value);
+
+      return std::make_shared<Token>(
+          Token::decoded(tokens->types[i], std::move(value), location.line,
+                         location.column));
+    }
+
+    return create_token(tokens->types[i],
+                        token_value(tokens->types[i], spelling), location.line,
+                        location.column);
+  }
+
+  Lexeme Tokenizer::parse_string() {
+    size_t start = index;
+    bool valid = true;
 
     // Skip the opening quote
     advance();
 
-    while (current() != '"') {
-      if (current() == '\0') {
-        return create_token(TokenType::INVALID, stream.str(), sline, scol);
+    // Runs of plain characters are skipped by the scanning kernel, stopping
+    // only at the closing quote, an escape or the end of the source
+    const char* end = source.data() + source.length();
+    const char* at = source.data() + index;
+
+    while (true) {
+      at = scan::find_string_end(at, end);
+
+      if (at == end || *at != '\\') {
+        break;
       }
 
-      stream << advance();
+      // Escapes are only checked here; the value is decoded on demand
+      Escape escape = read_escape(std::string_view(at, end - at));
+      valid = valid && escape.error == StringError::NONE;
+      at += escape.length;
+    }
+
+    index = at - source.data();
+
+    if (current() == '\0') {
+      return Lexeme{TokenType::INVALID, slice(start)};
     }
 
     // Skip the closing quote
     advance();
 
-    return create_token(TokenType::STRING_LITERAL, stream.str(), sline, scol);
+    // An invalid literal is still lexed whole, so that lexing resumes past it
+    return Lexeme{valid ? TokenType::STRING_LITERAL : TokenType::INVALID,
+                  slice(start)};
   }
 
-  std::shared_ptr<Token> Tokenizer::parse_number() {
-    std::stringstream stream;
+  Lexeme Tokenizer::parse_number() {
+    size_t start = index;
 
-    int sline = line;
-    int scol = column;
+    // Consuming digits, along with any prefix, separators and suffix, so
+    // that a literal such as `1abc` is diagnosed whole rather than split
+    walk(scan::skip_ident);
 
-    // Consuming and appending digits
-    stream << walk([](char ch) { return std::isdigit(ch); });
+    // A dot continues the literal as a fraction, and a sign after a
+    // decimal exponent continues its exponent, when a digit follows
+    bool hex = index - start > 1 && (source[start + 1] | 0x20) == 'x';
 
-    // If the character is a dot, handle as float.
-    if (current() == '.' && std::isdigit(peek())) {
-      // Consume the dot
-      stream << advance();
-      stream << walk([](char ch) { return std::isdigit(ch); });
+    while (has_class(peek(), CHAR_DIGIT)) {
+      char previous = source[index - 1] | 0x20;
 
-      return create_token(TokenType::FLOAT_LITERAL, stream.str(), sline, scol);
+      if (current() == '.' ||
+          ((current() == '+' || current() == '-') && previous == 'e' &&
+           !hex)) {
+        advance();
+        walk(scan::skip_ident);
+      } else {
+        break;
+      }
     }
 
-    return create_token(TokenType::INTEGER_LITERAL, stream.str(), sline, scol);
-  }
+    NumberLiteral literal = decode_number(slice(start));
 
-  std::shared_ptr<Token> Tokenizer::parse_identifier() {
-    std::stringstream stream;
+    if (literal.type == TokenType::INVALID) {
+      return Lexeme{TokenType::INVALID, slice(start)};
+    }
 
-    int sline = line;
-    int scol = column;
+    return Lexeme{literal.type, slice(start), NO_SYMBOL, literal.value};
+  }
 
-    // Consuming and appending alphanumeric characters
-    stream << walk([](char ch) { return std::isalnum(ch) || ch == '_'; });
+  Lexeme Tokenizer::parse_identifier() {
+    // Consuming alphanumeric characters
+    std::string_view spelling = walk(scan::skip_ident);
 
     // Checking if the identifier is a keyword
-    std::string value = stream.str();
-    for (const auto &pair : TOKEN_STR) {
-      if (pair.second == value) {
-        return create_token(pair.first, value, sline, scol);
-      }
+    TokenType type = keyword_type(spelling);
+
+    if (interner && type == TokenType::IDENTIFIER) {
+      return Lexeme{type, spelling, interner->intern(spelling)};
     }
 
-    return create_token(TokenType::IDENTIFIER, value, sline, scol);
+    return Lexeme{type, spelling};
   }
 
-  std::shared_ptr<Token> Tokenizer::parse_symbol() {
-    char current_char = current();
-    char next_char = peek();
-
-    auto sline = line;
-    auto scol = column;
-
-    // Helper to map a character to a token type
-    std::unordered_map<char, TokenType> conversion = {
-        {'+', TokenType::PLUS},
-        {'-', TokenType::MINUS},
-        {'*', TokenType::STAR},
-        {'/', TokenType::SLASH},
-        {'%', TokenType::PERCENT},
-        {'(', TokenType::LPAREN},
-        {')', TokenType::RPAREN},
-        {'{', TokenType::LBRACE},
-        {'}', TokenType::RBRACE},
-        {'[', TokenType::LBRACKET},
-        {']', TokenType::RBRACKET},
-        {';', TokenType::SEMICOLON},
-        {':', TokenType::COLON},
-        {',', TokenType::COMMA},
-        {'.', TokenType::DOT},
-        {'=', (peek() == '=') ? TokenType::EQUAL : TokenType::ASSIGN},
-        {'!', (peek() == '=') ? TokenType::NOT_EQUAL : TokenType::INVALID},
-        {'<', (peek() == '=') ? TokenType::LESS_EQUAL : TokenType::LESS},
-        {'>', (peek() == '=') ? TokenType::GREATER_EQUAL : TokenType::GREATER}};
-
-    auto it = conversion.find(current_char);
-    TokenType type = (it != conversion.end()) ? it->second : TokenType::INVALID;
-
-    std::string value = std::string(1, current_char);
-
-    if (type != TokenType::INVALID) {
-      advance();
+  Lexeme Tokenizer::parse_symbol() {
+    size_t start = index;
 
-      // Consume the next character if it's a double-character token
-      if (type == TokenType::EQUAL || type == TokenType::NOT_EQUAL ||
-          type == TokenType::LESS_EQUAL || type == TokenType::GREATER_EQUAL) {
-        advance();
-        return create_token(type, value + next_char, sline, scol);
-      }
+    // Match the longest operator spelled from here
+    OperatorMatch match = OPERATOR_DFA.match(source.substr(index));
+
+    // Invalid characters are consumed too, so each is reported only once
+    size_t length = match.length ? match.length : 1;
+    for (size_t i = 0; i < length; i++) {
+      advance();
     }
 
-    return create_token(type, value, sline, scol);
+    return Lexeme{match.type, slice(start)};
   }
 
 }  // namespace excerpt
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "excerpt/arena.hpp"
+
+#include <cstdint>
+#include <string>
+
+using namespace excerpt;
+
+TEST(ArenaTest, Alignment) {
+  Arena arena(64);
+
+  for (size_t alignment : {1, 2, 4, 8, 16, 32}) {
+    arena.allocate(1, 1);
+    void* pointer = arena.allocate(3, alignment);
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(pointer) % alignment, 0u);
+  }
+}
+
+TEST(ArenaTest, Create) {
+  struct Pair {
+    int first;
+    double second;
+  };
+
+  Arena arena;
+  Pair* pair = arena.create<Pair>(Pair{1, 2.5});
+
+  EXPECT_EQ(pair->first, 1);
+  EXPECT_EQ(pair->second, 2.5);
+  EXPECT_EQ(arena.bytes_used(), sizeof(Pair));
+}
+
+TEST(ArenaTest, Copy) {
+  Arena arena(64);
+  std::string text = "a string longer than the first block of the arena";
+
+  std::string_view copy = arena.copy(text);
+  text.assign(text.size(), 'x');
+
+  EXPECT_EQ(copy, "a string longer than the first block of the arena");
+  EXPECT_TRUE(arena.copy("").empty());
+}
+
+TEST(ArenaTest, GrowsAndResets) {
+  Arena arena(64);
+
+  // Allocations larger than a block get their own
+  char* large = static_cast<char*>(arena.allocate(1000, 1));
+  large[999] = 'x';
+
+  for (int i = 0; i < 1000; i++) {
+    *arena.create<int>(i) += 1;
+  }
+
+  EXPECT_EQ(arena.bytes_used(), 1000 + 1000 * sizeof(int));
+  EXPECT_GE(arena.bytes_reserved(), arena.bytes_used());
+
+  arena.reset();
+  EXPECT_EQ(arena.bytes_used(), 0u);
+  EXPECT_EQ(arena.bytes_reserved(), 0u);
+  EXPECT_EQ(*arena.create<int>(7), 7);
+}
+
+TEST(ArenaTest, Move) {
+  Arena arena;
+  std::string_view copy = arena.copy("kept");
+
+  Arena moved(std::move(arena));
+  EXPECT_EQ(copy, "kept");
+  EXPECT_EQ(moved.bytes_used(), 4u);
+  EXPECT_EQ(arena.bytes_reserved(), 0u);
+
+  // The moved-from arena allocates fresh blocks
+  EXPECT_EQ(arena.copy("new"), "new");
+  EXPECT_EQ(copy, "kept");
+}
@@ -1,6 +1,9 @@
 #include "gtest/gtest.h"
 #include "excerpt_utils/argparser.hpp"
 
+#include <cstdio>
+#include <fstream>
+
 using namespace excerpt;
 
 TEST(ArgParserTest, ShowHelp) {
@@ -24,6 +27,85 @@ TEST(ArgParserTest, OutputFile) {
   ASSERT_EQ(parser.output_file(), "output.txt");
 }
 
+TEST(ArgParserTest, InputFiles) {
+  const char* argv[] = {"test", "a.ex", "-j", "2", "b.ex"};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  ArgParser parser(argc, argv);
+  ASSERT_EQ(parser.input_files(), (std::vector<std::string>{"a.ex", "b.ex"}));
+  ASSERT_EQ(parser.input_file(), "a.ex");
+  ASSERT_EQ(parser.jobs(), 2u);
+}
+
+TEST(ArgParserTest, ResponseFile) {
+  std::string path = testing::TempDir() + "argparser_test.rsp";
+  std::ofstream(path) << "b.ex\n\"c d.ex\"\n";
+
+  std::string response = "@" + path;
+  const char* argv[] = {"test", "a.ex", response.c_str()};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  ArgParser parser(argc, argv);
+  ASSERT_EQ(parser.input_files(),
+            (std::vector<std::string>{"a.ex", "b.ex", "c d.ex"}));
+
+  std::remove(path.c_str());
+}
+
+TEST(ArgParserTest, StandardInputByDefault) {
+  const char* argv[] = {"test"};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  ArgParser parser(argc, argv);
+  ASSERT_EQ(parser.input_files(), std::vector<std::string>{"-"});
+}
+
+TEST(ArgParserTest, Optimization) {
+  const char* argv[] = {"test", "a.ex", "-O2", "-ftime-passes", "-emit-llvm"};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  ArgParser parser(argc, argv);
+  ASSERT_EQ(parser.opt_level(), OptLevel::O2);
+  ASSERT_TRUE(parser.time_passes());
+  ASSERT_TRUE(parser.emit_llvm());
+}
+
+TEST(ArgParserTest, NoOptimizationByDefault) {
+  const char* argv[] = {"test", "a.ex"};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  ArgParser parser(argc, argv);
+  ASSERT_EQ(parser.opt_level(), OptLevel::O0);
+  ASSERT_FALSE(parser.time_passes());
+}
+
+TEST(ArgParserTest, Run) {
+  const char* argv[] = {"test", "a.ex", "--run"};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  ArgParser parser(argc, argv);
+  ASSERT_TRUE(parser.run());
+}
+
+TEST(ArgParserTest, TimeReport) {
+  const char* argv[] = {"test", "a.ex", "--time-report",
+                        "--time-report-format=json", "--time-trace=t.json"};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  ArgParser parser(argc, argv);
+  ASSERT_TRUE(parser.time_report());
+  ASSERT_EQ(parser.time_report_format(), timing::ReportFormat::JSON);
+  ASSERT_EQ(parser.time_trace(), "t.json");
+}
+
+TEST(ArgParserTest, EmitTokens) {
+  const char* argv[] = {"test", "a.ex", "--emit-tokens"};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  ArgParser parser(argc, argv);
+  ASSERT_TRUE(parser.emit_tokens());
+  ASSERT_FALSE(parser.emit_llvm());
+}
+
+TEST(ArgParserTest, MemReport) {
+  const char* argv[] = {"test", "a.ex", "--mem-report"};
+  int argc = sizeof(argv) / sizeof(argv[0]);
+  ArgParser parser(argc, argv);
+  ASSERT_TRUE(parser.mem_report());
+}
+
 // Add more test cases as needed
 
 int main(int argc, char** argv) {
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "excerpt/ast.hpp"
+
+using namespace excerpt;
+
+TEST(AstTest, Nodes) {
+  Ast ast;
+
+  // 1 + x
+  NodeId one = ast.add(NodeKind::INTEGER, TokenType::INVALID, 0);
+  NodeId x = ast.add(NodeKind::NAME, TokenType::INVALID, 2);
+  NodeId sum = ast.add(NodeKind::BINARY, TokenType::PLUS, 1, one, x);
+
+  EXPECT_EQ(ast.size(), 3u);
+
+  const Node& node = ast.node(sum);
+  EXPECT_EQ(node.kind, NodeKind::BINARY);
+  EXPECT_EQ(node.op, TokenType::PLUS);
+  EXPECT_EQ(node.token, 1u);
+  EXPECT_EQ(ast.node(node.lhs).kind, NodeKind::INTEGER);
+  EXPECT_EQ(ast.node(node.rhs).token, 2u);
+
+  EXPECT_EQ(ast.node(one).lhs, NO_NODE);
+  EXPECT_EQ(ast.node(one).rhs, NO_NODE);
+}
+
+TEST(AstTest, Lists) {
+  Ast ast;
+
+  NodeId a = ast.add(NodeKind::NAME, TokenType::INVALID, 0);
+  NodeId b = ast.add(NodeKind::NAME, TokenType::INVALID, 1);
+
+  ListId empty = ast.add_list({});
+  ListId pair = ast.add_list({a, b});
+  ListId missing = ast.add_list({a, NO_NODE});
+
+  EXPECT_TRUE(ast.list(empty).empty());
+
+  ASSERT_EQ(ast.list(pair).size(), 2u);
+  EXPECT_EQ(ast.list(pair)[0], a);
+  EXPECT_EQ(ast.list(pair)[1], b);
+
+  ASSERT_EQ(ast.list(missing).size(), 2u);
+  EXPECT_EQ(ast.list(missing)[1], NO_NODE);
+}
+
+TEST(AstTest, NodesStayPut) {
+  Ast ast;
+
+  NodeId first = ast.add(NodeKind::NAME, TokenType::INVALID, 7);
+  ListId list = ast.add_list({first});
+  const Node* node = &ast.node(first);
+  const NodeId* items = ast.list(list).data();
+
+  // Across several chunks, nothing already added moves
+  for (size_t i = 0; i < 3 * Ast::CHUNK_SIZE; i++) {
+    NodeId id = ast.add(NodeKind::INTEGER, TokenType::INVALID, i);
+    ast.add_list({id, first});
+  }
+
+  EXPECT_EQ(&ast.node(first), node);
+  EXPECT_EQ(ast.list(list).data(), items);
+  EXPECT_EQ(node->token, 7u);
+  EXPECT_EQ(ast.node(3 * Ast::CHUNK_SIZE).token, 3 * Ast::CHUNK_SIZE - 1);
+  EXPECT_GE(ast.capacity_bytes(), ast.size() * sizeof(Node));
+}
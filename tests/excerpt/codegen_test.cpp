@@ -0,0 +1,280 @@
+#include <gtest/gtest.h>
+#include "excerpt/backend.hpp"
+#include "excerpt/codegen.hpp"
+#include "excerpt/interner.hpp"
+#include "excerpt/parallel_tokenizer.hpp"
+#include "excerpt/parser.hpp"
+#include "excerpt_utils/logger.hpp"
+
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <string>
+
+using namespace excerpt;
+
+namespace {
+  // Generates a module, optionally optimized, returning its IR, or the
+  // error if there is none
+  std::string compile(const std::string& source,
+                      std::optional<OptLevel> level = std::nullopt) {
+    std::string errors;
+    logger::Capture capture(errors);
+
+    Parser parser(source, "test.ex");
+    NodeId program = parser.parse();
+    if (program == NO_NODE) {
+      return errors;
+    }
+
+    llvm::LLVMContext context;
+    CodeGenerator generator(context, source, parser.tokens(), parser.ast(),
+                            "test.ex");
+    std::unique_ptr<llvm::Module> module = generator.generate(program);
+    if (!module) {
+      return errors;
+    }
+
+    if (level) {
+      auto machine = create_target_machine(*level);
+      optimize(*module, *machine, *level);
+    }
+
+    std::string ir;
+    llvm::raw_string_ostream stream(ir);
+    module->print(stream, nullptr);
+    return stream.str();
+  }
+
+  // Compiles at -O2, where a program without side effects folds to the
+  // value `main` returns
+  std::string fold(const std::string& source) {
+    return compile(source, OptLevel::O2);
+  }
+}  // namespace
+
+TEST(CodeGeneratorTest, Declarations) {
+  std::string ir = compile(
+      "int g = 2 * 3 + 1;\n"
+      "float f;\n"
+      "int add(int a, char b) { return a + b; }\n");
+
+  EXPECT_NE(ir.find("@g = global i32 7"), std::string::npos) << ir;
+  EXPECT_NE(ir.find("@f = global double 0.0"), std::string::npos) << ir;
+  EXPECT_NE(ir.find("define i32 @add(i32 %a, i8 %b)"), std::string::npos)
+      << ir;
+  EXPECT_NE(ir.find("sext i8"), std::string::npos) << ir;
+}
+
+TEST(CodeGeneratorTest, Evaluates) {
+  const struct {
+    std::string source;
+    std::string expected;
+  } testCases[] = {
+      {"int main() { return 1 + 2 * 3; }", "ret i32 7"},
+      {"int main() { return 7 / 2 + 7 % 2 - -1; }", "ret i32 5"},
+      {"int main() { return 7 / 2.0 * 2; }", "ret i32 7"},
+      {"int main() { char c = 300; return c; }", "ret i32 44"},
+      {"int main() { bool b = 5; return b + b; }", "ret i32 2"},
+      {"int main() { return (1 < 2) + (2.5 >= 3) + (1 != 1); }", "ret i32 1"},
+      {"int main() { int n = 0;\n"
+       "  for (int i = 0; i < 10; i = i + 1) {\n"
+       "    if (i == 3) { continue; } if (i == 8) { break; } n = n + i;\n"
+       "  }\n"
+       "  return n; }",
+       "ret i32 25"},
+      {"int main() { int n = 1; while (n < 100) { n = n * 3; } return n; }",
+       "ret i32 243"},
+      {"int fact(int n) { if (n < 2) { return 1; }\n"
+       "  return n * fact(n - 1); }\n"
+       "int main() { return fact(5); }",
+       "ret i32 120"},
+      {"int main() { return twice(4); }\n"
+       "int twice(int x) { return x * 2; }",
+       "ret i32 8"},
+      {"int g = 4; int main() { int g = 1; { int g = 2; } return g; }",
+       "ret i32 1"},
+      {"float half(int x) { return x / 2.0; }\n"
+       "int main() { return half(9) * 2; }",
+       "ret i32 9"},
+      {"int main() { return 0x1F + 0b101 + 017 + 1_000; }", "ret i32 1051"},
+      {"int main() { return 2.5e2 + 1e-1 * 10 + 0.5E+1; }", "ret i32 256"},
+      {"int pick(int x) { if (x == 1) { return 10; } else if (x == 2) {\n"
+       "  return 20; } else if (x == 3) { return 30; } else { return 0; } }\n"
+       "int main() { return pick(1) + pick(2) + pick(3) + pick(4); }",
+       "ret i32 60"},
+      {"int main() { }", "ret i32 0"}};
+
+  for (const auto& testCase : testCases) {
+    SCOPED_TRACE("Source: " + testCase.source);
+    std::string ir = fold(testCase.source);
+    EXPECT_NE(ir.find(testCase.expected), std::string::npos) << ir;
+  }
+}
+
+TEST(CodeGeneratorTest, ExternalCalls) {
+  std::string ir = compile("int main() { return putchar(65) + abs(2.5); }");
+
+  EXPECT_NE(ir.find("declare i32 @putchar(i32)"), std::string::npos) << ir;
+  EXPECT_NE(ir.find("declare i32 @abs(double)"), std::string::npos) << ir;
+}
+
+TEST(CodeGeneratorTest, Errors) {
+  const struct {
+    std::string source;
+    std::string expected;
+  } testCases[] = {
+      {"int main() { return x; }", "1:21: use of undeclared name 'x'"},
+      {"int main() { x = 1; }", "1:14: assignment to undeclared name 'x'"},
+      {"int main() { int a; int a; }", "1:25: redefinition of 'a'"},
+      {"int f() {} int f() {}", "1:16: redefinition of 'f'"},
+      {"int a; int a;", "1:12: redefinition of 'a'"},
+      {"int main() { break; }", "1:14: 'break' outside of a loop"},
+      {"int f(int a) { return f(); }", "'f' takes 1 arguments, not 0"},
+      {"int main() { int v; return v(); }", "'v' is not a function"},
+      {"int a = 1; int b = a;", "1:20: global initializer is not a constant"},
+      {"int main() { return \"s\"; }", "1:21: string values are not supported"},
+      {"int main() { return 4294967296; }",
+       "1:21: integer literal is too large"}};
+
+  for (const auto& testCase : testCases) {
+    SCOPED_TRACE("Source: " + testCase.source);
+    EXPECT_NE(compile(testCase.source).find(testCase.expected),
+              std::string::npos);
+  }
+}
+
+TEST(CodeGeneratorTest, LongElseIfChains) {
+  // Arms are generated in a loop, so chains far longer than statements may
+  // nest still compile
+  const size_t arms = 10000;
+  std::string source = "int f(int x) { if (x == 0) { return 0; }\n";
+  for (size_t i = 1; i < arms; i++) {
+    source += "else if (x == " + std::to_string(i) + ") { return " +
+              std::to_string(i) + "; }\n";
+  }
+  source += "return -1; }";
+
+  std::string ir = compile(source);
+  EXPECT_NE(ir.find("define i32 @f"), std::string::npos) << ir;
+  EXPECT_NE(ir.find("ret i32 9999"), std::string::npos);
+}
+
+TEST(CodeGeneratorTest, Scopes) {
+  // Shadowed names come back into scope as each block closes, and a name
+  // may be reused by a sibling scope
+  std::string source =
+      "int a = 1;\n"
+      "int main() { int b = 0; int a = 10;\n"
+      "  { int a = 100; b = b + a; { a = a + 1; int a = 1000; } b = b + a; }\n"
+      "  { int a = 5; b = b + a; }\n"
+      "  return b + a; }";
+
+  EXPECT_NE(fold(source).find("ret i32 216"), std::string::npos);
+
+  // As the driver lexes it, with names already interned
+  std::string errors;
+  logger::Capture capture(errors);
+  Interner names;
+  Parser parser(source, tokenize_parallel(source, 1, 64 * 1024, &names),
+                "test.ex");
+  NodeId program = parser.parse();
+  ASSERT_NE(program, NO_NODE) << errors;
+  ASSERT_FALSE(parser.tokens().symbols.empty());
+
+  llvm::LLVMContext context;
+  CodeGenerator generator(context, source, parser.tokens(), parser.ast(),
+                          "test.ex");
+  std::unique_ptr<llvm::Module> module = generator.generate(program);
+  ASSERT_NE(module, nullptr) << errors;
+
+  auto machine = create_target_machine(OptLevel::O2);
+  optimize(*module, *machine, OptLevel::O2);
+
+  std::string ir;
+  llvm::raw_string_ostream stream(ir);
+  module->print(stream, nullptr);
+  EXPECT_NE(stream.str().find("ret i32 216"), std::string::npos) << ir;
+}
+
+TEST(CodeGeneratorTest, DeepExpressions) {
+  // Far deeper than the call stack could take, were they walked recursively
+  constexpr size_t TERMS = 200000;
+  std::string terms;
+  for (size_t i = 0; i < TERMS; i++) {
+    terms += " + 1";
+  }
+
+  EXPECT_NE(compile("int main() { return 0" + terms + "; }")
+                .find("ret i32 " + std::to_string(TERMS)),
+            std::string::npos);
+
+  // Global initializers are checked to be constant before they are generated
+  EXPECT_NE(compile("int x = 0" + terms + ";")
+                .find("@x = global i32 " + std::to_string(TERMS)),
+            std::string::npos);
+
+  std::string ir = compile("int f(int a) { return a" + terms + "; }");
+  EXPECT_NE(ir.find("define i32 @f"), std::string::npos);
+  EXPECT_EQ(ir.find("error"), std::string::npos);
+}
+
+TEST(BackendTest, OptimizationLevels) {
+  std::string source =
+      "int sum(int n) { int total = 0;\n"
+      "  for (int i = 0; i < n; i = i + 1) { total = total + i; }\n"
+      "  return total; }\n";
+
+  // Stack slots survive -O0, and every other level promotes them
+  EXPECT_NE(compile(source, OptLevel::O0).find("alloca"), std::string::npos);
+
+  for (OptLevel level :
+       {OptLevel::O1, OptLevel::O2, OptLevel::O3, OptLevel::Os}) {
+    EXPECT_EQ(compile(source, level).find("alloca"), std::string::npos);
+  }
+}
+
+TEST(BackendTest, PassTimings) {
+  Parser parser("int main() { return 1; }");
+  NodeId program = parser.parse();
+
+  llvm::LLVMContext context;
+  CodeGenerator generator(context, "int main() { return 1; }",
+                          parser.tokens(), parser.ast(), "test.ex");
+  auto module = generator.generate(program);
+  auto machine = create_target_machine(OptLevel::O2);
+
+  std::string timings;
+  optimize(*module, *machine, OptLevel::O2, &timings);
+
+  EXPECT_NE(timings.find("Pass execution timing report"), std::string::npos);
+  EXPECT_NE(timings.find("InstCombinePass"), std::string::npos);
+}
+
+TEST(BackendTest, EmitsObject) {
+  std::string source = "int main() { return 1; }";
+  Parser parser(source);
+  NodeId program = parser.parse();
+
+  llvm::LLVMContext context;
+  CodeGenerator generator(context, source, parser.tokens(), parser.ast(),
+                          "test.ex");
+  auto module = generator.generate(program);
+  auto machine = create_target_machine(OptLevel::O0);
+
+  std::string path = testing::TempDir() + "backend_test.o";
+  ASSERT_TRUE(emit_object(*module, *machine, path));
+
+  // An ELF, Mach-O or COFF object, depending on the host
+  std::ifstream file(path, std::ios::binary);
+  std::string header(4, '\0');
+  file.read(header.data(), header.size());
+  EXPECT_TRUE(header == "\x7f" "ELF" || header == "\xcf\xfa\xed\xfe" ||
+              header.substr(0, 2) == "\x64\x86")
+      << header;
+
+  std::remove(path.c_str());
+}
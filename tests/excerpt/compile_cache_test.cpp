@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "excerpt/compile_cache.hpp"
+
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Process.h"
+
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using namespace excerpt;
+
+namespace {
+  // A cache directory of its own, removed after the test
+  class CompileCacheTest : public testing::Test {
+   protected:
+    void SetUp() override {
+      directory = testing::TempDir() + "compile_cache_test_" +
+                  testing::UnitTest::GetInstance()->current_test_info()->name();
+      llvm::sys::fs::remove_directories(directory);
+    }
+
+    void TearDown() override { llvm::sys::fs::remove_directories(directory); }
+
+    // Sets when the entry of `key` was last used
+    void set_used(const std::string& key, std::chrono::hours ago) {
+      std::string path = directory + "/" + key.substr(0, 2) + "/" +
+                         key.substr(2);
+      int fd;
+      ASSERT_FALSE(llvm::sys::fs::openFileForWrite(
+          path, fd, llvm::sys::fs::CD_OpenExisting));
+      llvm::sys::fs::setLastAccessAndModificationTime(
+          fd, std::chrono::system_clock::now() - ago);
+      llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+    }
+
+    std::string directory;
+  };
+}  // namespace
+
+TEST_F(CompileCacheTest, Key) {
+  std::string key = CompileCache::key({"version", "-O2", "int x;"});
+
+  EXPECT_EQ(key.size(), 64u);
+  EXPECT_EQ(key, CompileCache::key({"version", "-O2", "int x;"}));
+  EXPECT_NE(key, CompileCache::key({"version", "-O0", "int x;"}));
+  EXPECT_NE(key, CompileCache::key({"version", "-O2", "int y;"}));
+
+  // Bytes moved from one part to another make a different key
+  EXPECT_NE(CompileCache::key({"ab", "c"}), CompileCache::key({"a", "bc"}));
+}
+
+TEST_F(CompileCacheTest, StoreAndLookup) {
+  CompileCache cache(directory, 1 << 20);
+  std::string key = CompileCache::key({"source"});
+  std::string contents("object\0bytes", 12);
+
+  EXPECT_EQ(cache.lookup(key), std::nullopt);
+  ASSERT_TRUE(cache.store(key, contents));
+  EXPECT_EQ(cache.lookup(key), contents);
+
+  // Another cache over the same directory, i.e another process, sees it
+  CompileCache other(directory, 1 << 20);
+  EXPECT_EQ(other.lookup(key), contents);
+
+  CacheStats stats = cache.stats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.stores, 1u);
+  EXPECT_EQ(stats.evictions, 0u);
+}
+
+TEST_F(CompileCacheTest, EvictsLeastRecentlyUsed) {
+  CompileCache cache(directory, 2500);
+  std::string a = CompileCache::key({"a"});
+  std::string b = CompileCache::key({"b"});
+  std::string c = CompileCache::key({"c"});
+
+  for (const std::string& key : {a, b, c}) {
+    ASSERT_TRUE(cache.store(key, std::string(1000, 'x')));
+  }
+
+  set_used(a, std::chrono::hours(3));
+  set_used(b, std::chrono::hours(2));
+  set_used(c, std::chrono::hours(1));
+
+  // Using `a` makes `b` the least recently used
+  EXPECT_TRUE(cache.lookup(a));
+  cache.prune();
+
+  EXPECT_TRUE(cache.lookup(a));
+  EXPECT_FALSE(cache.lookup(b));
+  EXPECT_TRUE(cache.lookup(c));
+  EXPECT_EQ(cache.stats().evictions, 1u);
+}
+
+TEST_F(CompileCacheTest, RemovesAbandonedFiles) {
+  CompileCache cache(directory, 1 << 20);
+  std::string key = CompileCache::key({"a"});
+  ASSERT_TRUE(cache.store(key, "contents"));
+
+  // A process stopped while writing long ago, and one is writing now
+  std::string stale = directory + "/" + key.substr(0, 2) + "/old.tmp";
+  std::string fresh = directory + "/" + key.substr(0, 2) + "/new.tmp";
+  std::ofstream(stale) << "partial";
+  std::ofstream(fresh) << "partial";
+
+  int fd;
+  ASSERT_FALSE(llvm::sys::fs::openFileForWrite(
+      stale, fd, llvm::sys::fs::CD_OpenExisting));
+  llvm::sys::fs::setLastAccessAndModificationTime(
+      fd, std::chrono::system_clock::now() - std::chrono::hours(2));
+  llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+
+  cache.prune();
+
+  EXPECT_FALSE(llvm::sys::fs::exists(stale));
+  EXPECT_TRUE(llvm::sys::fs::exists(fresh));
+  EXPECT_EQ(cache.lookup(key), "contents");
+}
+
+TEST_F(CompileCacheTest, ConcurrentStores) {
+  CompileCache cache(directory, 1 << 20);
+  std::string key = CompileCache::key({"shared"});
+  std::vector<std::thread> threads;
+
+  // Every reader sees a whole entry or none, whichever writer's it is
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&, i] {
+      std::string contents(10000, static_cast<char>('a' + i));
+
+      for (int n = 0; n < 50; n++) {
+        EXPECT_TRUE(cache.store(key, contents));
+
+        std::optional<std::string> entry = cache.lookup(key);
+        ASSERT_TRUE(entry);
+        ASSERT_EQ(entry->size(), contents.size());
+        EXPECT_EQ(entry->find_first_not_of(entry->front()), std::string::npos);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(cache.stats().stores, 400u);
+}
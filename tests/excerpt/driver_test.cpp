@@ -0,0 +1,296 @@
+#include <gtest/gtest.h>
+#include "excerpt/driver.hpp"
+#include "excerpt/token_file.hpp"
+#include "excerpt_utils/timing.hpp"
+
+#include "llvm/Support/FileSystem.h"
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+using namespace excerpt;
+
+namespace {
+  // Writes `text` to a temporary file named after `name`, returning its path
+  std::string write_temp(const std::string& name, const std::string& text) {
+    std::string path = testing::TempDir() + "driver_test_" + name + ".ex";
+    std::ofstream(path, std::ios::binary) << text;
+    return path;
+  }
+
+  // Options compiling with `jobs` threads, the others left at their defaults
+  DriverOptions with_jobs(unsigned jobs) {
+    DriverOptions options;
+    options.jobs = jobs;
+    return options;
+  }
+
+  std::string capture_stdout(const std::function<void()>& function) {
+    std::ostringstream stream;
+    std::streambuf* saved = std::cout.rdbuf(stream.rdbuf());
+    function();
+    std::cout.rdbuf(saved);
+    return stream.str();
+  }
+
+  // Drops the `[YYYY-MM-DD HH:MM:SS] ` the logger starts each line with, so
+  // outputs logged in different seconds compare equal
+  std::string strip_timestamps(const std::string& output) {
+    std::string stripped;
+    std::istringstream lines(output);
+
+    const size_t length = std::string("[YYYY-MM-DD HH:MM:SS] ").size();
+
+    for (std::string line; std::getline(lines, line);) {
+      bool stamped = line.size() >= length && line[0] == '[' &&
+                     line.compare(length - 2, 2, "] ") == 0;
+      stripped += line.substr(stamped ? length : 0) + "\n";
+    }
+
+    return stripped;
+  }
+}  // namespace
+
+TEST(DriverTest, CompilesFile) {
+  std::string path = write_temp("ok", "int main() { return 0; }\n");
+
+  EXPECT_EQ(Driver(with_jobs(1)).run({path}), 0u);
+}
+
+TEST(DriverTest, WritesBesideInput) {
+  std::string path = write_temp("object", "int main() { return 0; }\n");
+  std::string object = path.substr(0, path.size() - 3) + ".o";
+  std::string ir = path.substr(0, path.size() - 3) + ".ll";
+
+  ASSERT_EQ(Driver(with_jobs(1)).run({path}), 0u);
+  EXPECT_TRUE(std::ifstream(object).good());
+
+  DriverOptions options = with_jobs(1);
+  options.opt_level = OptLevel::O2;
+  options.emit_llvm = true;
+  ASSERT_EQ(Driver(options).run({path}), 0u);
+
+  std::stringstream text;
+  text << std::ifstream(ir).rdbuf();
+  EXPECT_NE(text.str().find("define i32 @main()"), std::string::npos);
+
+  std::remove(object.c_str());
+  std::remove(ir.c_str());
+}
+
+TEST(DriverTest, OutputNeedsSingleInput) {
+  DriverOptions options = with_jobs(1);
+  options.output = testing::TempDir() + "driver_test_out.o";
+
+  std::vector<std::string> inputs = {write_temp("e", "int x;\n"),
+                                     write_temp("f", "int y;\n")};
+
+  size_t failures;
+  std::string output =
+      capture_stdout([&] { failures = Driver(options).run(inputs); });
+
+  EXPECT_EQ(failures, 2u);
+  EXPECT_NE(output.find("--output needs a single input"), std::string::npos);
+}
+
+TEST(DriverTest, CachesOutputs) {
+  std::string path = write_temp("cached", "int main() { return 0; }\n");
+  std::string object = path.substr(0, path.size() - 3) + ".o";
+
+  DriverOptions options = with_jobs(1);
+  options.opt_level = OptLevel::O1;
+  options.cache_dir = testing::TempDir() + "driver_test_cache";
+  options.cache_stats = true;
+  llvm::sys::fs::remove_directories(options.cache_dir);
+
+  std::string first = capture_stdout([&] { Driver(options).run({path}); });
+  std::stringstream compiled;
+  compiled << std::ifstream(object, std::ios::binary).rdbuf();
+  std::remove(object.c_str());
+
+  std::string second = capture_stdout([&] { Driver(options).run({path}); });
+  std::stringstream cached;
+  cached << std::ifstream(object, std::ios::binary).rdbuf();
+
+  EXPECT_NE(first.find("0 hits, 1 misses, 1 stored"), std::string::npos);
+  EXPECT_NE(second.find("1 hits, 0 misses, 0 stored"), std::string::npos);
+  EXPECT_EQ(cached.str(), compiled.str());
+
+  // Another level is another output
+  options.opt_level = OptLevel::O2;
+  std::string third = capture_stdout([&] { Driver(options).run({path}); });
+  EXPECT_NE(third.find("0 hits, 1 misses"), std::string::npos);
+
+  std::remove(object.c_str());
+  llvm::sys::fs::remove_directories(options.cache_dir);
+}
+
+TEST(DriverTest, EmitsTokens) {
+  std::string path = write_temp("tokens", "int x = $;\n");
+  std::string tokens = path.substr(0, path.size() - 3) + ".tok";
+
+  // Invalid tokens are written, not reported
+  DriverOptions options = with_jobs(1);
+  options.emit_tokens = true;
+  EXPECT_EQ(Driver(options).run({path}), 0u);
+
+  auto file = TokenFile::open(tokens);
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(file->size(), 6u);
+  EXPECT_EQ((*file)[3].type, TokenType::INVALID);
+  EXPECT_EQ((*file)[3].text, "$");
+
+  std::remove(tokens.c_str());
+}
+
+TEST(DriverTest, TimesPhases) {
+  std::string source = "int f(int x) { return x + 1; }\n";
+  std::string path = write_temp("timed", source);
+
+  timing::start();
+  EXPECT_EQ(Driver(with_jobs(1)).run({path}), 0u);
+  timing::stop();
+
+  auto phases = timing::stats();
+
+  for (timing::Phase phase :
+       {timing::READ, timing::LEX, timing::PARSE, timing::IRGEN,
+        timing::OPTIMIZE, timing::EMIT, timing::WRITE}) {
+    EXPECT_EQ(phases[phase].runs, 1u) << timing::PHASE_NAMES[phase];
+  }
+
+  EXPECT_EQ(phases[timing::CACHE].runs, 0u);
+  EXPECT_EQ(phases[timing::READ].bytes, source.size());
+  EXPECT_EQ(phases[timing::LEX].bytes, source.size());
+  EXPECT_GT(phases[timing::LEX].items, 10u);
+  EXPECT_GT(phases[timing::PARSE].items, 0u);
+  EXPECT_GT(phases[timing::IRGEN].items, 0u);
+  EXPECT_GT(phases[timing::EMIT].bytes, 0u);
+  EXPECT_EQ(phases[timing::WRITE].bytes, phases[timing::EMIT].bytes);
+
+  std::remove((path.substr(0, path.size() - 3) + ".o").c_str());
+}
+
+TEST(DriverTest, ExecutesProgram) {
+  std::vector<std::string> inputs = {
+      write_temp("run_main", "int main() { return square(7) - 9; }\n"),
+      write_temp("run_square", "int square(int x) { return x * x; }\n")};
+
+  EXPECT_EQ(Driver(with_jobs(1)).execute(inputs), 40);
+
+  std::string output = capture_stdout([&] {
+    EXPECT_EQ(Driver(with_jobs(1)).execute({inputs[0]}), std::nullopt);
+  });
+  EXPECT_NE(output.find("square"), std::string::npos);
+}
+
+TEST(DriverTest, CountsFailures) {
+  std::vector<std::string> inputs = {
+      write_temp("a", "int x = 1;\n"), write_temp("b", "int x = ;\n"),
+      write_temp("c", "int y = $;\n"), write_temp("d", "int z;\n")};
+
+  size_t failures;
+  capture_stdout([&] { failures = Driver(with_jobs(4)).run(inputs); });
+
+  EXPECT_EQ(failures, 2u);
+}
+
+TEST(DriverTest, DiagnosesNumericLiterals) {
+  std::string path =
+      write_temp("literals", "int x = 99999999999999999999;\nint y = 0b12;\n");
+
+  std::string output;
+  size_t failures;
+  output =
+      capture_stdout([&] { failures = Driver(with_jobs(1)).run({path}); });
+
+  EXPECT_EQ(failures, 1u);
+  EXPECT_NE(output.find("1:9: numeric literal '99999999999999999999' is too "
+                        "large for a 64-bit integer"),
+            std::string::npos)
+      << output;
+  EXPECT_NE(output.find("2:9: numeric literal '0b12' has a digit invalid in "
+                        "its base"),
+            std::string::npos)
+      << output;
+}
+
+TEST(DriverTest, DiagnosesStringLiterals) {
+  std::string path = write_temp("strings", "int x = \"\\q\";\nint y = \"open");
+
+  std::string output =
+      capture_stdout([&] { Driver(with_jobs(1)).run({path}); });
+
+  EXPECT_NE(output.find("1:9: string literal has an unknown escape sequence"),
+            std::string::npos)
+      << output;
+  EXPECT_NE(output.find("2:9: string literal is missing its closing quote"),
+            std::string::npos)
+      << output;
+}
+
+TEST(DriverTest, DiagnosesLargeSources) {
+  // Large enough for the line table to be built across several threads
+  std::string text;
+  int lines = 0;
+  for (; text.size() < 4 * 1024 * 1024; lines++) {
+    text += "// " + std::string(lines % 97, 'x') + "\n";
+  }
+  text += "int x = $;\n";
+
+  std::string path = write_temp("large", text);
+
+  std::string output =
+      capture_stdout([&] { Driver(with_jobs(4)).run({path}); });
+
+  EXPECT_NE(output.find(std::to_string(lines + 1) + ":9: invalid token '$'"),
+            std::string::npos)
+      << output.substr(0, 200);
+}
+
+TEST(DriverTest, DiagnosticsInInputOrder) {
+  std::vector<std::string> inputs;
+  std::string expected_order;
+
+  for (int i = 0; i < 40; i++) {
+    std::string name = "order" + std::to_string(i);
+
+    // Uneven sizes, so files finish out of order
+    std::string text((40 - i) * 1000, ' ');
+    text += "int x = $;\nint y = $;\n";
+
+    inputs.push_back(write_temp(name, text));
+  }
+
+  std::string output;
+  for (unsigned jobs : {1, 3, 8}) {
+    std::string result = strip_timestamps(
+        capture_stdout([&] { Driver(with_jobs(jobs)).run(inputs); }));
+
+    if (jobs == 1) {
+      output = result;
+    } else {
+      EXPECT_EQ(result, output);
+    }
+  }
+
+  // Each file's two errors are adjacent, and the files are in order
+  size_t position = 0;
+  for (const auto& path : inputs) {
+    size_t first = output.find(path + ":", position);
+    ASSERT_NE(first, std::string::npos) << path;
+
+    size_t second = output.find(path + ":", first + 1);
+    ASSERT_NE(second, std::string::npos) << path;
+    EXPECT_EQ(output.find(testing::TempDir() + "driver_test_", first + 1),
+              second);
+
+    position = second + 1;
+  }
+
+  for (const auto& path : inputs) {
+    std::remove(path.c_str());
+  }
+}
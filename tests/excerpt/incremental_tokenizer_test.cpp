@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "excerpt/incremental_tokenizer.hpp"
+#include "excerpt/tokenizer.hpp"
+
+#include <random>
+#include <string>
+
+using namespace excerpt;
+
+namespace {
+  TokenBuffer lex(const std::string& source, Interner* interner = nullptr) {
+    Tokenizer tokenizer{std::string_view{source}};
+    tokenizer.set_interner(interner);
+    return tokenizer.tokenize_all();
+  }
+
+  // Applies the edit, re-lexes and compares with lexing from scratch
+  RelexResult expect_relexes(std::string& source, TokenBuffer& tokens,
+                             const SourceEdit& edit) {
+    source.replace(edit.offset, edit.removed, edit.inserted);
+    RelexResult result = relex(tokens, source, edit);
+
+    TokenBuffer expected = lex(source);
+    EXPECT_EQ(tokens.types, expected.types);
+    EXPECT_EQ(tokens.offsets, expected.offsets);
+    EXPECT_EQ(tokens.lengths, expected.lengths);
+
+    return result;
+  }
+}  // namespace
+
+TEST(IncrementalTokenizerTest, ExtendIdentifier) {
+  std::string source = "int ab = 1;\nint c = ab;\n";
+  TokenBuffer tokens = lex(source);
+
+  RelexResult result = expect_relexes(source, tokens, {6, 0, "x"});
+
+  EXPECT_EQ(result.first, 1u);
+  EXPECT_EQ(result.removed, 1u);
+  EXPECT_EQ(result.inserted, 1u);
+}
+
+TEST(IncrementalTokenizerTest, SplitAndJoinTokens) {
+  std::string source = "a = bc + 1.5;";
+  TokenBuffer tokens = lex(source);
+
+  expect_relexes(source, tokens, {5, 0, " "});   // a = b c + 1.5;
+  expect_relexes(source, tokens, {5, 1, ""});    // a = bc + 1.5;
+  expect_relexes(source, tokens, {11, 1, ""});   // a = bc + 15;
+  expect_relexes(source, tokens, {11, 0, "."});  // a = bc + 1.5;
+  expect_relexes(source, tokens, {2, 0, "="});   // a == bc + 1.5;
+}
+
+TEST(IncrementalTokenizerTest, OpenAndCloseComment) {
+  std::string source = "a b\nc d\ne f\n";
+  TokenBuffer tokens = lex(source);
+
+  expect_relexes(source, tokens, {2, 0, "/*"});
+  expect_relexes(source, tokens, {9, 0, "*/"});
+  expect_relexes(source, tokens, {2, 2, ""});
+  expect_relexes(source, tokens, {0, 0, "\""});
+  expect_relexes(source, tokens, {0, 1, ""});
+}
+
+TEST(IncrementalTokenizerTest, EditAtEnds) {
+  std::string source = "x y";
+  TokenBuffer tokens = lex(source);
+
+  expect_relexes(source, tokens, {0, 0, "w "});
+  expect_relexes(source, tokens, {source.size(), 0, " z"});
+  expect_relexes(source, tokens, {0, source.size(), ""});
+  expect_relexes(source, tokens, {0, 0, "int v;"});
+}
+
+TEST(IncrementalTokenizerTest, WorkIsLocal) {
+  std::string source;
+  for (int i = 0; i < 1000; i++) {
+    source += "int v" + std::to_string(i) + " = " + std::to_string(i) + ";\n";
+  }
+
+  TokenBuffer tokens = lex(source);
+  size_t offset = source.find("v500 ");
+  RelexResult result = expect_relexes(source, tokens, {offset + 1, 0, "9"});
+
+  EXPECT_LE(result.removed, 2u);
+  EXPECT_LE(result.inserted, 2u);
+}
+
+TEST(IncrementalTokenizerTest, KeepsSymbols) {
+  std::string source = "a b a";
+  Interner interner;
+  TokenBuffer tokens = lex(source, &interner);
+
+  source.replace(2, 1, "c");
+  relex(tokens, source, {2, 1, "c"}, &interner);
+
+  ASSERT_EQ(tokens.symbols.size(), tokens.size());
+  EXPECT_EQ(tokens.symbols[0], 0u);
+  EXPECT_EQ(interner.name(tokens.symbols[1]), "c");
+  EXPECT_EQ(tokens.symbols[2], 0u);
+}
+
+TEST(IncrementalTokenizerTest, RandomEdits) {
+  const std::string pieces[] = {"x", " ", "\n", "1", ".", "5", "\"",
+                                "/*", "*/", "//", "=", "<", "if", ";"};
+
+  std::mt19937 random(42);
+  std::string source = "int x = 1;\nif (x <= 2.5) { /* c */ y = \"s\"; }\n";
+  TokenBuffer tokens = lex(source);
+
+  for (int i = 0; i < 2000; i++) {
+    size_t offset = random() % (source.size() + 1);
+    size_t removed = random() % std::min<size_t>(4, source.size() - offset + 1);
+    const std::string& inserted = pieces[random() % std::size(pieces)];
+
+    SCOPED_TRACE("Edit " + std::to_string(i) + " of \"" + source + "\"");
+    expect_relexes(source, tokens, {offset, removed, inserted});
+
+    if (HasFailure()) {
+      return;
+    }
+  }
+}
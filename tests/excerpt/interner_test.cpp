@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include "excerpt/interner.hpp"
+
+#include <string>
+
+using namespace excerpt;
+
+TEST(InternerTest, DenseIds) {
+  Interner interner;
+
+  EXPECT_EQ(interner.intern("x"), 0u);
+  EXPECT_EQ(interner.intern("y"), 1u);
+  EXPECT_EQ(interner.intern("x"), 0u);
+  EXPECT_EQ(interner.intern(""), 2u);
+  EXPECT_EQ(interner.size(), 3u);
+
+  EXPECT_EQ(interner.name(0), "x");
+  EXPECT_EQ(interner.name(1), "y");
+  EXPECT_EQ(interner.name(2), "");
+}
+
+TEST(InternerTest, Find) {
+  Interner interner;
+  EXPECT_EQ(interner.find("x"), NO_SYMBOL);
+
+  interner.intern("x");
+  EXPECT_EQ(interner.find("x"), 0u);
+  EXPECT_EQ(interner.find("xx"), NO_SYMBOL);
+  EXPECT_EQ(interner.size(), 1u);
+}
+
+TEST(InternerTest, Growth) {
+  Interner interner;
+
+  for (int i = 0; i < 10000; i++) {
+    EXPECT_EQ(interner.intern("name_" + std::to_string(i)), SymbolId(i));
+  }
+
+  for (int i = 0; i < 10000; i++) {
+    std::string name = "name_" + std::to_string(i);
+
+    EXPECT_EQ(interner.find(name), SymbolId(i));
+    EXPECT_EQ(interner.name(i), name);
+  }
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "excerpt/codegen.hpp"
+#include "excerpt/jit.hpp"
+#include "excerpt/parser.hpp"
+#include "excerpt_utils/logger.hpp"
+
+#include <string>
+
+using namespace excerpt;
+
+namespace {
+  // Generates a program's module and adds it to a JIT
+  bool add(Jit& jit, const std::string& source, const std::string& name) {
+    Parser parser(source, name);
+    NodeId program = parser.parse();
+    if (program == NO_NODE) {
+      return false;
+    }
+
+    auto context = std::make_unique<llvm::LLVMContext>();
+    CodeGenerator generator(*context, source, parser.tokens(), parser.ast(),
+                            name);
+    auto module = generator.generate(program);
+
+    return module && jit.add(std::move(module), std::move(context));
+  }
+}  // namespace
+
+TEST(JitTest, RunsMain) {
+  for (OptLevel level : {OptLevel::O0, OptLevel::O2}) {
+    auto jit = Jit::create(level);
+    ASSERT_TRUE(jit);
+    ASSERT_TRUE(add(*jit,
+                    "int fib(int n) { if (n < 2) { return n; }\n"
+                    "  return fib(n - 1) + fib(n - 2); }\n"
+                    "int main() { return fib(20) % 256; }",
+                    "fib.ex"));
+
+    EXPECT_EQ(jit->run_main(), 6765 % 256);
+  }
+}
+
+TEST(JitTest, LinksModules) {
+  auto jit = Jit::create(OptLevel::O0);
+  ASSERT_TRUE(add(*jit, "int main() { return twice(21); }", "main.ex"));
+  ASSERT_TRUE(add(*jit, "int twice(int x) { return x * 2; }", "twice.ex"));
+
+  EXPECT_EQ(jit->run_main(), 42);
+}
+
+TEST(JitTest, CallsProcessFunctions) {
+  auto jit = Jit::create(OptLevel::O0);
+  ASSERT_TRUE(add(*jit, "int main() { return abs(0 - 5); }", "abs.ex"));
+
+  EXPECT_EQ(jit->run_main(), 5);
+}
+
+TEST(JitTest, CompilesLazily) {
+  auto jit = Jit::create(OptLevel::O2);
+  ASSERT_TRUE(add(*jit,
+                  "int called(int x) { return x + 1; }\n"
+                  "int never(int x) { return x * 2; }\n"
+                  "int also_never() { return never(3); }\n"
+                  "int main() { return called(2); }",
+                  "lazy.ex"));
+
+  EXPECT_EQ(jit->compiled_functions(), 0u);
+  EXPECT_EQ(jit->run_main(), 3);
+  EXPECT_EQ(jit->compiled_functions(), 2u);
+
+  // Finding a function does not compile it, calling it does
+  auto also_never = reinterpret_cast<int (*)()>(jit->lookup("also_never"));
+  EXPECT_EQ(jit->compiled_functions(), 2u);
+  EXPECT_EQ(also_never(), 6);
+  EXPECT_EQ(jit->compiled_functions(), 4u);
+}
+
+TEST(JitTest, UndefinedFunction) {
+  std::string errors;
+  logger::Capture capture(errors);
+
+  auto jit = Jit::create(OptLevel::O0);
+  ASSERT_TRUE(add(*jit,
+                  "int broken() { return no_such_function(); }\n"
+                  "int main() { return broken(); }",
+                  "undefined.ex"));
+
+  EXPECT_EQ(jit->run_main(), std::nullopt);
+  EXPECT_NE(errors.find("no_such_function"), std::string::npos);
+  EXPECT_EQ(jit->compiled_functions(), 0u);
+}
+
+TEST(JitTest, Errors) {
+  std::string errors;
+  logger::Capture capture(errors);
+
+  auto jit = Jit::create(OptLevel::O0);
+  EXPECT_FALSE(add(*jit, "float main() { return 1; }", "float.ex"));
+  EXPECT_NE(errors.find("'main' must be declared as 'int main()'"),
+            std::string::npos);
+
+  ASSERT_TRUE(add(*jit, "int f() { return 1; }", "a.ex"));
+  EXPECT_FALSE(add(*jit, "int f() { return 2; }", "b.ex"));
+  EXPECT_NE(errors.find("Duplicate definition of symbol"), std::string::npos);
+
+  EXPECT_EQ(jit->run_main(), std::nullopt);
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include "excerpt/lexer_tables.hpp"
+
+#include <cctype>
+
+using namespace excerpt;
+
+TEST(LexerTablesTest, CharClassesMatchCLocale) {
+  for (int ch = 0; ch < 256; ch++) {
+    SCOPED_TRACE("Character: " + std::to_string(ch));
+
+    EXPECT_EQ(has_class(ch, CHAR_SPACE), ch < 128 && std::isspace(ch) != 0);
+    EXPECT_EQ(has_class(ch, CHAR_DIGIT), ch < 128 && std::isdigit(ch) != 0);
+    EXPECT_EQ(has_class(ch, CHAR_IDENT_START),
+              ch < 128 && (std::isalpha(ch) || ch == '_'));
+    EXPECT_EQ(has_class(ch, CHAR_IDENT),
+              ch < 128 && (std::isalnum(ch) || ch == '_'));
+  }
+}
+
+TEST(LexerTablesTest, OperatorSpellings) {
+  for (const auto& op : OPERATORS) {
+    SCOPED_TRACE("Operator: " + std::string(op.spelling));
+
+    OperatorMatch match = OPERATOR_DFA.match(op.spelling);
+    EXPECT_EQ(match.type, op.type);
+    EXPECT_EQ(match.length, op.spelling.size());
+    EXPECT_TRUE(has_class(op.spelling[0], CHAR_OPERATOR));
+  }
+}
+
+TEST(LexerTablesTest, OperatorMaximalMunch) {
+  static_assert(OPERATOR_DFA.match("<=").type == TokenType::LESS_EQUAL);
+
+  OperatorMatch match = OPERATOR_DFA.match("<==");
+  EXPECT_EQ(match.type, TokenType::LESS_EQUAL);
+  EXPECT_EQ(match.length, 2u);
+
+  match = OPERATOR_DFA.match("=<");
+  EXPECT_EQ(match.type, TokenType::ASSIGN);
+  EXPECT_EQ(match.length, 1u);
+
+  // A prefix of an operator that is not an operator itself
+  match = OPERATOR_DFA.match("!x");
+  EXPECT_EQ(match.type, TokenType::INVALID);
+  EXPECT_EQ(match.length, 0u);
+
+  match = OPERATOR_DFA.match("@");
+  EXPECT_EQ(match.type, TokenType::INVALID);
+  EXPECT_EQ(match.length, 0u);
+
+  match = OPERATOR_DFA.match("");
+  EXPECT_EQ(match.length, 0u);
+}
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include "excerpt/arena.hpp"
+#include "excerpt/interner.hpp"
+#include "excerpt/memory.hpp"
+#include "excerpt/parallel_tokenizer.hpp"
+
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace excerpt;
+
+TEST(MemoryTest, DisabledCountsNothing) {
+  memory::start();
+  memory::stop();
+
+  {
+    memory::Scope scope(memory::SYMBOLS);
+    ::operator delete(::operator new(1000));
+  }
+
+  EXPECT_EQ(memory::subsystems()[memory::SYMBOLS].allocations, 0u);
+}
+
+TEST(MemoryTest, CountsBySubsystem) {
+  memory::start();
+  void* first;
+  void* second;
+
+  {
+    memory::Scope scope(memory::SYMBOLS);
+    first = ::operator new(1000);
+    second = ::operator new(3000, std::align_val_t(64));
+
+    // Nested scopes charge the innermost
+    memory::Scope inner(memory::TOKENIZER);
+    ::operator delete(::operator new(10));
+  }
+
+  memory::Usage symbols = memory::subsystems()[memory::SYMBOLS];
+  EXPECT_EQ(symbols.allocations, 2u);
+  EXPECT_GE(symbols.bytes, 4000u);
+  EXPECT_GE(symbols.peak, 4000u);
+  EXPECT_EQ(symbols.frees, 0u);
+  EXPECT_EQ(memory::subsystems()[memory::TOKENIZER].allocations, 1u);
+  EXPECT_EQ(memory::subsystems()[memory::TOKENIZER].frees, 1u);
+
+  {
+    memory::Scope scope(memory::SYMBOLS);
+    ::operator delete(first);
+    ::operator delete(second, std::align_val_t(64));
+  }
+
+  memory::stop();
+
+  symbols = memory::subsystems()[memory::SYMBOLS];
+  EXPECT_EQ(symbols.frees, 2u);
+  EXPECT_EQ(symbols.freed_bytes, symbols.bytes);
+  EXPECT_GE(memory::peak(), 4000u);
+}
+
+TEST(MemoryTest, CountsByPhase) {
+  memory::start();
+
+  {
+    timing::ScopedTimer timer(timing::PARSE);
+    EXPECT_EQ(memory::current_subsystem(), memory::AST);
+    ::operator delete(::operator new(500));
+  }
+
+  EXPECT_EQ(memory::current_subsystem(), memory::OTHER);
+  memory::stop();
+
+  memory::Usage parse = memory::phases()[timing::PARSE];
+  EXPECT_EQ(parse.allocations, 1u);
+  EXPECT_EQ(parse.frees, 1u);
+  EXPECT_GE(parse.bytes, 500u);
+  EXPECT_EQ(memory::subsystems()[memory::AST].allocations, 1u);
+}
+
+TEST(MemoryTest, PeakAcrossThreads) {
+  memory::start();
+
+  // Four blocks are live at once, whichever threads allocated them
+  std::vector<void*> blocks(4);
+  std::vector<std::thread> threads;
+  for (void*& block : blocks) {
+    threads.emplace_back([&block] {
+      memory::Scope scope(memory::LLVM);
+      block = ::operator new(1 << 20);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (void* block : blocks) {
+    ::operator delete(block);
+  }
+
+  memory::stop();
+
+  EXPECT_EQ(memory::subsystems()[memory::LLVM].allocations, 4u);
+  EXPECT_GE(memory::peak(), 4u << 20);
+  EXPECT_LT(memory::live(), 1 << 20);
+}
+
+TEST(MemoryTest, WorkersChargeCallersPhase) {
+  std::string source;
+  for (int i = 0; source.size() < 256 * 1024; i++) {
+    source += "int name" + std::to_string(i) + " = " + std::to_string(i) +
+              ";\n";
+  }
+
+  Interner names;
+  memory::start();
+
+  {
+    // Lexed by four threads, all of which lex in the caller's phase
+    timing::ScopedTimer timer(timing::LEX);
+    TokenBuffer tokens = tokenize_parallel(source, 4, 1024, &names);
+    EXPECT_GT(tokens.size(), 0u);
+  }
+
+  memory::stop();
+
+  EXPECT_GT(memory::phases()[timing::LEX].allocations, 0u);
+  EXPECT_EQ(memory::phases()[timing::PHASE_COUNT].allocations, 0u);
+  EXPECT_GT(memory::subsystems()[memory::TOKENIZER].allocations, 0u);
+  EXPECT_GT(memory::subsystems()[memory::SYMBOLS].allocations, 0u);
+  EXPECT_EQ(memory::subsystems()[memory::OTHER].allocations, 0u);
+}
+
+TEST(MemoryTest, ArenaReportsUse) {
+  memory::start();
+
+  {
+    Arena arena(1024, memory::AST);
+    arena.allocate(100);
+    arena.allocate(200);
+  }
+
+  memory::stop();
+
+  memory::ArenaUsage ast = memory::arenas()[memory::AST];
+  EXPECT_EQ(ast.releases, 1u);
+  EXPECT_EQ(ast.used, 300u);
+  EXPECT_EQ(ast.reserved, 1024u);
+}
+
+TEST(MemoryTest, InternerChargesSymbols) {
+  memory::start();
+
+  {
+    Interner names;
+    names.intern("alpha");
+    names.intern("beta");
+  }
+
+  memory::stop();
+
+  EXPECT_GT(memory::subsystems()[memory::SYMBOLS].allocations, 0u);
+}
+
+TEST(MemoryTest, Report) {
+  memory::start();
+
+  {
+    memory::Scope scope(memory::TOKENIZER);
+    ::operator delete(::operator new(100));
+  }
+
+  memory::stop();
+  std::string report = memory::report();
+
+  EXPECT_NE(report.find("tokenizer"), std::string::npos);
+  EXPECT_NE(report.find("peak live"), std::string::npos);
+
+  // Subsystems that allocated nothing are left out
+  EXPECT_EQ(report.find("symbols"), std::string::npos);
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include "excerpt/number_literal.hpp"
+
+#include <cmath>
+#include <string>
+
+using namespace excerpt;
+
+TEST(NumberLiteralTest, Integers) {
+  const struct {
+    std::string spelling;
+    int64_t value;
+  } testCases[] = {{"0", 0},
+                   {"42", 42},
+                   {"0x1F", 31},
+                   {"0XfF", 255},
+                   {"0b101", 5},
+                   {"0B11", 3},
+                   {"017", 15},
+                   {"00", 0},
+                   {"1_000_000", 1000000},
+                   {"0xFF_FF", 65535},
+                   {"0b1_0", 2},
+                   {"9223372036854775807", INT64_MAX},
+                   {"0x7FFFFFFFFFFFFFFF", INT64_MAX}};
+
+  for (const auto& testCase : testCases) {
+    SCOPED_TRACE("Literal: " + testCase.spelling);
+    NumberLiteral literal = decode_number(testCase.spelling);
+
+    EXPECT_EQ(literal.type, TokenType::INTEGER_LITERAL);
+    EXPECT_EQ(literal.error, LiteralError::NONE);
+    EXPECT_EQ(literal.value.integer, testCase.value);
+  }
+}
+
+TEST(NumberLiteralTest, Doubles) {
+  const struct {
+    std::string spelling;
+    double value;
+  } testCases[] = {{"3.14", 3.14},       {"0.5", 0.5},   {"1e3", 1000.0},
+                   {"2.5E-2", 0.025},    {"1e+2", 100.0}, {"08.5", 8.5},
+                   {"1_000.000_1", 1000.0001},
+                   {"1.7976931348623157e308", 1.7976931348623157e308}};
+
+  for (const auto& testCase : testCases) {
+    SCOPED_TRACE("Literal: " + testCase.spelling);
+    NumberLiteral literal = decode_number(testCase.spelling);
+
+    EXPECT_EQ(literal.type, TokenType::FLOAT_LITERAL);
+    EXPECT_EQ(literal.error, LiteralError::NONE);
+    EXPECT_DOUBLE_EQ(literal.value.real, testCase.value);
+  }
+}
+
+TEST(NumberLiteralTest, Errors) {
+  const struct {
+    std::string spelling;
+    LiteralError error;
+  } testCases[] = {{"1abc", LiteralError::MALFORMED},
+                   {"0x", LiteralError::MALFORMED},
+                   {"0xg", LiteralError::MALFORMED},
+                   {"1e", LiteralError::MALFORMED},
+                   {"1.2.3", LiteralError::MALFORMED},
+                   {"1__0", LiteralError::SEPARATOR},
+                   {"1_", LiteralError::SEPARATOR},
+                   {"0x_1", LiteralError::SEPARATOR},
+                   {"1_e5", LiteralError::SEPARATOR},
+                   {"09", LiteralError::INVALID_DIGIT},
+                   {"018", LiteralError::INVALID_DIGIT},
+                   {"0b102", LiteralError::INVALID_DIGIT},
+                   {"9223372036854775808", LiteralError::TOO_LARGE},
+                   {"18446744073709551616", LiteralError::TOO_LARGE},
+                   {"0x1_0000_0000_0000_0000", LiteralError::TOO_LARGE},
+                   {"1e400", LiteralError::OUT_OF_RANGE}};
+
+  for (const auto& testCase : testCases) {
+    SCOPED_TRACE("Literal: " + testCase.spelling);
+    NumberLiteral literal = decode_number(testCase.spelling);
+
+    EXPECT_EQ(literal.type, TokenType::INVALID);
+    EXPECT_EQ(literal.error, testCase.error);
+  }
+}
+
+TEST(NumberLiteralTest, Describes) {
+  EXPECT_STREQ(describe(LiteralError::TOO_LARGE),
+               "is too large for a 64-bit integer");
+  EXPECT_STREQ(describe(LiteralError::SEPARATOR),
+               "has a digit separator not between two digits");
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "excerpt/parallel_tokenizer.hpp"
+#include "excerpt/tokenizer.hpp"
+
+#include <string>
+
+using namespace excerpt;
+
+namespace {
+  void expect_same_tokens(const TokenBuffer& actual,
+                          const TokenBuffer& expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    EXPECT_EQ(actual.types, expected.types);
+    EXPECT_EQ(actual.offsets, expected.offsets);
+    EXPECT_EQ(actual.lengths, expected.lengths);
+  }
+
+  // Checks every split of the source into chunks of a few bytes
+  void expect_matches_serial(const std::string& source) {
+    TokenBuffer expected = Tokenizer(std::string_view{source}).tokenize_all();
+
+    for (unsigned threads = 1; threads <= 8; threads++) {
+      for (size_t chunk = 1; chunk <= 8; chunk++) {
+        SCOPED_TRACE("Threads: " + std::to_string(threads) +
+                     ", chunk: " + std::to_string(chunk));
+        expect_same_tokens(tokenize_parallel(source, threads, chunk),
+                           expected);
+      }
+    }
+  }
+}  // namespace
+
+TEST(ParallelTokenizerTest, MatchesSerial) {
+  expect_matches_serial("int x = 42;\nfloat y = 3.14;\nif (x <= y) {\n}\n");
+}
+
+TEST(ParallelTokenizerTest, ChunkInsideBlockComment) {
+  expect_matches_serial(
+      "a\n/* int x;\nint y;\n\"\nint z;\n*/ b\nc\n/* unclosed\nd\ne\n");
+}
+
+TEST(ParallelTokenizerTest, ChunkInsideString) {
+  expect_matches_serial(
+      "a \"x\ny /* z\nw\" b\n*/ c\n\"unterminated\nd\ne\nf\n");
+}
+
+TEST(ParallelTokenizerTest, ChunkInsideEscapedString) {
+  expect_matches_serial(
+      "a \"x\\\"\ny \\\" z\nw\" b\n\"c\\\\\" d\ne \"\\\nf\" g\n");
+}
+
+TEST(ParallelTokenizerTest, EmbeddedNul) {
+  expect_matches_serial(std::string("a\nb\n\0c\nd\n", 10));
+}
+
+TEST(ParallelTokenizerTest, LargeSource) {
+  std::string source;
+  for (int i = 0; i < 20000; i++) {
+    source += "int v" + std::to_string(i) + " = " + std::to_string(i) +
+              "; // line\n";
+    if (i % 7 == 0) source += "/* a\n block\n comment */\n";
+    if (i % 11 == 0) source += "\"a\nmulti-line string\"\n";
+  }
+
+  TokenBuffer expected = Tokenizer(std::string_view{source}).tokenize_all();
+
+  expect_same_tokens(tokenize_parallel(source, 4, 1024), expected);
+  expect_same_tokens(tokenize_parallel(source, 4), expected);
+}
+
+TEST(ParallelTokenizerTest, InternsLikeSerial) {
+  std::string source;
+  for (int i = 0; i < 200; i++) {
+    source += "int v" + std::to_string(i % 37) + " = w" +
+              std::to_string(i % 13) + ";\n";
+    if (i % 9 == 0) source += "/* x\n y */ \"z\nw\"\n";
+  }
+
+  Interner serial_names;
+  Tokenizer serial(std::string_view{source});
+  serial.set_interner(&serial_names);
+  TokenBuffer expected = serial.tokenize_all();
+
+  for (unsigned threads : {1, 3, 8}) {
+    SCOPED_TRACE("Threads: " + std::to_string(threads));
+
+    Interner names;
+    TokenBuffer actual = tokenize_parallel(source, threads, 16, &names);
+
+    expect_same_tokens(actual, expected);
+    EXPECT_EQ(actual.symbols, expected.symbols);
+    ASSERT_EQ(names.size(), serial_names.size());
+
+    for (SymbolId id = 0; id < names.size(); id++) {
+      EXPECT_EQ(names.name(id), serial_names.name(id));
+    }
+  }
+}
@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include "excerpt/parallel_tokenizer.hpp"
+#include "excerpt/parser.hpp"
+
+#include <string>
+
+using namespace excerpt;
+
+namespace {
+  std::string parse_expression(const std::string& source) {
+    Parser parser(source);
+    return parser.dump(parser.parse_expression());
+  }
+
+  std::string parse_program(const std::string& source) {
+    Parser parser(source);
+    return parser.dump(parser.parse());
+  }
+}  // namespace
+
+TEST(ParserTest, Precedence) {
+  const struct {
+    std::string source;
+    std::string expected;
+  } testCases[] = {
+      {"1 + 2 * 3", "(+ 1 (* 2 3))"},
+      {"1 * 2 + 3", "(+ (* 1 2) 3)"},
+      {"1 - 2 - 3", "(- (- 1 2) 3)"},
+      {"a < b == c >= d", "(== (< a b) (>= c d))"},
+      {"a = b = c + 1", "(= a (= b (+ c 1)))"},
+      {"(1 + 2) * 3", "(* (+ 1 2) 3)"},
+      {"-a * -(b % 2)", "(* (- a) (- (% b 2)))"},
+      {"- -1", "(- (- 1))"},
+      {"x != 2.5 + \"s\" / true", "(!= x (+ 2.5 (/ \"s\" true)))"}};
+
+  for (const auto& testCase : testCases) {
+    SCOPED_TRACE("Source: " + testCase.source);
+    EXPECT_EQ(parse_expression(testCase.source), testCase.expected);
+  }
+}
+
+TEST(ParserTest, Calls) {
+  EXPECT_EQ(parse_expression("f()"), "(call f)");
+  EXPECT_EQ(parse_expression("f(1, g(2, 3) + 4)"),
+            "(call f 1 (+ (call g 2 3) 4))");
+  EXPECT_EQ(parse_expression("-f(x)(y)"), "(- (call (call f x) y))");
+  EXPECT_EQ(parse_expression("(f)(x * (y))"), "(call f (* x y))");
+}
+
+TEST(ParserTest, Statements) {
+  EXPECT_EQ(
+      parse_program("int main() {\n"
+                    "  int x = 1;\n"
+                    "  float y;\n"
+                    "  if (x < 2) x = 2; else { y = x; }\n"
+                    "  while (x) { break; continue; }\n"
+                    "  for (int i = 0; i < 10; i = i + 1) ;\n"
+                    "  for (;;) {}\n"
+                    "  print(x);\n"
+                    "  return;\n"
+                    "}\n"),
+      "(program (function int main () {"
+      " (int x 1)"
+      " (float y)"
+      " (if (< x 2) (= x 2); { (= y x); })"
+      " (while x { (break) (continue) })"
+      " (for (int i 0) (< i 10) (= i (+ i 1)) { })"
+      " (for _ _ _ { })"
+      " (call print x);"
+      " (return) }))");
+}
+
+TEST(ParserTest, FunctionsAndGlobals) {
+  EXPECT_EQ(parse_program("bool flag = true;\n"
+                          "int add(int a, float b) { return a + b; }\n"
+                          "char c;"),
+            "(program (bool flag true)"
+            " (function int add ((int a) (float b)) { (return (+ a b)) })"
+            " (char c))");
+
+  EXPECT_EQ(parse_program(""), "(program)");
+}
+
+TEST(ParserTest, NodesReferToTokens) {
+  Parser parser("int x = 40 + 2;");
+  NodeId program = parser.parse();
+
+  const Ast& ast = parser.ast();
+  const Node& declaration = ast.node(ast.list(ast.node(program).lhs)[0]);
+
+  EXPECT_EQ(declaration.kind, NodeKind::DECLARATION);
+  EXPECT_EQ(declaration.op, TokenType::INT);
+  EXPECT_EQ(parser.spelling(declaration.token), "x");
+
+  const Node& sum = ast.node(declaration.lhs);
+  EXPECT_EQ(sum.kind, NodeKind::BINARY);
+  EXPECT_EQ(parser.tokens().offsets[sum.token], 11u);
+}
+
+TEST(ParserTest, PrelexedTokens) {
+  std::string source = "int f(int a) { return f(a - 1) * 2; }\nint x;";
+
+  Parser lexing(source);
+  Parser prelexed(source, tokenize_parallel(source));
+
+  EXPECT_EQ(prelexed.dump(prelexed.parse()), lexing.dump(lexing.parse()));
+}
+
+TEST(ParserTest, DeepNesting) {
+  // Expressions nest without recursion
+  const size_t depth = 100000;
+  std::string source = std::string(depth, '(') + "x" +
+                       std::string(depth, ')') + " + " +
+                       std::string(depth, '-') + "1";
+
+  Parser parser(source);
+  NodeId root = parser.parse_expression();
+
+  ASSERT_NE(root, NO_NODE);
+  EXPECT_EQ(parser.ast().node(root).kind, NodeKind::BINARY);
+  EXPECT_EQ(parser.ast().size(), 3 + depth);
+}
+
+TEST(ParserTest, LongElseIfChains) {
+  // A chain is flat code, however many arms it has
+  const size_t arms = 4 * Parser::MAX_DEPTH;
+  std::string source = "int f(int x) {\n  if (x == 0) { return 0; }\n";
+  for (size_t i = 1; i < arms; i++) {
+    source += "  else if (x == " + std::to_string(i) + ") { return " +
+              std::to_string(i) + "; }\n";
+  }
+  source += "  else { return -1; }\n}\n";
+
+  Parser parser(source);
+  NodeId root = parser.parse();
+  ASSERT_NE(root, NO_NODE);
+
+  // The arms are IF nodes, each the `else` of the one before
+  const Ast& ast = parser.ast();
+  NodeId function = ast.list(ast.node(root).lhs)[0];
+  NodeId statement = ast.list(ast.node(ast.node(function).rhs).lhs)[0];
+  size_t count = 0;
+
+  for (; ast.node(statement).kind == NodeKind::IF; count++) {
+    statement = ast.list(ast.node(statement).rhs)[1];
+  }
+
+  EXPECT_EQ(count, arms);
+  EXPECT_EQ(ast.node(statement).kind, NodeKind::BLOCK);
+}
+
+TEST(ParserTest, Errors) {
+  const std::string sources[] = {
+      "int main() { return 1 }",
+      "int main() { x = ; }",
+      "int main() { (1 + 2 = 3); }",
+      "int main() { f(1,); }",
+      "int main() { (a, b); }",
+      "int main() { ((a); }",
+      "int main() { if x {} }",
+      "int main() {",
+      "int main(int) {}",
+      "x = 1;",
+      "int main() { @; }",
+      "int f() {" + std::string(Parser::MAX_DEPTH + 1, '{') +
+          std::string(Parser::MAX_DEPTH + 2, '}')};
+
+  for (const auto& source : sources) {
+    SCOPED_TRACE("Source: " + source);
+
+    testing::internal::CaptureStdout();
+    Parser parser(source);
+    NodeId root = parser.parse();
+    std::string output = testing::internal::GetCapturedStdout();
+
+    EXPECT_EQ(root, NO_NODE);
+    EXPECT_NE(output.find("ERROR"), std::string::npos);
+    EXPECT_NE(output.find("<string>:1:"), std::string::npos);
+  }
+}
+
+TEST(ParserTest, ErrorMessage) {
+  testing::internal::CaptureStdout();
+  Parser parser("int main() {\n  return 1\n}", "main.ex");
+  parser.parse();
+  std::string output = testing::internal::GetCapturedStdout();
+
+  EXPECT_NE(output.find("main.ex:3:1: expected ';' after return value, "
+                        "found '}'"),
+            std::string::npos);
+}
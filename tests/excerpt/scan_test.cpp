@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "excerpt/scan.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace excerpt;
+
+namespace {
+  // The instruction sets the running CPU can test
+  std::vector<scan::Isa> supported_isas() {
+    std::vector<scan::Isa> isas;
+
+    for (scan::Isa isa : {scan::Isa::SSE2, scan::Isa::AVX2}) {
+      if (scan::supported(isa)) {
+        isas.push_back(isa);
+      }
+    }
+
+    return isas;
+  }
+
+  // Random inputs drawn from `alphabet`, long enough to cover every tail
+  std::vector<std::string> random_inputs(const std::string& alphabet) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+    std::vector<std::string> inputs;
+
+    for (size_t length = 0; length <= 200; length++) {
+      std::string input;
+      for (size_t i = 0; i < length; i++) {
+        input.push_back(alphabet[pick(rng)]);
+      }
+
+      inputs.push_back(input);
+    }
+
+    return inputs;
+  }
+
+  // Checks a scanner against its scalar counterpart at every offset
+  void expect_matches_scalar(scan::Scanner scanner, scan::Scanner scalar,
+                             const std::string& alphabet) {
+    for (const auto& input : random_inputs(alphabet)) {
+      const char* end = input.data() + input.size();
+
+      for (size_t offset = 0; offset <= input.size(); offset++) {
+        const char* begin = input.data() + offset;
+        ASSERT_EQ(scanner(begin, end), scalar(begin, end))
+            << "input: " << input << ", offset: " << offset;
+      }
+    }
+  }
+}  // namespace
+
+TEST(ScanTest, ScalarKernels) {
+  const scan::Kernels& scalar = scan::kernels(scan::Isa::SCALAR);
+  std::string input = " \t\r\nabc_Z9 123x// /* ** */\n";
+  const char* begin = input.data();
+  const char* end = begin + input.size();
+
+  EXPECT_EQ(scalar.skip_space(begin, end), begin + 4);
+  EXPECT_EQ(scalar.skip_ident(begin + 4, end), begin + 10);
+  EXPECT_EQ(scalar.skip_digits(begin + 11, end), begin + 14);
+  EXPECT_EQ(scalar.find_newline(begin + 4, end), end - 1);
+  EXPECT_EQ(scalar.find_comment_end(begin, end), end - 3);
+  EXPECT_EQ(scalar.find_string_end(begin, end), end);
+  EXPECT_EQ(scalar.count_newlines(begin, end), 2u);
+
+  // A lone star at the end does not close a comment
+  EXPECT_EQ(scalar.find_comment_end(end - 4, end - 2), end - 2);
+}
+
+TEST(ScanTest, SkipSpace) {
+  for (scan::Isa isa : supported_isas()) {
+    expect_matches_scalar(scan::kernels(isa).skip_space,
+                          scan::kernels(scan::Isa::SCALAR).skip_space,
+                          std::string(" \t\n\v\f\r\r\n  \x08\x0e!~", 16));
+  }
+}
+
+TEST(ScanTest, SkipIdent) {
+  for (scan::Isa isa : supported_isas()) {
+    expect_matches_scalar(scan::kernels(isa).skip_ident,
+                          scan::kernels(scan::Isa::SCALAR).skip_ident,
+                          "azAZ09_mQ5@[`{/:\x80\xff");
+  }
+}
+
+TEST(ScanTest, SkipDigits) {
+  for (scan::Isa isa : supported_isas()) {
+    expect_matches_scalar(scan::kernels(isa).skip_digits,
+                          scan::kernels(scan::Isa::SCALAR).skip_digits,
+                          "0123456789012345/:a");
+  }
+}
+
+TEST(ScanTest, FindNewline) {
+  for (scan::Isa isa : supported_isas()) {
+    expect_matches_scalar(scan::kernels(isa).find_newline,
+                          scan::kernels(scan::Isa::SCALAR).find_newline,
+                          "abcdefghijklmnopqrstuvwxyz \r\t\x8a\n");
+  }
+}
+
+TEST(ScanTest, FindCommentEnd) {
+  for (scan::Isa isa : supported_isas()) {
+    expect_matches_scalar(scan::kernels(isa).find_comment_end,
+                          scan::kernels(scan::Isa::SCALAR).find_comment_end,
+                          "abcdefghij*/\n *");
+  }
+}
+
+TEST(ScanTest, FindStringEnd) {
+  for (scan::Isa isa : supported_isas()) {
+    expect_matches_scalar(scan::kernels(isa).find_string_end,
+                          scan::kernels(scan::Isa::SCALAR).find_string_end,
+                          std::string("abcdefghijklmnopqrstuvwx \"\\\0", 28));
+  }
+}
+
+TEST(ScanTest, CountNewlines) {
+  for (scan::Isa isa : supported_isas()) {
+    for (const auto& input : random_inputs("ab\n\r ")) {
+      const char* end = input.data() + input.size();
+
+      for (size_t offset = 0; offset <= input.size(); offset++) {
+        const char* begin = input.data() + offset;
+        ASSERT_EQ(scan::kernels(isa).count_newlines(begin, end),
+                  scan::kernels(scan::Isa::SCALAR).count_newlines(begin, end));
+      }
+    }
+  }
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include "excerpt/source_buffer.hpp"
+#include "excerpt/tokenizer.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace excerpt;
+
+namespace {
+  // Writes `text` to a fresh temporary file and returns its path
+  std::string write_temp(const std::string& text) {
+    std::string path = testing::TempDir() + "source_buffer_test.ex";
+    std::ofstream(path, std::ios::binary) << text;
+    return path;
+  }
+}  // namespace
+
+TEST(SourceBufferTest, MapsRegularFile) {
+  std::string path = write_temp("int x = 42;\n");
+
+  auto buffer = SourceBuffer::open(path);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_TRUE(buffer->mapped());
+  EXPECT_EQ(buffer->text(), "int x = 42;\n");
+  EXPECT_EQ(buffer->name(), path);
+
+  std::remove(path.c_str());
+}
+
+TEST(SourceBufferTest, EmptyFile) {
+  std::string path = write_temp("");
+
+  auto buffer = SourceBuffer::open(path);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_FALSE(buffer->mapped());
+  EXPECT_EQ(buffer->text(), "");
+
+  std::remove(path.c_str());
+}
+
+TEST(SourceBufferTest, MissingFile) {
+  EXPECT_EQ(SourceBuffer::open(testing::TempDir() + "missing.ex"), nullptr);
+}
+
+TEST(SourceBufferTest, FromString) {
+  auto text = std::make_shared<std::string>("abc");
+  auto buffer = SourceBuffer::from_string(text);
+
+  EXPECT_FALSE(buffer->mapped());
+  EXPECT_EQ(buffer->text().data(), text->data());
+}
+
+TEST(SourceBufferTest, TokenizeMapping) {
+  std::string path = write_temp("while (x) { y = 1; }");
+  auto buffer = SourceBuffer::open(path);
+  ASSERT_NE(buffer, nullptr);
+
+  Tokenizer tokenizer(buffer);
+  TokenBuffer tokens = tokenizer.tokenize_all();
+
+  ASSERT_EQ(tokens.size(), 11u);
+  EXPECT_EQ(tokens.types[0], TokenType::WHILE);
+  EXPECT_EQ(tokens.types[10], TokenType::END);
+
+  std::remove(path.c_str());
+}
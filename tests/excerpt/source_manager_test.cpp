@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "excerpt/source_manager.hpp"
+
+#include <string>
+
+using namespace excerpt;
+
+TEST(SourceManagerTest, LineStarts) {
+  std::string source = "ab\n\ncd\n";
+  SourceManager manager(source);
+
+  const std::vector<uint32_t> expected = {0, 3, 4, 7};
+  EXPECT_EQ(manager.line_starts(), expected);
+}
+
+TEST(SourceManagerTest, Location) {
+  std::string source = "int x;\n  y = 1;\n\nz";
+  SourceManager manager(source);
+
+  const struct {
+    uint32_t offset;
+    uint32_t line;
+    uint32_t column;
+  } testCases[] = {{0, 1, 1},  {4, 1, 5},  {6, 1, 7},  {7, 2, 1},
+                   {9, 2, 3},  {16, 3, 1}, {17, 4, 1}, {18, 4, 2}};
+
+  for (const auto& testCase : testCases) {
+    SCOPED_TRACE("Offset: " + std::to_string(testCase.offset));
+
+    SourceLocation location = manager.location(testCase.offset);
+    EXPECT_EQ(location.line, testCase.line);
+    EXPECT_EQ(location.column, testCase.column);
+  }
+}
+
+TEST(SourceManagerTest, LongSource) {
+  // Long enough for the vectorized newline scan
+  std::string source;
+  for (int i = 0; i < 1000; i++) {
+    source += std::string(i % 70, 'x') + "\n";
+  }
+
+  SourceManager manager(source);
+  ASSERT_EQ(manager.line_starts().size(), 1001u);
+
+  uint32_t offset = 0;
+  for (uint32_t line = 1; line <= 1000; line++) {
+    EXPECT_EQ(manager.location(offset).line, line);
+    EXPECT_EQ(manager.location(offset).column, 1u);
+    offset += (line - 1) % 70 + 1;
+  }
+}
+
+TEST(SourceManagerTest, EmptySource) {
+  SourceManager manager("");
+
+  SourceLocation location = manager.location(0);
+  EXPECT_EQ(location.line, 1u);
+  EXPECT_EQ(location.column, 1u);
+}
+
+TEST(SourceManagerTest, IndexLinesInParallel) {
+  // Large enough to be split into several chunks
+  std::string source;
+  for (int i = 0; source.size() < 4 * 1024 * 1024; i++) {
+    source += std::string(i % 97, 'x') + "\n";
+  }
+
+  SourceManager serial(source);
+  SourceManager parallel(source);
+  parallel.index_lines(4);
+
+  EXPECT_EQ(parallel.line_starts(), serial.line_starts());
+}
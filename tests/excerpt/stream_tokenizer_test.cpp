@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include "excerpt/stream_tokenizer.hpp"
+#include "excerpt/string_literal.hpp"
+#include "excerpt/tokenizer.hpp"
+
+#include <sstream>
+#include <string>
+#include <string_view>
+
+using namespace excerpt;
+
+namespace {
+  // The sources of tokenizer_test.cpp, and inputs that stress the window edge
+  // Sized views, so that sources may hold a NUL
+  const std::string_view SOURCES[] = {
+      "123 3.14",
+      "\"Hello, World!\"",
+      "variable_name _foo if else while for break continue return true false",
+      "int float char bool PLUS IDENTIFIER",
+      "+-*/%(){}[];:,.",
+      "== != <= >= < >",
+      "int x; // This is a comment\n",
+      "/* This is\na multi-line\ncomment */ int y;",
+      "int /* Comment */ z; // Another comment\n",
+      "foo 42 \"bar\" <=",
+      "int x = 42;\n\"hi\"",
+      "@ x",
+      "/* a\nblock */ x // line\n    y\t/* */z",
+      "1. 1.5.6 x.y 12345678901234567890",
+      "a/b/ /c//d\n/**/e/*/ f */g/***/h",
+      "\"multi\nline\" \"unterminated",
+      "x /* unterminated",
+      "\"a\\\"b\" \"\\x41\\u{e9}\\n\" \"bad\\q\" x \"\\\\\" \"tail\\",
+      "!!= =!= <== >>= ! =",
+      std::string_view("a\0b", 3),
+      "",
+      "   \n\n  "};
+
+  // Checks the stream matches whole-buffer lexing with a given window size
+  void expect_matches_buffer(const std::string& source, size_t window_size) {
+    Tokenizer tokenizer(std::string_view{source});
+    TokenBuffer expected = tokenizer.tokenize_all();
+
+    std::istringstream input(source);
+    StreamTokenizer stream(input, window_size);
+
+    for (size_t i = 0; i < expected.size(); i++) {
+      SCOPED_TRACE("Token: " + std::to_string(i));
+
+      std::string_view spelling =
+          std::string_view(source).substr(expected.offsets[i],
+                                          expected.lengths[i]);
+      SourceLocation location =
+          tokenizer.source_manager().location(expected.offsets[i]);
+
+      StreamToken token = stream.next();
+      ASSERT_EQ(token.type, expected.types[i]);
+      ASSERT_EQ(token.offset, expected.offsets[i]);
+      ASSERT_EQ(token.length, expected.lengths[i]);
+      std::string storage;
+      ASSERT_EQ(token.value, expected.types[i] == TokenType::STRING_LITERAL
+                                 ? string_value(spelling, storage)
+                                 : token_value(expected.types[i], spelling));
+      ASSERT_EQ(token.line, location.line);
+      ASSERT_EQ(token.column, location.column);
+    }
+
+    // END repeats once the input is exhausted
+    EXPECT_EQ(stream.next().type, TokenType::END);
+  }
+}  // namespace
+
+TEST(StreamTokenizerTest, MatchesBufferForEveryWindowSize) {
+  for (std::string_view view : SOURCES) {
+    std::string source(view);
+
+    for (size_t size = 1; size <= source.size() + 1; size++) {
+      SCOPED_TRACE("Source: " + source + ", window: " + std::to_string(size));
+      expect_matches_buffer(source, size);
+    }
+  }
+}
+
+TEST(StreamTokenizerTest, EmbeddedNul) {
+  std::string source("a\0b", 3);
+
+  for (size_t size = 1; size <= source.size() + 1; size++) {
+    SCOPED_TRACE("Window: " + std::to_string(size));
+    expect_matches_buffer(source, size);
+  }
+}
+
+TEST(StreamTokenizerTest, BoundedWindow) {
+  // Long comments and whitespace are discarded as they are skipped
+  std::string source;
+  for (int i = 0; i < 1000; i++) {
+    source += "/* a block comment */ // a line comment\n   x = 1;\n";
+  }
+  source += "/*" + std::string(100000, '*') + "*/ y";
+
+  std::istringstream input(source);
+  StreamTokenizer stream(input, 64);
+
+  size_t tokens = 0;
+  while (stream.next().type != TokenType::END) {
+    tokens++;
+  }
+
+  EXPECT_EQ(tokens, 4001u);
+  EXPECT_EQ(stream.window_size(), 64u);
+}
+
+TEST(StreamTokenizerTest, WindowGrowsForLongTokens) {
+  std::string name(1000, 'n');
+  std::istringstream input(name + " x");
+  StreamTokenizer stream(input, 16);
+
+  StreamToken token = stream.next();
+  EXPECT_EQ(token.type, TokenType::IDENTIFIER);
+  EXPECT_EQ(token.value, name);
+  EXPECT_GE(stream.window_size(), 1000u);
+
+  token = stream.next();
+  EXPECT_EQ(token.value, "x");
+  EXPECT_EQ(token.offset, 1001u);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "excerpt/string_literal.hpp"
+
+#include <string>
+
+using namespace excerpt;
+
+TEST(StringLiteralTest, ReadsEscapes) {
+  const struct {
+    std::string text;
+    size_t length;
+    uint32_t code_point;
+  } testCases[] = {{"\\n", 2, '\n'},           {"\\t", 2, '\t'},
+                   {"\\r", 2, '\r'},           {"\\0", 2, 0},
+                   {"\\\\", 2, '\\'},          {"\\\"x", 2, '"'},
+                   {"\\x41", 4, 0x41},         {"\\xfF!", 4, 0xFF},
+                   {"\\u{e9}", 6, 0xE9},       {"\\u{1F600}x", 9, 0x1F600},
+                   {"\\u{10FFFF}", 10, 0x10FFFF}};
+
+  for (const auto& testCase : testCases) {
+    SCOPED_TRACE("Escape: " + testCase.text);
+    Escape escape = read_escape(testCase.text);
+
+    EXPECT_EQ(escape.error, StringError::NONE);
+    EXPECT_EQ(escape.length, testCase.length);
+    EXPECT_EQ(escape.code_point, testCase.code_point);
+  }
+}
+
+TEST(StringLiteralTest, InvalidEscapes) {
+  const struct {
+    std::string text;
+    size_t length;
+    StringError error;
+  } testCases[] = {{"\\q", 2, StringError::UNKNOWN_ESCAPE},
+                   {"\\", 1, StringError::UNKNOWN_ESCAPE},
+                   {std::string("\\\0", 2), 1, StringError::UNKNOWN_ESCAPE},
+                   {"\\x4", 2, StringError::HEX_ESCAPE},
+                   {"\\xg0", 2, StringError::HEX_ESCAPE},
+                   {"\\u41", 2, StringError::UNICODE_ESCAPE},
+                   {"\\u{}", 2, StringError::UNICODE_ESCAPE},
+                   {"\\u{41", 2, StringError::UNICODE_ESCAPE},
+                   {"\\u{1234567}", 2, StringError::UNICODE_ESCAPE},
+                   {"\\u{110000}", 2, StringError::UNICODE_ESCAPE},
+                   {"\\u{D800}", 2, StringError::UNICODE_ESCAPE}};
+
+  for (const auto& testCase : testCases) {
+    SCOPED_TRACE("Escape: " + testCase.text);
+    Escape escape = read_escape(testCase.text);
+
+    EXPECT_EQ(escape.error, testCase.error);
+    EXPECT_EQ(escape.length, testCase.length);
+  }
+}
+
+TEST(StringLiteralTest, ChecksLiterals) {
+  EXPECT_EQ(check_string("\"\""), StringError::NONE);
+  EXPECT_EQ(check_string("\"a\\\"b\""), StringError::NONE);
+  EXPECT_EQ(check_string("\"a\\\\\""), StringError::NONE);
+  EXPECT_EQ(check_string("\""), StringError::UNTERMINATED);
+  EXPECT_EQ(check_string("\"a\\\""), StringError::UNTERMINATED);
+  EXPECT_EQ(check_string("\"a\\q\""), StringError::UNKNOWN_ESCAPE);
+  EXPECT_EQ(check_string("\"\\x4\""), StringError::HEX_ESCAPE);
+  EXPECT_EQ(check_string("\"\\u{D800}\""), StringError::UNICODE_ESCAPE);
+}
+
+TEST(StringLiteralTest, DecodesValues) {
+  const struct {
+    std::string spelling;
+    std::string value;
+  } testCases[] = {
+      {"\"\"", ""},
+      {"\"plain\"", "plain"},
+      {"\"a\\nb\"", "a\nb"},
+      {"\"\\\"quoted\\\"\"", "\"quoted\""},
+      {"\"back\\\\slash\"", "back\\slash"},
+      {"\"\\x41\\x42\\xff\"", "AB\xff"},
+      {"\"\\u{41}\\u{e9}\\u{20ac}\\u{1F600}\"",
+       "A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80"},
+      {"\"nul\\0\"", std::string("nul\0", 4)}};
+
+  for (const auto& testCase : testCases) {
+    SCOPED_TRACE("Literal: " + testCase.spelling);
+    std::string storage;
+
+    EXPECT_EQ(string_value(testCase.spelling, storage), testCase.value);
+  }
+}
+
+TEST(StringLiteralTest, PlainValuesAreViews) {
+  std::string spelling = "\"no escapes\"";
+  std::string storage;
+  std::string_view value = string_value(spelling, storage);
+
+  EXPECT_EQ(value.data(), spelling.data() + 1);
+  EXPECT_TRUE(storage.empty());
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "excerpt/source_buffer.hpp"
+#include "excerpt/source_manager.hpp"
+#include "excerpt/token_file.hpp"
+#include "excerpt/tokenizer.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+using namespace excerpt;
+
+namespace {
+  const char* SOURCE =
+      "int main() {\n"
+      "  // a comment\n"
+      "  char* s = \"two\\nlines\";\n"
+      "  float f = 1.5;\n"
+      "  return x $ 42;\n"
+      "}\n";
+
+  // Views serialized bytes as a token file
+  std::unique_ptr<TokenFile> view(std::string bytes) {
+    return TokenFile::from_buffer(SourceBuffer::from_string(
+        std::make_shared<const std::string>(std::move(bytes)), "test.tok"));
+  }
+
+  // Writes the tokens of `source` as a token file, as the driver does
+  std::string serialize(std::string_view source) {
+    return write_token_file(Tokenizer(source).tokenize_all(), source);
+  }
+}  // namespace
+
+TEST(TokenFileTest, RoundTrips) {
+  TokenBuffer tokens = Tokenizer(SOURCE).tokenize_all();
+  auto file = view(write_token_file(tokens, SOURCE));
+  ASSERT_NE(file, nullptr);
+
+  ASSERT_EQ(file->size(), tokens.size());
+  EXPECT_EQ(file->text(), SOURCE);
+
+  TokenBuffer read = file->tokens();
+  EXPECT_EQ(read.types, tokens.types);
+  EXPECT_EQ(read.offsets, tokens.offsets);
+  EXPECT_EQ(read.lengths, tokens.lengths);
+
+  SourceManager manager(SOURCE);
+  std::string_view source(SOURCE);
+
+  for (size_t i = 0; i < tokens.size(); i++) {
+    TokenFile::TokenView token = (*file)[i];
+    EXPECT_EQ(token.line, manager.location(tokens.offsets[i]).line);
+    EXPECT_EQ(token.text, source.substr(tokens.offsets[i], tokens.lengths[i]));
+  }
+
+  EXPECT_EQ((*file)[file->size() - 1].type, TokenType::END);
+}
+
+TEST(TokenFileTest, Iterates) {
+  auto file = view(serialize("a = 1;\nb"));
+  ASSERT_NE(file, nullptr);
+
+  std::vector<std::string_view> spellings;
+  std::vector<uint32_t> lines;
+  for (TokenFile::TokenView token : *file) {
+    spellings.push_back(token.text);
+    lines.push_back(token.line);
+  }
+
+  EXPECT_EQ(spellings,
+            (std::vector<std::string_view>{"a", "=", "1", ";", "b", ""}));
+  EXPECT_EQ(lines, (std::vector<uint32_t>{1, 1, 1, 1, 2, 2}));
+  EXPECT_EQ(file->end() - file->begin(), 6);
+}
+
+TEST(TokenFileTest, EmptySource) {
+  auto file = view(serialize(""));
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(file->size(), 1u);
+  EXPECT_EQ((*file)[0].type, TokenType::END);
+}
+
+TEST(TokenFileTest, MapsFile) {
+  std::string path = testing::TempDir() + "token_file_test.tok";
+  std::ofstream(path, std::ios::binary) << serialize(SOURCE);
+
+  auto file = TokenFile::open(path);
+  ASSERT_NE(file, nullptr);
+  EXPECT_EQ(file->tokens().types, Tokenizer(SOURCE).tokenize_all().types);
+
+  std::remove(path.c_str());
+}
+
+TEST(TokenFileTest, RejectsInvalidFiles) {
+  std::string bytes = serialize(SOURCE);
+  testing::internal::CaptureStdout();
+
+  EXPECT_EQ(view("int x;"), nullptr);
+  EXPECT_EQ(view(bytes.substr(0, bytes.size() - 1)), nullptr);
+  EXPECT_EQ(view(bytes.substr(0, 40)), nullptr);
+
+  std::string version = bytes;
+  version[4] = 2;
+  EXPECT_EQ(view(version), nullptr);
+
+  // A record whose spelling runs past the string table
+  std::string record = bytes;
+  uint32_t length = 1000;
+  std::memcpy(&record[sizeof(TokenFileHeader) + 8], &length, sizeof(length));
+  EXPECT_EQ(view(record), nullptr);
+
+  // A record of a type past the last one
+  std::string type = bytes;
+  type[sizeof(TokenFileHeader)] = static_cast<char>(TokenType::INVALID) + 1;
+  EXPECT_EQ(view(type), nullptr);
+
+  std::string output = testing::internal::GetCapturedStdout();
+  EXPECT_NE(output.find("not a token file"), std::string::npos);
+  EXPECT_NE(output.find("truncated"), std::string::npos);
+  EXPECT_NE(output.find("version 2"), std::string::npos);
+  EXPECT_NE(output.find("outside the string table"), std::string::npos);
+  EXPECT_NE(output.find("token 0 has unknown type"), std::string::npos);
+}
@@ -58,3 +58,45 @@ TEST(TokenTest, ConstructionAndStringRepresentation) {
                                testCase.second + ", Line: 1, Column: 1)");
   }
 }
+
+TEST(TokenTest, DecodedValue) {
+  Token token = Token::decoded(TokenType::STRING_LITERAL, "a\nb", 1, 1);
+  EXPECT_EQ(token.value, "a\nb");
+  ASSERT_NE(token.owned, nullptr);
+  EXPECT_EQ(token.value.data(), token.owned->data());
+
+  // Copies share the decoded storage, so their views stay valid
+  Token copy = token;
+  token = Token(TokenType::END, "", 1, 1);
+  EXPECT_EQ(copy.value, "a\nb");
+}
+
+TEST(TokenTest, KeywordType) {
+  static_assert(keyword_type("while") == TokenType::WHILE);
+  static_assert(keyword_type("whale") == TokenType::IDENTIFIER);
+
+  const std::pair<std::string, TokenType> testCases[] = {
+      {"if", TokenType::IF},
+      {"else", TokenType::ELSE},
+      {"while", TokenType::WHILE},
+      {"for", TokenType::FOR},
+      {"break", TokenType::BREAK},
+      {"continue", TokenType::CONTINUE},
+      {"return", TokenType::RETURN},
+      {"true", TokenType::TRUE},
+      {"false", TokenType::FALSE},
+      {"int", TokenType::INT},
+      {"float", TokenType::FLOAT},
+      {"char", TokenType::CHAR},
+      {"bool", TokenType::BOOL},
+      {"iff", TokenType::IDENTIFIER},
+      {"Int", TokenType::IDENTIFIER},
+      {"PLUS", TokenType::IDENTIFIER},
+      {"IDENTIFIER", TokenType::IDENTIFIER},
+      {"", TokenType::IDENTIFIER}};
+
+  for (const auto& testCase : testCases) {
+    SCOPED_TRACE("Identifier: " + testCase.first);
+    EXPECT_EQ(keyword_type(testCase.first), testCase.second);
+  }
+}
@@ -15,6 +15,48 @@ TEST(TokenizerTest, ParseNumber) {
   EXPECT_EQ(token->value, "3.14");
 }
 
+TEST(TokenizerTest, DecodesNumbers) {
+  auto source = std::make_shared<std::string>(
+      "0x1F 0b101 017 1_000 2.5e-3 1E+2 1. 1e+ 7");
+  Tokenizer tokenizer(source);
+  TokenBuffer buffer = tokenizer.tokenize_all();
+
+  const TokenType types[] = {
+      TokenType::INTEGER_LITERAL, TokenType::INTEGER_LITERAL,
+      TokenType::INTEGER_LITERAL, TokenType::INTEGER_LITERAL,
+      TokenType::FLOAT_LITERAL,   TokenType::FLOAT_LITERAL,
+      TokenType::INTEGER_LITERAL, TokenType::DOT,
+      TokenType::INVALID,         TokenType::PLUS,
+      TokenType::INTEGER_LITERAL, TokenType::END};
+  const char* spellings[] = {"0x1F", "0b101", "017", "1_000", "2.5e-3",
+                             "1E+2", "1", ".", "1e", "+", "7", ""};
+
+  ASSERT_EQ(buffer.size(), 12u);
+  for (size_t i = 0; i < buffer.size(); i++) {
+    EXPECT_EQ(buffer.types[i], types[i]);
+    EXPECT_EQ(source->substr(buffer.offsets[i], buffer.lengths[i]),
+              spellings[i]);
+  }
+
+  EXPECT_EQ(buffer.values[0].integer, 31);
+  EXPECT_EQ(buffer.values[1].integer, 5);
+  EXPECT_EQ(buffer.values[2].integer, 15);
+  EXPECT_EQ(buffer.values[3].integer, 1000);
+  EXPECT_DOUBLE_EQ(buffer.values[4].real, 2.5e-3);
+  EXPECT_DOUBLE_EQ(buffer.values[5].real, 100.0);
+  EXPECT_EQ(buffer.values[10].integer, 7);
+}
+
+TEST(TokenizerTest, MalformedNumbersAreWhole) {
+  Tokenizer tokenizer(std::make_shared<std::string>("1abc 09 0x"));
+
+  for (const char* spelling : {"1abc", "09", "0x"}) {
+    auto token = tokenizer.next();
+    EXPECT_EQ(token->type, TokenType::INVALID);
+    EXPECT_EQ(token->value, spelling);
+  }
+}
+
 TEST(TokenizerTest, ParseString) {
   Tokenizer tokenizer(std::make_shared<std::string>("\"Hello, World!\""));
   auto token = tokenizer.next();
@@ -23,6 +65,40 @@ TEST(TokenizerTest, ParseString) {
   EXPECT_EQ(token->value, "Hello, World!");
 }
 
+TEST(TokenizerTest, ParseEscapedString) {
+  auto source = std::make_shared<std::string>(
+      "\"say \\\"hi\\\"\" \"\\x41\\u{e9}\\t\" \"plain\"");
+  Tokenizer tokenizer(source);
+
+  auto token = tokenizer.next();
+  EXPECT_EQ(token->type, TokenType::STRING_LITERAL);
+  EXPECT_EQ(token->value, "say \"hi\"");
+  EXPECT_NE(token->owned, nullptr);
+
+  token = tokenizer.next();
+  EXPECT_EQ(token->type, TokenType::STRING_LITERAL);
+  EXPECT_EQ(token->value, "A\xC3\xA9\t");
+
+  // Literals without escapes still view the source
+  token = tokenizer.next();
+  EXPECT_EQ(token->value, "plain");
+  EXPECT_EQ(token->owned, nullptr);
+}
+
+TEST(TokenizerTest, InvalidStrings) {
+  Tokenizer tokenizer(
+      std::make_shared<std::string>("\"a\\q\" x \"b\\x4\" \"open\\\""));
+
+  // An invalid escape spans the literal, so lexing resumes past it
+  for (const char* spelling : {"\"a\\q\"", "x", "\"b\\x4\"", "\"open\\\""}) {
+    auto token = tokenizer.next();
+    EXPECT_EQ(token->type, std::string_view(spelling) == "x"
+                               ? TokenType::IDENTIFIER
+                               : TokenType::INVALID);
+    EXPECT_EQ(token->value, spelling);
+  }
+}
+
 TEST(TokenizerTest, ParseIdentifier) {
   Tokenizer tokenizer(std::make_shared<std::string>(
       "variable_name _foo if else while for break continue return true false"));
@@ -72,6 +148,32 @@ TEST(TokenizerTest, ParseIdentifier) {
   EXPECT_EQ(token->value, "false");
 }
 
+TEST(TokenizerTest, ParseTypeKeywords) {
+  Tokenizer tokenizer(
+      std::make_shared<std::string>("int float char bool PLUS IDENTIFIER"));
+
+  auto token = tokenizer.next();
+  EXPECT_EQ(token->type, TokenType::INT);
+
+  token = tokenizer.next();
+  EXPECT_EQ(token->type, TokenType::FLOAT);
+
+  token = tokenizer.next();
+  EXPECT_EQ(token->type, TokenType::CHAR);
+
+  token = tokenizer.next();
+  EXPECT_EQ(token->type, TokenType::BOOL);
+
+  // Token type names are not keywords
+  token = tokenizer.next();
+  EXPECT_EQ(token->type, TokenType::IDENTIFIER);
+  EXPECT_EQ(token->value, "PLUS");
+
+  token = tokenizer.next();
+  EXPECT_EQ(token->type, TokenType::IDENTIFIER);
+  EXPECT_EQ(token->value, "IDENTIFIER");
+}
+
 TEST(TokenizerTest, ParseSymbolSingle) {
   Tokenizer tokenizer(std::make_shared<std::string>("+-*/%(){}[];:,."));
   auto token = tokenizer.next();
@@ -228,3 +330,100 @@ TEST(TokenizerTest, CommentsWithCode) {
   EXPECT_EQ(token->type, TokenType::END);
   EXPECT_EQ(token->value, "");
 }
+
+TEST(TokenizerTest, ValuesViewSource) {
+  auto source = std::make_shared<std::string>("foo 42 \"bar\" <=");
+  Tokenizer tokenizer(source);
+
+  for (auto token = tokenizer.next(); token->type != TokenType::END;
+       token = tokenizer.next()) {
+    EXPECT_GE(token->value.data(), source->data());
+    EXPECT_LE(token->value.data() + token->value.size(),
+              source->data() + source->size());
+    EXPECT_EQ(token->owned, nullptr);
+  }
+}
+
+TEST(TokenizerTest, TokenizeAll) {
+  auto source = std::make_shared<std::string>("int x = 42;\n\"hi\"");
+  Tokenizer tokenizer(source);
+  TokenBuffer buffer = tokenizer.tokenize_all();
+
+  const TokenType types[] = {TokenType::INT,    TokenType::IDENTIFIER,
+                             TokenType::ASSIGN, TokenType::INTEGER_LITERAL,
+                             TokenType::SEMICOLON, TokenType::STRING_LITERAL,
+                             TokenType::END};
+  const char* spellings[] = {"int", "x", "=", "42", ";", "\"hi\"", ""};
+
+  ASSERT_EQ(buffer.size(), 7u);
+  for (size_t i = 0; i < buffer.size(); i++) {
+    EXPECT_EQ(buffer.types[i], types[i]);
+    EXPECT_EQ(source->substr(buffer.offsets[i], buffer.lengths[i]),
+              spellings[i]);
+  }
+
+  SourceLocation location =
+      tokenizer.source_manager().location(buffer.offsets[5]);
+  EXPECT_EQ(location.line, 2u);
+  EXPECT_EQ(location.column, 1u);
+
+  location = tokenizer.source_manager().location(buffer.offsets[3]);
+  EXPECT_EQ(location.line, 1u);
+  EXPECT_EQ(location.column, 9u);
+}
+
+TEST(TokenizerTest, InvalidCharacter) {
+  Tokenizer tokenizer(std::make_shared<std::string>("@ x"));
+
+  auto token = tokenizer.next();
+  EXPECT_EQ(token->type, TokenType::INVALID);
+  EXPECT_EQ(token->value, "@");
+
+  token = tokenizer.next();
+  EXPECT_EQ(token->type, TokenType::IDENTIFIER);
+  EXPECT_EQ(token->value, "x");
+
+  token = tokenizer.next();
+  EXPECT_EQ(token->type, TokenType::END);
+
+  // The END token repeats once the source is exhausted
+  token = tokenizer.next();
+  EXPECT_EQ(token->type, TokenType::END);
+}
+
+TEST(TokenizerTest, PositionsAfterComments) {
+  Tokenizer tokenizer(std::make_shared<std::string>(
+      "/* a\nblock */ x // line\n    y\t/* */z"));
+
+  auto token = tokenizer.next();
+  EXPECT_EQ(token->value, "x");
+  EXPECT_EQ(token->line, 2);
+  EXPECT_EQ(token->column, 10);
+
+  token = tokenizer.next();
+  EXPECT_EQ(token->value, "y");
+  EXPECT_EQ(token->line, 3);
+  EXPECT_EQ(token->column, 5);
+
+  token = tokenizer.next();
+  EXPECT_EQ(token->value, "z");
+  EXPECT_EQ(token->line, 3);
+  EXPECT_EQ(token->column, 12);
+}
+
+TEST(TokenizerTest, InternsIdentifiers) {
+  Interner interner;
+  Tokenizer tokenizer(std::string_view{"int x = y + x; if"});
+  tokenizer.set_interner(&interner);
+
+  TokenBuffer tokens = tokenizer.tokenize_all();
+
+  ASSERT_EQ(tokens.symbols.size(), tokens.size());
+  EXPECT_EQ(tokens.symbols[0], NO_SYMBOL);  // int
+  EXPECT_EQ(tokens.symbols[1], 0u);         // x
+  EXPECT_EQ(tokens.symbols[3], 1u);         // y
+  EXPECT_EQ(tokens.symbols[5], 0u);         // x
+  EXPECT_EQ(tokens.symbols[7], NO_SYMBOL);  // if
+  EXPECT_EQ(interner.size(), 2u);
+  EXPECT_EQ(interner.name(1), "y");
+}
@@ -3,6 +3,25 @@
 
 #include "excerpt_utils/logger.hpp"
 
+#include <thread>
+#include <vector>
+
+namespace {
+  // Counts how often it is formatted
+  struct Counted {
+    int* count;
+  };
+}  // namespace
+
+template <>
+struct llvm::format_provider<Counted> {
+  static void format(const Counted& value, llvm::raw_ostream& stream,
+                     llvm::StringRef) {
+    ++*value.count;
+    stream << "counted";
+  }
+};
+
 std::string captureStdout(const std::function<void()>& testFunction) {
   std::ostringstream oss;
   std::streambuf* oldCout = std::cout.rdbuf(oss.rdbuf());
@@ -15,6 +34,12 @@ TEST(LoggerTest, DebugMessage) {
   std::string output =
       captureStdout([]() { excerpt::logger::debug("Debug message"); });
 
+  // Release builds compile debug messages out
+  if (excerpt::logger::COMPILED_LEVEL > excerpt::logger::DEBUG) {
+    EXPECT_EQ(output, "");
+    return;
+  }
+
   std::string expectedLogLevel = "DEBUG";
   std::string expectedMessage = "Debug message";
 
@@ -54,3 +79,97 @@ TEST(LoggerTest, ErrorMessage) {
   EXPECT_THAT(output, testing::HasSubstr(expectedLogLevel));
   EXPECT_THAT(output, testing::HasSubstr(expectedMessage));
 }
+
+TEST(LoggerTest, AsyncMessages) {
+  std::string output = captureStdout([]() {
+    excerpt::logger::start_async();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+      threads.emplace_back([i]() {
+        for (int j = 0; j < 100; j++) {
+          excerpt::logger::info("Message " + std::to_string(i * 100 + j));
+        }
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    excerpt::logger::flush();
+    excerpt::logger::stop_async();
+  });
+
+  for (int i = 0; i < 400; i++) {
+    EXPECT_THAT(output, testing::HasSubstr("Message " + std::to_string(i) +
+                                           "\n"));
+  }
+  EXPECT_EQ(excerpt::logger::dropped(), 0u);
+}
+
+TEST(LoggerTest, StopAsyncWritesPending) {
+  std::string output = captureStdout([]() {
+    excerpt::logger::start_async(4, excerpt::logger::Overflow::BLOCK);
+
+    for (int i = 0; i < 100; i++) {
+      excerpt::logger::warn("Pending " + std::to_string(i));
+    }
+
+    excerpt::logger::stop_async();
+  });
+
+  EXPECT_THAT(output, testing::HasSubstr("Pending 0\n"));
+  EXPECT_THAT(output, testing::HasSubstr("Pending 99\n"));
+}
+
+TEST(LoggerTest, RingOverflow) {
+  excerpt::logger::detail::Ring ring(2);
+  std::string first = "a", second = "b", third = "c";
+
+  EXPECT_TRUE(ring.push(first));
+  EXPECT_TRUE(ring.push(second));
+  EXPECT_FALSE(ring.push(third));
+
+  std::string drained;
+  EXPECT_EQ(ring.drain([&](std::string_view record) { drained += record; }),
+            2u);
+  EXPECT_EQ(drained, "ab");
+  EXPECT_TRUE(ring.push(third));
+}
+
+TEST(LoggerTest, FormatsArguments) {
+  std::string output = captureStdout(
+      []() { excerpt::logger::warn("{0} tokens in {1}", 42, "a.ex"); });
+
+  EXPECT_THAT(output, testing::HasSubstr("WARNING"));
+  EXPECT_THAT(output, testing::HasSubstr("42 tokens in a.ex\n"));
+}
+
+TEST(LoggerTest, PlainMessagesKeepBraces) {
+  // A message without arguments is not a format
+  std::string output = captureStdout(
+      []() { excerpt::logger::error("expected '{' or '}', found {0}"); });
+
+  EXPECT_THAT(output, testing::HasSubstr("expected '{' or '}', found {0}\n"));
+}
+
+TEST(LoggerTest, RuntimeThreshold) {
+  int count = 0;
+
+  std::string output = captureStdout([&]() {
+    excerpt::logger::set_level(excerpt::logger::ERROR);
+    excerpt::logger::warn("Hidden {0}", Counted{&count});
+    excerpt::logger::info("Hidden");
+    excerpt::logger::error("Shown {0}", Counted{&count});
+    excerpt::logger::set_level(excerpt::logger::COMPILED_LEVEL);
+  });
+
+  EXPECT_THAT(output, testing::Not(testing::HasSubstr("Hidden")));
+  EXPECT_THAT(output, testing::HasSubstr("Shown counted"));
+  EXPECT_EQ(count, 1);
+
+  EXPECT_TRUE(excerpt::logger::enabled(excerpt::logger::ERROR));
+  EXPECT_EQ(excerpt::logger::enabled(excerpt::logger::DEBUG),
+            excerpt::logger::COMPILED_LEVEL == excerpt::logger::DEBUG);
+}
@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+
+#include "excerpt_utils/parallel.hpp"
+
+#include <atomic>
+#include <vector>
+
+TEST(ParallelTest, ThreadCount) {
+  EXPECT_EQ(excerpt::parallel::thread_count(3), 3u);
+  EXPECT_GE(excerpt::parallel::thread_count(0), 1u);
+}
+
+TEST(ParallelTest, ForEachIndex) {
+  std::vector<std::atomic<int>> calls(8);
+
+  excerpt::parallel::for_each_index(calls.size(),
+                                    [&](size_t i) { calls[i]++; });
+
+  for (const auto& count : calls) {
+    EXPECT_EQ(count, 1);
+  }
+}
+
+TEST(ParallelTest, WorkersRunInCallersPhase) {
+  std::vector<excerpt::timing::Phase> phases(4, excerpt::timing::PHASE_COUNT);
+
+  {
+    excerpt::timing::ScopedTimer timer(excerpt::timing::PARSE);
+    excerpt::parallel::for_each_index(phases.size(), [&](size_t i) {
+      phases[i] = excerpt::timing::current_phase();
+    });
+  }
+
+  for (auto phase : phases) {
+    EXPECT_EQ(phase, excerpt::timing::PARSE);
+  }
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include "excerpt_utils/thread_pool.hpp"
+
+#include <atomic>
+#include <vector>
+
+TEST(ThreadPoolTest, RunsEveryTask) {
+  std::vector<std::atomic<int>> calls(1000);
+
+  {
+    excerpt::parallel::ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4u);
+
+    for (size_t i = 0; i < calls.size(); i++) {
+      pool.submit([&, i] { calls[i]++; });
+    }
+
+    pool.wait();
+  }
+
+  for (const auto& count : calls) {
+    EXPECT_EQ(count, 1);
+  }
+}
+
+TEST(ThreadPoolTest, TasksSubmitTasks) {
+  std::atomic<int> leaves(0);
+  excerpt::parallel::ThreadPool pool(3);
+
+  // A binary tree of tasks, 2^10 leaves deep
+  std::function<void(int)> split = [&](int depth) {
+    if (depth == 0) {
+      leaves++;
+      return;
+    }
+
+    pool.submit([&, depth] { split(depth - 1); });
+    pool.submit([&, depth] { split(depth - 1); });
+  };
+
+  pool.submit([&] { split(10); });
+  pool.wait();
+
+  EXPECT_EQ(leaves, 1 << 10);
+}
+
+TEST(ThreadPoolTest, WaitIsReusable) {
+  std::atomic<int> calls(0);
+  excerpt::parallel::ThreadPool pool(2);
+
+  for (int round = 1; round <= 3; round++) {
+    for (int i = 0; i < 10; i++) {
+      pool.submit([&] { calls++; });
+    }
+
+    pool.wait();
+    EXPECT_EQ(calls, round * 10);
+  }
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include "excerpt_utils/timing.hpp"
+
+#include "llvm/Support/JSON.h"
+
+#include <thread>
+#include <vector>
+
+using namespace excerpt;
+
+TEST(TimingTest, DisabledRecordsNothing) {
+  timing::start();
+  timing::stop();
+
+  {
+    timing::ScopedTimer timer(timing::LEX);
+    timer.count(100, 10);
+  }
+
+  EXPECT_EQ(timing::stats()[timing::LEX].runs, 0u);
+}
+
+TEST(TimingTest, SumsRuns) {
+  timing::start();
+
+  for (int i = 0; i < 3; i++) {
+    timing::ScopedTimer timer(timing::PARSE);
+    timer.count(10, 2);
+    timer.count(5);
+  }
+
+  timing::stop();
+  timing::PhaseStats parse = timing::stats()[timing::PARSE];
+
+  EXPECT_EQ(parse.runs, 3u);
+  EXPECT_EQ(parse.bytes, 45u);
+  EXPECT_EQ(parse.items, 6u);
+  EXPECT_EQ(timing::stats()[timing::LEX].runs, 0u);
+}
+
+TEST(TimingTest, MeasuresWallAndCpuTime) {
+  timing::start();
+
+  {
+    timing::ScopedTimer timer(timing::OPTIMIZE);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+
+  timing::stop();
+  timing::PhaseStats optimize = timing::stats()[timing::OPTIMIZE];
+
+  // Sleeping takes time, but not CPU time
+  EXPECT_GE(optimize.wall_ns, 20000000u);
+  EXPECT_LT(optimize.cpu_ns, optimize.wall_ns / 2);
+}
+
+TEST(TimingTest, StartDiscardsEarlierRuns) {
+  timing::start();
+  { timing::ScopedTimer timer(timing::EMIT); }
+  timing::start();
+  timing::stop();
+
+  EXPECT_EQ(timing::stats()[timing::EMIT].runs, 0u);
+}
+
+TEST(TimingTest, Table) {
+  timing::start();
+  {
+    timing::ScopedTimer timer(timing::LEX);
+    timer.count(1000, 100);
+  }
+  timing::stop();
+
+  std::string table = timing::table();
+
+  EXPECT_NE(table.find("lex"), std::string::npos);
+  EXPECT_NE(table.find("1000"), std::string::npos);
+  EXPECT_NE(table.find("total"), std::string::npos);
+
+  // Phases that did not run are left out
+  EXPECT_EQ(table.find("optimize"), std::string::npos);
+}
+
+TEST(TimingTest, Json) {
+  timing::start();
+  {
+    timing::ScopedTimer timer(timing::READ);
+    timer.count(42, 1);
+  }
+  timing::stop();
+
+  llvm::Expected<llvm::json::Value> value = llvm::json::parse(timing::json());
+  ASSERT_TRUE(static_cast<bool>(value));
+
+  const llvm::json::Array* phases = value->getAsObject()->getArray("phases");
+  ASSERT_TRUE(phases);
+  ASSERT_EQ(phases->size(), static_cast<size_t>(timing::PHASE_COUNT));
+
+  const llvm::json::Object* read = (*phases)[timing::READ].getAsObject();
+  EXPECT_EQ(read->getString("name"), llvm::StringRef("read"));
+  EXPECT_EQ(read->getInteger("bytes").getValueOr(-1), 42);
+  EXPECT_EQ(read->getInteger("items").getValueOr(-1), 1);
+  EXPECT_EQ(read->getInteger("runs").getValueOr(-1), 1);
+}
+
+TEST(TimingTest, ChromeTrace) {
+  timing::start(true);
+
+  // Threads are numbered in the order they first finish a phase
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([] {
+      timing::ScopedTimer timer(timing::IRGEN, "file.ex");
+      timer.count(0, 7);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  timing::stop();
+
+  llvm::Expected<llvm::json::Value> value =
+      llvm::json::parse(timing::chrome_trace());
+  ASSERT_TRUE(static_cast<bool>(value));
+
+  const llvm::json::Array* events =
+      value->getAsObject()->getArray("traceEvents");
+  ASSERT_TRUE(events);
+  ASSERT_EQ(events->size(), 4u);
+
+  std::vector<bool> seen(4, false);
+  for (const llvm::json::Value& event : *events) {
+    const llvm::json::Object* object = event.getAsObject();
+    EXPECT_EQ(object->getString("name"), llvm::StringRef("irgen"));
+    EXPECT_EQ(object->getString("ph"), llvm::StringRef("X"));
+    const llvm::json::Object* args = object->getObject("args");
+    EXPECT_EQ(args->getString("detail"), llvm::StringRef("file.ex"));
+    EXPECT_EQ(args->getInteger("items").getValueOr(-1), 7);
+
+    int64_t tid = object->getInteger("tid").getValueOr(-1);
+    ASSERT_TRUE(tid >= 0 && tid < 4);
+    seen[tid] = true;
+  }
+
+  EXPECT_EQ(seen, std::vector<bool>(4, true));
+}
+
+TEST(TimingTest, TraceOnlyWhenAsked) {
+  timing::start();
+  { timing::ScopedTimer timer(timing::LEX); }
+  timing::stop();
+
+  EXPECT_EQ(timing::stats()[timing::LEX].runs, 1u);
+  EXPECT_NE(timing::chrome_trace().find("\"traceEvents\":[]"),
+            std::string::npos);
+}